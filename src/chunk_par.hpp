@@ -0,0 +1,177 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <execution>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "parallel.hpp"
+
+// Pipelines de views em paralelo: a range de origem (de acesso aleatório e com
+// tamanho) é dividida em blocos contíguos, a mesma pipeline (um adaptador como
+// 'std::views::filter(p) | std::views::transform(f)', ou qualquer função que
+// receba e devolva uma range) roda sobre cada bloco, e as saídas dos blocos são
+// concatenadas na ordem da origem. Os blocos são distribuídos pela política de
+// execução, como nos demais algoritmos de 'parallel'; com uma política
+// sequencial há um único bloco e nenhum buffer intermediário.
+//
+//     auto pipe = std::views::filter(p) | std::views::transform(f);
+//     std::vector out = v | chunk_par::pipeline(std::execution::par, pipe);
+//     chunk_par::copy(std::execution::par, words, std::views::join, it);
+//
+// O resultado só é o da pipeline sobre a range inteira quando ela trata cada
+// elemento independentemente dos demais ('transform', 'filter', 'join',
+// 'split' de cada elemento...). Views que dependem da posição ou de elementos
+// anteriores ('take', 'drop', 'take_while', 'enumerate', 'adjacent', 'chunk')
+// seriam aplicadas a cada bloco separadamente. As funções da pipeline são
+// chamadas de várias threads ao mesmo tempo (cada bloco tem a sua cópia do
+// adaptador, mas não dos objetos capturados por referência).
+namespace chunk_par {
+
+namespace detail {
+
+template <typename R>
+using chunk_t = std::ranges::subrange<std::ranges::iterator_t<R>>;
+
+template <typename Pipe, typename R>
+using result_t = std::invoke_result_t<const Pipe&, chunk_t<R>>;
+
+template <typename Pipe, typename R>
+concept pipeline_for =
+    std::ranges::random_access_range<R> && std::ranges::sized_range<R> &&
+    std::invocable<const Pipe&, chunk_t<R>> &&
+    std::ranges::input_range<result_t<Pipe, R>>;
+
+template <typename Pipe, typename R>
+using value_t = std::ranges::range_value_t<result_t<Pipe, R>>;
+
+// elementos mínimos de origem por bloco.
+inline constexpr std::size_t grain = 1 << 12;
+
+template <typename R>
+chunk_t<R> chunk(R& r, std::size_t b, std::size_t e) {
+    using D = std::ranges::range_difference_t<R>;
+    const auto first = std::ranges::begin(r);
+    return {first + static_cast<D>(b), first + static_cast<D>(e)};
+}
+
+// acrescenta a 'out' as saídas da pipeline sobre [b, e).
+template <typename R, typename Pipe, typename T>
+void collect(R& r, const Pipe& pipe, std::size_t b, std::size_t e,
+             std::vector<T>& out) {
+    auto&& view = std::invoke(pipe, chunk(r, b, e));
+    if constexpr (std::ranges::sized_range<decltype(view)>) {
+        out.reserve(out.size() + std::ranges::size(view));
+    }
+    for (auto&& x : view) out.emplace_back(std::forward<decltype(x)>(x));
+}
+
+// saídas de cada um dos 'chunks' blocos de 'r', na ordem.
+template <typename P, typename R, typename Pipe>
+std::vector<std::vector<value_t<Pipe, R>>> run(P& policy, R& r,
+                                               const Pipe& pipe,
+                                               std::size_t chunks) {
+    const auto n = static_cast<std::size_t>(std::ranges::size(r));
+    std::vector<std::vector<value_t<Pipe, R>>> parts(chunks);
+    parallel::for_each_chunk(policy, n, chunks,
+                             [&](std::size_t i, std::size_t b, std::size_t e) {
+                                 collect(r, pipe, b, e, parts[i]);
+                             });
+    return parts;
+}
+
+}  // namespace detail
+
+// escreve em 'out' as saídas da pipeline 'pipe' sobre 'r', na ordem, e devolve
+// o iterador depois da última.
+struct copy_fn {
+    template <parallel::execution_policy P, std::ranges::random_access_range R,
+              typename Pipe, std::weakly_incrementable O>
+        requires detail::pipeline_for<Pipe, R> &&
+                 std::indirectly_writable<O, detail::value_t<Pipe, R>&&>
+    O operator()(P&& policy, R&& r, const Pipe& pipe, O out) const {
+        const auto n = static_cast<std::size_t>(std::ranges::size(r));
+        const std::size_t chunks =
+            parallel::chunk_count(policy, n, detail::grain);
+        if (chunks <= 1) {
+            for (auto&& x : std::invoke(pipe, detail::chunk(r, 0, n))) {
+                *out = std::forward<decltype(x)>(x);
+                ++out;
+            }
+            return out;
+        }
+        for (auto& part : detail::run(policy, r, pipe, chunks)) {
+            for (auto& x : part) {
+                *out = std::move(x);
+                ++out;
+            }
+        }
+        return out;
+    }
+
+    template <std::ranges::random_access_range R, typename Pipe,
+              std::weakly_incrementable O>
+        requires detail::pipeline_for<Pipe, R> &&
+                 std::indirectly_writable<O, detail::value_t<Pipe, R>&&>
+    O operator()(R&& r, const Pipe& pipe, O out) const {
+        return (*this)(std::execution::seq, std::forward<R>(r), pipe,
+                       std::move(out));
+    }
+};
+
+inline constexpr copy_fn copy{};
+
+// adaptador 'r | pipeline(policy, pipe)': um 'std::vector' com as saídas da
+// pipeline sobre 'r'. Com mais de um bloco, as saídas de cada bloco são movidas
+// para as suas posições no vetor final em paralelo.
+template <parallel::execution_policy P, typename Pipe>
+struct pipeline_closure {
+    P policy;
+    Pipe pipe;
+
+    template <std::ranges::random_access_range R>
+        requires detail::pipeline_for<Pipe, R>
+    friend std::vector<detail::value_t<Pipe, R>> operator|(
+        R&& r, const pipeline_closure& self) {
+        using T = detail::value_t<Pipe, R>;
+        const auto n = static_cast<std::size_t>(std::ranges::size(r));
+        const std::size_t chunks =
+            parallel::chunk_count(self.policy, n, detail::grain);
+        std::vector<T> out;
+        if (chunks <= 1 || !std::default_initializable<T>) {
+            copy(self.policy, r, self.pipe, std::back_inserter(out));
+        } else if constexpr (std::default_initializable<T>) {
+            auto parts = detail::run(self.policy, r, self.pipe, chunks);
+            std::vector<std::size_t> offsets(chunks + 1);
+            for (std::size_t i = 0; i < chunks; ++i) {
+                offsets[i + 1] = offsets[i] + parts[i].size();
+            }
+            out.resize(offsets[chunks]);
+            parallel::for_each_chunk(
+                self.policy, chunks, chunks,
+                [&](std::size_t i, std::size_t, std::size_t) {
+                    const auto at = static_cast<std::ptrdiff_t>(offsets[i]);
+                    std::ranges::move(parts[i], out.begin() + at);
+                    std::vector<T>().swap(parts[i]);
+                });
+        }
+        return out;
+    }
+};
+
+struct pipeline_fn {
+    template <parallel::execution_policy P, typename Pipe>
+    pipeline_closure<std::remove_cvref_t<P>, std::decay_t<Pipe>> operator()(
+        P&& policy, Pipe&& pipe) const {
+        return {std::forward<P>(policy), std::forward<Pipe>(pipe)};
+    }
+};
+
+inline constexpr pipeline_fn pipeline{};
+
+}  // namespace chunk_par
@@ -5,8 +5,13 @@
 #include <print>
 #include <random>
 #include <ranges>
+#include <string>
 #include <vector>
 
+#include "normalized_key.hpp"
+#include "prefix_key.hpp"
+#include "simd_compare.hpp"
+
 namespace compare {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -114,5 +119,46 @@ void main() {
                                                        v4.begin(), v4.end());
     cout << type_id_with_cvr<decltype(cmp7)>().pretty_name() << endl;
     cout << std::is_lt(cmp7) << endl;
+
+    cout << endl;
+    // 'simd::lexicographical_compare': ranges contíguas de inteiros se
+    // comparam com um 'mismatch' vetorizado (ou 'memcmp', para bytes sem
+    // sinal) e uma única comparação de elementos.
+    vector<unsigned char> k1{0x00, 0x01, 0x7f, 0x80, 0xff};
+    vector<unsigned char> k2{0x00, 0x01, 0x7f, 0x81};
+    cout << "simd::lexicographical_compare(k1, k2):" << endl;
+    cout << simd::lexicographical_compare(k1, k2) << endl;
+    cout << "simd::lexicographical_compare_three_way(v3, v4):" << endl;
+    cout << std::is_lt(simd::lexicographical_compare_three_way(v3, v4))
+         << endl;
+
+    cout << endl;
+    // 'prefix_key::sort' ordena chaves com os 8 primeiros bytes de cada
+    // string num inteiro big-endian; o buffer da string só é lido quando os
+    // prefixos empatam.
+    vector<std::string> names3{"international", "internationalization",
+                               "internal", "inter", "alpha", "internet"};
+    prefix_key::sort(names3);
+    cout << "prefix_key::sort(names3):" << endl;
+    for (const auto& s : names3) cout << s << ' ';
+    cout << endl;
+
+    cout << endl;
+    // a comparação campo a campo de 'Point' (x crescente e, aqui, y
+    // decrescente) vira uma comparação de um único 'uint64_t'; a ordenação
+    // usa radix sort e a busca binária usa a chave como projeção.
+    using point_key =
+        normalized_key::encoder<Point, normalized_key::asc<&Point::x>,
+                                normalized_key::desc<&Point::y>>;
+    vector<Point> points{{2, 1}, {-1, 5}, {2, 7}, {0, 0}, {-1, -5}};
+    normalized_key::sort(points, point_key{});
+    cout << "normalized_key::sort(points, point_key{}):" << endl;
+    for (const auto& [x, y] : points) cout << "(" << x << ", " << y << ") ";
+    cout << endl;
+    auto it = std::ranges::lower_bound(points, point_key::key({2, 1}), {},
+                                       point_key{});
+    cout << "std::ranges::lower_bound(points, key({2, 1}), {}, point_key{}):"
+         << endl;
+    cout << it - points.begin() << endl;
 };
 }  // namespace compare
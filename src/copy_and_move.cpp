@@ -8,9 +8,17 @@
 #include <print>
 #include <random>
 #include <ranges>
+#include <span>
+#include <sstream>
 #include <typeinfo>
 #include <vector>
 
+#include "sampling.hpp"
+#include "simd_compact.hpp"
+#include "simd_copy.hpp"
+#include "simd_replace.hpp"
+#include "simd_search.hpp"
+
 namespace copy_and_move {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -103,6 +111,19 @@ void main() {
         std::copy_backward(v.begin(), std::prev(v.end(), 2), v.end());
         cout << "modified 'v': " << stringify(v) << endl;
     };
+    {
+        cout << endl;
+        cout << "simd::copy_backward(std::execution::par, "
+                "std::span(v).first(v.size() - 2), v.end()):"
+             << endl;
+        // origem e destino sobrepostos: a cópia é feita em ondas disjuntas, e
+        // blocos maiores que a cache de último nível não passam por ela.
+        auto v = vw::iota(1, 6) | rg::to<vector<int>>();
+        cout << "original 'v': " << stringify(v) << endl;
+        simd::copy_backward(std::execution::par,
+                            std::span(v).first(v.size() - 2), v.end());
+        cout << "modified 'v': " << stringify(v) << endl;
+    };
     {
         cout << endl;
         cout << "std::ranges::copy_n(std::begin(v) + 1, 3, "
@@ -126,6 +147,20 @@ void main() {
                              [](int i) { return i % 2 == 0; });
         cout << "'o': " << stringify(o) << endl;
     };
+    {
+        cout << endl;
+        cout << "simd::compact_copy_if(v, o.begin(), [](int i) { return i % 2 "
+                "== 0; }):"
+             << endl;
+        // a saída é dimensionada de antemão (contagem sem desvios) em vez de
+        // crescer elemento a elemento por 'back_inserter'.
+        auto v = vw::iota(1, 6) | rg::to<vector<int>>();
+        auto even = [](int i) { return i % 2 == 0; };
+        cout << "'v': " << stringify(v) << endl;
+        vector<int> o(simd::count_if(v, even));
+        simd::compact_copy_if(v, o.begin(), even);
+        cout << "'o': " << stringify(o) << endl;
+    };
     {
         cout << endl;
         cout << "std::ranges::remove_copy_if(v, std::back_inserter(o), [](int "
@@ -159,6 +194,30 @@ void main() {
         std::ranges::sample(v, std::back_inserter(o), 3, std::random_device{});
         cout << "'o': " << stringify(o) << endl;
     };
+    {
+        cout << endl;
+        cout << "sampling::sample(vw::istream<int>(in), "
+                "std::back_inserter(o), 3, g):"
+             << endl;
+        std::istringstream in("1 2 3 4 5 6 7 8 9 10");
+        prng::philox g(42);
+        vector<int> o;
+        sampling::sample(vw::istream<int>(in), std::back_inserter(o), 3, g);
+        cout << "'o': " << stringify(o) << endl;
+    };
+    {
+        cout << endl;
+        cout << "sampling::weighted_sample(std::execution::par, v, "
+                "std::back_inserter(o), 2, 42, [](int i) { return i; }):"
+             << endl;
+        auto v = vw::iota(1, 6) | rg::to<vector<int>>();
+        cout << "'v': " << stringify(v) << endl;
+        vector<int> o;
+        sampling::weighted_sample(std::execution::par, v,
+                                  std::back_inserter(o), 2, 42,
+                                  [](int i) { return i; });
+        cout << "'o': " << stringify(o) << endl;
+    };
     {
         cout << endl;
         cout << "std::ranges::replace_copy(v, std::back_inserter(o), 3, 42):"
@@ -181,6 +240,20 @@ void main() {
             v, std::back_inserter(o), [](int i) { return i % 2 == 0; }, 42);
         cout << "'o': " << stringify(o) << endl;
     };
+    {
+        cout << endl;
+        cout << "simd::replace_copy(std::execution::par, v, "
+                "std::back_inserter(o), 3, 42):"
+             << endl;
+        // 'o' é redimensionado uma única vez e preenchido por blocos
+        // vetorizados (comparação + 'blend').
+        auto v = vw::iota(1, 6) | rg::to<vector<int>>();
+        cout << "'v': " << stringify(v) << endl;
+        vector<int> o;
+        simd::replace_copy(std::execution::par, v, std::back_inserter(o), 3,
+                           42);
+        cout << "'o': " << stringify(o) << endl;
+    };
     {
         cout << endl;
         cout << "std::ranges::reverse_copy(v, std::back_inserter(o)):" << endl;
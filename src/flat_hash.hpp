@@ -0,0 +1,565 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <compare>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory_resource>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Tabela hash de endereçamento aberto ('flat'), no estilo SwissTable.
+// Os elementos ficam num vetor denso, na ordem de inserção, e a tabela guarda
+// apenas um byte de controle (7 bits do hash) e o índice do elemento no vetor
+// denso. A busca compara 16 bytes de controle por vez (SSE2), de forma que a
+// maior parte das sondagens não precisa acessar os elementos.
+// Toda a memória é obtida por um 'std::pmr::memory_resource', o que permite
+// usar uma arena ('std::pmr::monotonic_buffer_resource') quando a tabela tem
+// vida curta.
+namespace flat_hash {
+
+// finalizador do murmur3: espalha os bits de 'std::hash', que para inteiros é
+// a identidade.
+constexpr std::size_t mix(std::size_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+template <typename T>
+struct hash {
+    std::size_t operator()(const T& v) const { return mix(std::hash<T>{}(v)); }
+};
+
+namespace detail {
+
+// maior número de elementos de 'set' e 'map', cujos índices têm 32 bits.
+inline constexpr std::size_t max_elements =
+    std::numeric_limits<std::uint32_t>::max();
+
+// índices (no vetor denso) indexados por hash. 'Index' é o tipo usado para
+// guardar os índices (32 bits reduz pela metade a memória da tabela).
+template <typename Index = std::uint32_t>
+class index_table {
+   public:
+    static constexpr std::size_t group_size = 16;
+    static constexpr std::uint8_t empty = 0x80;
+    static constexpr std::uint8_t deleted = 0xfe;
+
+    explicit index_table(std::pmr::memory_resource* resource =
+                             std::pmr::get_default_resource())
+        : ctrl_(resource), slots_(resource) {}
+
+    std::size_t capacity() const { return ctrl_.size(); }
+    std::size_t growth_left() const { return growth_left_; }
+
+    // elementos suportados por uma tabela de 'slots' posições (carga 7/8).
+    static std::size_t max_load(std::size_t slots) { return slots / 8 * 7; }
+
+    // procura um índice 'i' cujo elemento satisfaça 'eq(i)'.
+    template <typename Eq>
+    const Index* find(std::size_t h, Eq&& eq) const {
+        if (ctrl_.empty()) return nullptr;
+        const std::size_t mask = groups() - 1;
+        std::size_t g = h & mask;
+        for (std::size_t probe = 1;; ++probe) {
+            const std::size_t base = g * group_size;
+            for (std::uint32_t m = match(base, tag(h)); m; m &= m - 1) {
+                const std::size_t s = base + std::countr_zero(m);
+                if (eq(slots_[s])) return &slots_[s];
+            }
+            if (match(base, empty)) return nullptr;
+            g = (g + probe) & mask;
+        }
+    }
+
+    // procura um elemento equivalente; se não existir, insere 'index' na
+    // primeira posição livre da sequência de sondagem. Exige
+    // 'growth_left() > 0'.
+    template <typename Eq>
+    std::pair<Index, bool> find_or_insert(std::size_t h, Eq&& eq,
+                                          Index index) {
+        const std::size_t mask = groups() - 1;
+        std::size_t g = h & mask;
+        std::size_t free = capacity();
+        for (std::size_t probe = 1;; ++probe) {
+            const std::size_t base = g * group_size;
+            for (std::uint32_t m = match(base, tag(h)); m; m &= m - 1) {
+                const std::size_t s = base + std::countr_zero(m);
+                if (eq(slots_[s])) return {slots_[s], false};
+            }
+            if (free == capacity()) {
+                if (std::uint32_t f = match_free(base)) {
+                    free = base + std::countr_zero(f);
+                }
+            }
+            if (match(base, empty)) break;
+            g = (g + probe) & mask;
+        }
+        if (ctrl_[free] == empty) --growth_left_;
+        ctrl_[free] = tag(h);
+        slots_[free] = index;
+        return {index, true};
+    }
+
+    // remove a entrada que aponta para 'index'.
+    void erase(std::size_t h, Index index) {
+        if (Index* s = locate(h, index)) {
+            ctrl_[s - slots_.data()] = deleted;
+        }
+    }
+
+    // substitui a entrada 'from' por 'to' (usado quando o vetor denso move
+    // seu último elemento para ocupar uma posição removida).
+    void relocate(std::size_t h, Index from, Index to) {
+        if (Index* s = locate(h, from)) *s = to;
+    }
+
+    // reconstrói a tabela com espaço para ao menos 'n' elementos, reinserindo
+    // os índices [0, count) cujos hashes são dados por 'hash_of(i)'.
+    template <typename HashOf>
+    void rehash(std::size_t n, std::size_t count, HashOf&& hash_of) {
+        std::size_t slots = group_size;
+        while (max_load(slots) < n) slots *= 2;
+        ctrl_.assign(slots, empty);
+        slots_.assign(slots, Index{});
+        growth_left_ = max_load(slots);
+        for (std::size_t i = 0; i < count; ++i) {
+            find_or_insert(
+                hash_of(i), [](Index) { return false; },
+                static_cast<Index>(i));
+        }
+    }
+
+    void clear() {
+        std::ranges::fill(ctrl_, empty);
+        growth_left_ = max_load(capacity());
+    }
+
+   private:
+    std::size_t groups() const { return capacity() / group_size; }
+
+    // 7 bits mais altos do hash; os mais baixos escolhem o grupo inicial.
+    static std::uint8_t tag(std::size_t h) {
+        return static_cast<std::uint8_t>(h >> 57);
+    }
+
+    // máscara das posições do grupo cujo controle é igual a 'c'.
+    std::uint32_t match(std::size_t base, std::uint8_t c) const {
+#if defined(__SSE2__)
+        const __m128i ctrl = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(ctrl_.data() + base));
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(
+            _mm_cmpeq_epi8(ctrl, _mm_set1_epi8(static_cast<char>(c)))));
+#else
+        std::uint32_t m = 0;
+        for (std::size_t i = 0; i < group_size; ++i) {
+            m |= std::uint32_t{ctrl_[base + i] == c} << i;
+        }
+        return m;
+#endif
+    }
+
+    // posições vazias ou removidas (bit mais alto ligado).
+    std::uint32_t match_free(std::size_t base) const {
+#if defined(__SSE2__)
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(ctrl_.data() + base))));
+#else
+        std::uint32_t m = 0;
+        for (std::size_t i = 0; i < group_size; ++i) {
+            m |= std::uint32_t{(ctrl_[base + i] & 0x80) != 0} << i;
+        }
+        return m;
+#endif
+    }
+
+    Index* locate(std::size_t h, Index index) {
+        const Index* s = find(h, [index](Index i) { return i == index; });
+        return const_cast<Index*>(s);
+    }
+
+    std::pmr::vector<std::uint8_t> ctrl_;
+    std::pmr::vector<Index> slots_;
+    std::size_t growth_left_ = 0;
+};
+
+}  // namespace detail
+
+// conjunto com elementos contíguos, na ordem de inserção.
+template <typename Key, typename Hash = flat_hash::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class set {
+   public:
+    using key_type = Key;
+    using value_type = Key;
+    using size_type = std::size_t;
+    using iterator = typename std::pmr::vector<Key>::const_iterator;
+    using const_iterator = iterator;
+
+    explicit set(std::pmr::memory_resource* resource =
+                     std::pmr::get_default_resource())
+        : keys_(resource), table_(resource) {}
+
+    set(Hash hash, KeyEqual eq,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : keys_(resource), table_(resource), hash_(hash), eq_(eq) {}
+
+    iterator begin() const { return keys_.begin(); }
+    iterator end() const { return keys_.end(); }
+    const Key* data() const { return keys_.data(); }
+    size_type size() const { return keys_.size(); }
+    bool empty() const { return keys_.empty(); }
+
+    void reserve(size_type n) {
+        keys_.reserve(n);
+        if (n > size() + table_.growth_left()) {
+            table_.rehash(n, size(),
+                          [this](std::size_t i) { return hash_(keys_[i]); });
+        }
+    }
+
+    template <typename K = Key>
+    std::pair<iterator, bool> insert(K&& key) {
+        if (table_.growth_left() == 0) {
+            reserve(std::max<size_type>(16, 2 * size()));
+        }
+        if (size() == detail::max_elements) {
+            if (auto it = find(key); it != end()) return {it, false};
+            throw std::length_error("flat_hash::set: índices de 32 bits");
+        }
+        const std::size_t h = hash_(key);
+        auto [i, inserted] = table_.find_or_insert(
+            h, [&](std::uint32_t j) { return eq_(keys_[j], key); },
+            static_cast<std::uint32_t>(size()));
+        if (inserted) {
+            // a tabela já aponta para 'i': desfeita se a cópia da chave
+            // lançar.
+            try {
+                keys_.emplace_back(std::forward<K>(key));
+            } catch (...) {
+                table_.erase(h, i);
+                throw;
+            }
+        }
+        return {begin() + i, inserted};
+    }
+
+    iterator find(const Key& key) const {
+        const std::uint32_t* s = table_.find(
+            hash_(key), [&](std::uint32_t j) { return eq_(keys_[j], key); });
+        return s ? begin() + *s : end();
+    }
+
+    bool contains(const Key& key) const { return find(key) != end(); }
+    size_type count(const Key& key) const { return contains(key); }
+
+    void clear() {
+        keys_.clear();
+        table_.clear();
+    }
+
+   private:
+    std::pmr::vector<Key> keys_;
+    detail::index_table<std::uint32_t> table_;
+    [[no_unique_address]] Hash hash_;
+    [[no_unique_address]] KeyEqual eq_;
+};
+
+// mapa com chaves e valores em vetores densos separados (na ordem de
+// inserção): 'keys()' e 'values()' são 'std::span' e percorrê-los é uma
+// leitura sequencial de memória, sem seguir ponteiros de nós como em
+// 'std::unordered_map'. A iteração produz pares de referências
+// ('std::pair<const Key&, T&>'), de forma que 'std::views::keys' e
+// 'std::views::values' também funcionam.
+// 'erase' move o último elemento para a posição removida, portanto a ordem
+// de inserção só é mantida enquanto não houver remoções.
+template <typename Key, typename T, typename Hash = flat_hash::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class map {
+    template <bool Const>
+    class basic_iterator;
+
+   public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<Key, T>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::pair<const Key&, T&>;
+    using const_reference = std::pair<const Key&, const T&>;
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    explicit map(std::pmr::memory_resource* resource =
+                     std::pmr::get_default_resource())
+        : keys_(resource), values_(resource), table_(resource) {}
+
+    // construção em lote: a tabela é dimensionada uma única vez quando o
+    // tamanho da entrada é conhecido.
+    template <std::input_iterator It, std::sentinel_for<It> S>
+    map(It first, S last,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : map(resource) {
+        insert_range(std::ranges::subrange(std::move(first), std::move(last)));
+    }
+
+    map(std::initializer_list<value_type> init,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : map(init.begin(), init.end(), resource) {}
+
+#if defined(__cpp_lib_containers_ranges)
+    template <std::ranges::input_range R>
+    map(std::from_range_t, R&& r,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : map(resource) {
+        insert_range(std::forward<R>(r));
+    }
+#endif
+
+    iterator begin() { return {this, 0}; }
+    iterator end() { return {this, size()}; }
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const { return {this, size()}; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    std::span<const Key> keys() const { return keys_; }
+    std::span<T> values() { return values_; }
+    std::span<const T> values() const { return values_; }
+
+    size_type size() const { return keys_.size(); }
+    bool empty() const { return keys_.empty(); }
+    size_type capacity() const { return keys_.capacity(); }
+
+    void reserve(size_type n) {
+        keys_.reserve(n);
+        values_.reserve(n);
+        if (n > size() + table_.growth_left()) {
+            table_.rehash(n, size(),
+                          [this](std::size_t i) { return hash_(keys_[i]); });
+        }
+    }
+
+    template <typename K = Key, typename... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+        if (table_.growth_left() == 0) {
+            reserve(std::max<size_type>(16, 2 * size()));
+        }
+        if (size() == detail::max_elements) {
+            if (auto it = find(key); it != end()) return {it, false};
+            throw std::length_error("flat_hash::map: índices de 32 bits");
+        }
+        const std::size_t h = hash_(key);
+        auto [i, inserted] = table_.find_or_insert(
+            h, [&](std::uint32_t j) { return eq_(keys_[j], key); },
+            static_cast<std::uint32_t>(size()));
+        if (inserted) {
+            // a tabela já aponta para 'i': se a construção da chave ou do
+            // valor lançar, a chave e a entrada da tabela são desfeitas.
+            try {
+                keys_.emplace_back(std::forward<K>(key));
+                try {
+                    values_.emplace_back(std::forward<Args>(args)...);
+                } catch (...) {
+                    keys_.pop_back();
+                    throw;
+                }
+            } catch (...) {
+                table_.erase(h, i);
+                throw;
+            }
+        }
+        return {{this, i}, inserted};
+    }
+
+    template <typename K, typename V>
+    std::pair<iterator, bool> emplace(K&& key, V&& value) {
+        return try_emplace(std::forward<K>(key), std::forward<V>(value));
+    }
+
+    template <typename P>
+        requires std::constructible_from<value_type, P&&>
+    std::pair<iterator, bool> insert(P&& p) {
+        return try_emplace(std::get<0>(std::forward<P>(p)),
+                           std::get<1>(std::forward<P>(p)));
+    }
+
+    // forma usada por 'std::inserter' e 'std::ranges::to' ('hint' é
+    // ignorado).
+    template <typename P>
+        requires std::constructible_from<value_type, P&&>
+    iterator insert(const_iterator, P&& p) {
+        return insert(std::forward<P>(p)).first;
+    }
+
+    template <std::ranges::input_range R>
+    void insert_range(R&& r) {
+        if constexpr (std::ranges::sized_range<R>) {
+            reserve(size() + std::ranges::size(r));
+        } else if constexpr (std::ranges::forward_range<R>) {
+            reserve(size() + static_cast<size_type>(std::ranges::distance(r)));
+        }
+        for (auto&& p : r) insert(std::forward<decltype(p)>(p));
+    }
+
+    T& operator[](const Key& key) { return (*try_emplace(key).first).second; }
+    T& operator[](Key&& key) {
+        return (*try_emplace(std::move(key)).first).second;
+    }
+
+    T& at(const Key& key) {
+        auto i = index_of(key);
+        if (i == size()) throw std::out_of_range("flat_hash::map::at");
+        return values_[i];
+    }
+    const T& at(const Key& key) const {
+        auto i = index_of(key);
+        if (i == size()) throw std::out_of_range("flat_hash::map::at");
+        return values_[i];
+    }
+
+    iterator find(const Key& key) { return {this, index_of(key)}; }
+    const_iterator find(const Key& key) const { return {this, index_of(key)}; }
+    bool contains(const Key& key) const { return index_of(key) != size(); }
+    size_type count(const Key& key) const { return contains(key); }
+
+    size_type erase(const Key& key) {
+        const std::size_t i = index_of(key);
+        if (i == size()) return 0;
+        const std::size_t last = size() - 1;
+        table_.erase(hash_(keys_[i]), static_cast<std::uint32_t>(i));
+        if (i != last) {
+            table_.relocate(hash_(keys_[last]),
+                            static_cast<std::uint32_t>(last),
+                            static_cast<std::uint32_t>(i));
+            keys_[i] = std::move(keys_[last]);
+            values_[i] = std::move(values_[last]);
+        }
+        keys_.pop_back();
+        values_.pop_back();
+        return 1;
+    }
+
+    void clear() {
+        keys_.clear();
+        values_.clear();
+        table_.clear();
+    }
+
+   private:
+    std::size_t index_of(const Key& key) const {
+        const std::uint32_t* s = table_.find(
+            hash_(key), [&](std::uint32_t j) { return eq_(keys_[j], key); });
+        return s ? *s : size();
+    }
+
+    std::pmr::vector<Key> keys_;
+    std::pmr::vector<T> values_;
+    detail::index_table<std::uint32_t> table_;
+    [[no_unique_address]] Hash hash_;
+    [[no_unique_address]] KeyEqual eq_;
+};
+
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+template <bool Const>
+class map<Key, T, Hash, KeyEqual>::basic_iterator {
+    using owner = std::conditional_t<Const, const map, map>;
+
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using iterator_concept = std::random_access_iterator_tag;
+    using value_type = std::pair<Key, T>;
+    using difference_type = std::ptrdiff_t;
+    using reference =
+        std::pair<const Key&, std::conditional_t<Const, const T&, T&>>;
+
+    // 'operator->' precisa retornar algo que se comporte como ponteiro.
+    struct pointer {
+        reference ref;
+        const reference* operator->() const { return &ref; }
+    };
+
+    basic_iterator() = default;
+    basic_iterator(owner* m, std::size_t i) : map_(m), i_(i) {}
+    operator basic_iterator<true>() const
+        requires(!Const)
+    {
+        return {map_, i_};
+    }
+
+    reference operator*() const {
+        return {map_->keys_[i_], map_->values_[i_]};
+    }
+    pointer operator->() const { return {**this}; }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    basic_iterator& operator++() {
+        ++i_;
+        return *this;
+    }
+    basic_iterator operator++(int) {
+        auto tmp = *this;
+        ++i_;
+        return tmp;
+    }
+    basic_iterator& operator--() {
+        --i_;
+        return *this;
+    }
+    basic_iterator operator--(int) {
+        auto tmp = *this;
+        --i_;
+        return tmp;
+    }
+    basic_iterator& operator+=(difference_type n) {
+        i_ += n;
+        return *this;
+    }
+    basic_iterator& operator-=(difference_type n) {
+        i_ -= n;
+        return *this;
+    }
+    friend basic_iterator operator+(basic_iterator it, difference_type n) {
+        return it += n;
+    }
+    friend basic_iterator operator+(difference_type n, basic_iterator it) {
+        return it += n;
+    }
+    friend basic_iterator operator-(basic_iterator it, difference_type n) {
+        return it -= n;
+    }
+    friend difference_type operator-(const basic_iterator& a,
+                                     const basic_iterator& b) {
+        return static_cast<difference_type>(a.i_) -
+               static_cast<difference_type>(b.i_);
+    }
+    friend bool operator==(const basic_iterator& a, const basic_iterator& b) {
+        return a.i_ == b.i_;
+    }
+    friend auto operator<=>(const basic_iterator& a, const basic_iterator& b) {
+        return a.i_ <=> b.i_;
+    }
+
+   private:
+    friend class map;
+    owner* map_ = nullptr;
+    std::size_t i_ = 0;
+};
+
+}  // namespace flat_hash
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <execution>
+#include <limits>
+#include <ranges>
+#include <type_traits>
+
+#include "parallel.hpp"
+#include "reduction.hpp"
+
+// Expressões elemento a elemento sobre várias colunas, reduzidas numa única
+// passada. 'std::transform_reduce' aceita no máximo duas ranges e compor
+// transformações exige vetores temporários; aqui 'sum(a * b + c)' constrói
+// apenas uma árvore de tipos (expression templates) e cada elemento de cada
+// coluna é lido uma única vez, dentro do mesmo kernel vetorizado da
+// 'reduction'. O resultado herda as garantias de 'reduction::sum': a ordem das
+// operações é fixa, sem contração em FMA, e idêntica entre ISAs e threads.
+//
+//     auto [a, b, c] = std::tuple{fused::col(x), fused::col(y), fused::col(z)};
+//     double l1 = fused::sum(std::execution::par, fused::abs(a - b));
+//     double w = fused::sum(a * b + 2.0 * c);
+namespace fused {
+
+using reduction::summation;
+
+// base de todos os nós, que restringe os operadores abaixo às expressões.
+struct node {};
+
+template <typename E>
+concept expression = std::derived_from<E, node> &&
+                     reduction::detail::source<E>;
+
+#pragma GCC push_options
+#pragma GCC optimize("fp-contract=off")
+// os vetores trafegam apenas entre funções expandidas no mesmo kernel.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+// referência a uma range contígua (não é dona dos elementos).
+template <reduction::real T>
+struct column : node {
+    using value_type = T;
+    const T* data;
+    std::size_t n;
+
+    std::size_t size() const { return n; }
+    template <typename V>
+    [[gnu::always_inline]] V load(std::size_t i) const {
+        V x;
+        std::memcpy(&x, data + i, sizeof(V));
+        return x;
+    }
+};
+
+// escalar repetido; não limita o tamanho da expressão.
+template <reduction::real T>
+struct constant : node {
+    using value_type = T;
+    T value;
+
+    std::size_t size() const { return std::numeric_limits<std::size_t>::max(); }
+    template <typename V>
+    [[gnu::always_inline]] V load(std::size_t) const {
+        return value - V{};  // difusão; 'x - 0' preserva o sinal de -0.0
+    }
+};
+
+template <typename Op, expression E>
+struct unary : node {
+    using value_type = typename E::value_type;
+    E e;
+
+    std::size_t size() const { return e.size(); }
+    template <typename V>
+    [[gnu::always_inline]] V load(std::size_t i) const {
+        return Op{}(e.template load<V>(i));
+    }
+};
+
+template <typename Op, expression L, expression R>
+    requires std::same_as<typename L::value_type, typename R::value_type>
+struct binary : node {
+    using value_type = typename L::value_type;
+    L l;
+    R r;
+
+    std::size_t size() const { return std::min(l.size(), r.size()); }
+    template <typename V>
+    [[gnu::always_inline]] V load(std::size_t i) const {
+        return Op{}(l.template load<V>(i), r.template load<V>(i));
+    }
+};
+
+// operações válidas tanto para escalares quanto para vetores do GCC.
+namespace op {
+struct plus {
+    template <typename V>
+    [[gnu::always_inline]] V operator()(V a, V b) const { return a + b; }
+};
+struct minus {
+    template <typename V>
+    [[gnu::always_inline]] V operator()(V a, V b) const { return a - b; }
+};
+struct multiplies {
+    template <typename V>
+    [[gnu::always_inline]] V operator()(V a, V b) const { return a * b; }
+};
+struct divides {
+    template <typename V>
+    [[gnu::always_inline]] V operator()(V a, V b) const { return a / b; }
+};
+struct min {
+    template <typename V>
+    [[gnu::always_inline]] V operator()(V a, V b) const {
+        return b < a ? b : a;
+    }
+};
+struct max {
+    template <typename V>
+    [[gnu::always_inline]] V operator()(V a, V b) const {
+        return a < b ? b : a;
+    }
+};
+struct negate {
+    template <typename V>
+    [[gnu::always_inline]] V operator()(V a) const { return -a; }
+};
+struct abs {
+    template <typename V>
+    [[gnu::always_inline]] V operator()(V a) const {
+        return a < 0 ? -a : a + V{};  // '+ 0' converte -0.0 em 0.0
+    }
+};
+struct square {
+    template <typename V>
+    [[gnu::always_inline]] V operator()(V a) const { return a * a; }
+};
+}  // namespace op
+
+#pragma GCC diagnostic pop
+#pragma GCC pop_options
+
+template <reduction::real_contiguous_range R>
+    requires std::ranges::borrowed_range<R>
+auto col(R&& r) {
+    using T = std::remove_cv_t<std::ranges::range_value_t<R>>;
+    return column<T>{{}, std::ranges::data(r), std::ranges::size(r)};
+}
+
+namespace detail {
+// operandos aritméticos viram constantes do tipo dos elementos da expressão.
+template <typename T, typename X>
+auto operand(X&& x) {
+    if constexpr (expression<std::remove_cvref_t<X>>) {
+        return std::remove_cvref_t<X>(std::forward<X>(x));
+    } else {
+        return constant<T>{{}, static_cast<T>(x)};
+    }
+}
+
+template <typename L, typename R>
+concept operands =
+    (expression<L> && (expression<R> || std::is_arithmetic_v<R>)) ||
+    (expression<R> && std::is_arithmetic_v<L>);
+
+template <typename L, typename R>
+using value_t = typename std::conditional_t<expression<L>, L, R>::value_type;
+
+template <typename Op, typename L, typename R>
+auto make_binary(L&& l, R&& r) {
+    using T = value_t<std::remove_cvref_t<L>, std::remove_cvref_t<R>>;
+    auto a = operand<T>(std::forward<L>(l));
+    auto b = operand<T>(std::forward<R>(r));
+    return binary<Op, decltype(a), decltype(b)>{{}, a, b};
+}
+}  // namespace detail
+
+template <typename L, typename R>
+    requires detail::operands<std::remove_cvref_t<L>, std::remove_cvref_t<R>>
+auto operator+(L&& l, R&& r) {
+    return detail::make_binary<op::plus>(std::forward<L>(l),
+                                         std::forward<R>(r));
+}
+
+template <typename L, typename R>
+    requires detail::operands<std::remove_cvref_t<L>, std::remove_cvref_t<R>>
+auto operator-(L&& l, R&& r) {
+    return detail::make_binary<op::minus>(std::forward<L>(l),
+                                          std::forward<R>(r));
+}
+
+template <typename L, typename R>
+    requires detail::operands<std::remove_cvref_t<L>, std::remove_cvref_t<R>>
+auto operator*(L&& l, R&& r) {
+    return detail::make_binary<op::multiplies>(std::forward<L>(l),
+                                               std::forward<R>(r));
+}
+
+template <typename L, typename R>
+    requires detail::operands<std::remove_cvref_t<L>, std::remove_cvref_t<R>>
+auto operator/(L&& l, R&& r) {
+    return detail::make_binary<op::divides>(std::forward<L>(l),
+                                            std::forward<R>(r));
+}
+
+template <typename L, typename R>
+    requires detail::operands<std::remove_cvref_t<L>, std::remove_cvref_t<R>>
+auto min(L&& l, R&& r) {
+    return detail::make_binary<op::min>(std::forward<L>(l),
+                                        std::forward<R>(r));
+}
+
+template <typename L, typename R>
+    requires detail::operands<std::remove_cvref_t<L>, std::remove_cvref_t<R>>
+auto max(L&& l, R&& r) {
+    return detail::make_binary<op::max>(std::forward<L>(l),
+                                        std::forward<R>(r));
+}
+
+template <expression E>
+auto operator-(const E& e) {
+    return unary<op::negate, E>{{}, e};
+}
+
+template <expression E>
+auto abs(const E& e) {
+    return unary<op::abs, E>{{}, e};
+}
+
+template <expression E>
+auto square(const E& e) {
+    return unary<op::square, E>{{}, e};
+}
+
+// soma da expressão numa passada; o tamanho é o da menor coluna.
+template <parallel::execution_policy P, expression E>
+auto sum(P&& policy, const E& e, summation method = summation::pairwise) {
+    return reduction::detail::reduce(policy, e, method);
+}
+
+template <expression E>
+auto sum(const E& e, summation method = summation::pairwise) {
+    return sum(std::execution::seq, e, method);
+}
+
+}  // namespace fused
@@ -2,6 +2,7 @@
 #include <boost/type_index.hpp>
 #include <concepts>
 #include <execution>
+#include <iomanip>
 #include <iostream>
 #include <list>
 #include <numeric>
@@ -11,6 +12,8 @@
 #include <typeinfo>
 #include <vector>
 
+#include "reduction.hpp"
+
 namespace general_reductions {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -32,6 +35,12 @@ auto stringify(Rng&& seq) {
 struct Duck {
     string sound = "Quack";
     Duck operator+(const Duck& d) const { return {sound + d.sound}; }
+    // combinação no lugar, usada por 'reduction::reduce' (sem cópias do
+    // acumulador).
+    Duck& operator+=(const Duck& d) {
+        sound += d.sound;
+        return *this;
+    }
 };
 
 std::string to_string(const Duck& d) { return "{" + d.sound + "}"; }
@@ -72,6 +81,19 @@ void main() {
     Duck res4 = std::reduce(std::execution::par_unseq, v4.begin(), v4.end());
     cout << "Duck res; 'res': " << "{" + res4.sound + "}" << endl;
 
+    cout << endl;
+    cout << "reduction::reduce(std::execution::par, v, Duck{\"\"}) / "
+            "reduction::concat(std::execution::par, v, &Duck::sound):"
+         << endl;
+    // 'Duck::operator+' copia o acumulador a cada passo (O(n²) bytes);
+    // 'reduction::reduce' acumula no lugar com '+=' e 'reduction::concat'
+    // calcula o tamanho final antes de copiar cada 'sound' uma única vez.
+    vector<Duck> v4b(1000, Duck{});
+    Duck res4b = reduction::reduce(std::execution::par, v4b, Duck{""});
+    string sounds4b = reduction::concat(std::execution::par, v4b, &Duck::sound);
+    cout << "'res.sound.size()': " << res4b.sound.size() << endl;
+    cout << "'sounds.size()': " << sounds4b.size() << endl;
+
     cout << endl;
     cout << "std::transform_reduce(v.begin(), v.end(), 0, std::plus<>{}, "
             "[](int i) {return i*i;}):"
@@ -100,6 +122,31 @@ void main() {
                                   [](int i, int j) { return i * j; })
          << endl;
 
+    cout << endl;
+    cout << "reduction::sum / reduction::dot (par, reprodutível):" << endl;
+    vector<double> v13(1'000'000, 0.1);
+    auto w13 = vw::iota(0, 1'000'000) |
+               vw::transform([](int i) { return i % 2 ? -1.0 : 1.0; }) |
+               rg::to<vector<double>>();
+    // o resultado de 'std::reduce(par, ...)' pode mudar com o número de
+    // threads; o de 'reduction::sum(par, ...)' é sempre o mesmo.
+    cout << std::setprecision(17);
+    cout << "'std::reduce(par)': "
+         << std::reduce(std::execution::par, v13.begin(), v13.end()) << endl;
+    cout << "'sum(fast)': "
+         << reduction::sum(std::execution::par, v13,
+                           reduction::summation::fast)
+         << endl;
+    cout << "'sum(pairwise)': " << reduction::sum(std::execution::par, v13)
+         << endl;
+    cout << "'sum(kahan)': "
+         << reduction::sum(std::execution::par, v13,
+                           reduction::summation::kahan)
+         << endl;
+    cout << "'dot(v, w)': " << reduction::dot(std::execution::par, v13, w13)
+         << endl;
+    cout << std::setprecision(6);
+
     cout << endl;
     cout << "std::inclusive_scan(v.begin(), v.end(), std::back_inserter(o), "
             "std::plus<>{}):"
@@ -0,0 +1,411 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+// Corrotinas geradoras como ranges de entrada, para produtores que entregam
+// os elementos sob demanda (sequências ilimitadas, leituras de um fluxo):
+//
+//     coro::generator<int> naturals() {
+//         for (int i = 0;; ++i) co_yield i;
+//     }
+//     for (int i : naturals() | std::views::take(5)) ...
+//
+// - 'generator<Ref, V>' segue a interface de 'std::generator' do C++23
+//   (ausente na libstdc++ 12), sem 'elements_of': '*it' é o próprio objeto
+//   passado a 'co_yield' (ou uma cópia dele, se for um lvalue e a referência
+//   for de rvalue), e cada elemento custa uma retomada da corrotina.
+// - 'batch_generator<T, N>' entrega os elementos em lotes, e o iterador
+//   percorre um lote inteiro antes de retomar a corrotina. O caminho rápido é
+//   'co_yield std::span<T>' de um lote guardado pelo próprio produtor e
+//   preenchido por uma função comum, fora da corrotina: dentro do corpo de
+//   uma corrotina as variáveis do laço vivem no quadro, e o compilador
+//   otimiza mal o laço de preenchimento.
+//
+//       void fill_squares(std::span<long> batch, long first);
+//       coro::batch_generator<long> squares() {
+//           std::array<long, 64> batch;
+//           for (long i = 0;; i += batch.size()) {
+//               fill_squares(batch, i);
+//               co_yield std::span(batch);
+//           }
+//       }
+//
+//   'co_yield x' também é aceito: 'x' é movido para um buffer de 'N'
+//   elementos no quadro, e a corrotina só suspende quando ele enche. Isso
+//   evita as suspensões, mas não o protocolo de 'co_yield' a cada elemento,
+//   e fica perto do custo de 'generator'. Em troca, o produtor fica até um
+//   lote à frente do consumidor. Exceções do produtor chegam ao consumidor
+//   depois dos elementos produzidos antes delas.
+// Os quadros das corrotinas são alocados pelo 'operator new' global, ou pelo
+// 'std::pmr::memory_resource' passado como 'std::allocator_arg, resource'
+// nos primeiros argumentos (depois do objeto, em funções membro). Com uma
+// 'frame_arena', geradores de vida curta criados em sequência reaproveitam
+// os quadros uns dos outros:
+//
+//     coro::generator<int> take(std::allocator_arg_t, coro::frame_arena&,
+//                               int n);
+//     coro::frame_arena arena;
+//     for (...) for (int i : take(std::allocator_arg, arena, 8)) ...
+namespace coro {
+
+// recurso para os quadros de geradores numa única thread: os blocos
+// liberados são reaproveitados por tamanho, sem sincronização.
+using frame_arena = std::pmr::unsynchronized_pool_resource;
+
+namespace detail {
+
+// cabeçalho antes de cada quadro com o recurso que o alocou (nulo para o
+// 'operator new' global); ocupa um alinhamento inteiro para não desalinhar o
+// quadro.
+struct frame_header {
+    std::pmr::memory_resource* resource;
+};
+inline constexpr std::size_t header_size = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+static_assert(sizeof(frame_header) <= header_size);
+
+inline void* allocate_frame(std::size_t n, std::pmr::memory_resource* r) {
+    void* p = r ? r->allocate(n + header_size, header_size)
+                : ::operator new(n + header_size);
+    ::new (p) frame_header{r};
+    return static_cast<std::byte*>(p) + header_size;
+}
+
+inline void deallocate_frame(void* frame, std::size_t n) noexcept {
+    std::byte* p = static_cast<std::byte*>(frame) - header_size;
+    std::pmr::memory_resource* r =
+        std::launder(reinterpret_cast<frame_header*>(p))->resource;
+    if (r) {
+        r->deallocate(p, n + header_size, header_size);
+    } else {
+        ::operator delete(p, n + header_size);
+    }
+}
+
+// base das promises: o compilador escolhe o 'operator new' cujos argumentos
+// extras casam com os da corrotina, e recorre ao primeiro se nenhum casar.
+struct frame_allocation {
+    static void* operator new(std::size_t n) {
+        return allocate_frame(n, nullptr);
+    }
+    template <typename... Args>
+    static void* operator new(std::size_t n, std::allocator_arg_t,
+                              std::pmr::memory_resource& r, Args&...) {
+        return allocate_frame(n, &r);
+    }
+    template <typename This, typename... Args>
+    static void* operator new(std::size_t n, This&, std::allocator_arg_t,
+                              std::pmr::memory_resource& r, Args&...) {
+        return allocate_frame(n, &r);
+    }
+    static void operator delete(void* p, std::size_t n) noexcept {
+        deallocate_frame(p, n);
+    }
+};
+
+// como em 'std::generator', o corpo de um gerador não pode usar 'co_await'.
+struct no_await {
+    template <typename U>
+    std::suspend_never await_transform(U&&) = delete;
+};
+
+// dono do quadro de uma corrotina: só pode ser movido.
+template <typename Promise>
+class owned_handle {
+   public:
+    owned_handle() = default;
+    explicit owned_handle(std::coroutine_handle<Promise> h) noexcept
+        : handle_(h) {}
+    owned_handle(owned_handle&& other) noexcept
+        : handle_(std::exchange(other.handle_, {})) {}
+    owned_handle& operator=(owned_handle other) noexcept {
+        std::swap(handle_, other.handle_);
+        return *this;
+    }
+    ~owned_handle() {
+        if (handle_) handle_.destroy();
+    }
+
+    std::coroutine_handle<Promise> get() const noexcept { return handle_; }
+
+   private:
+    std::coroutine_handle<Promise> handle_;
+};
+
+}  // namespace detail
+
+template <typename Ref, typename V = void>
+class generator : public std::ranges::view_interface<generator<Ref, V>> {
+   public:
+    using value_type =
+        std::conditional_t<std::is_void_v<V>, std::remove_cvref_t<Ref>, V>;
+    using reference = std::conditional_t<std::is_void_v<V>, Ref&&, Ref>;
+    using yielded =
+        std::conditional_t<std::is_reference_v<reference>, reference,
+                           const reference&>;
+
+    class promise_type;
+    class iterator;
+
+    generator(generator&&) noexcept = default;
+    generator& operator=(generator other) noexcept {
+        std::swap(frame_, other.frame_);
+        return *this;
+    }
+
+    // retoma a corrotina até o primeiro elemento; só pode ser chamada uma
+    // vez.
+    iterator begin() {
+        frame_.get().resume();
+        return iterator(frame_.get());
+    }
+    std::default_sentinel_t end() const noexcept { return {}; }
+
+   private:
+    using handle = std::coroutine_handle<promise_type>;
+    explicit generator(handle h) noexcept : frame_(h) {}
+
+    detail::owned_handle<promise_type> frame_;
+};
+
+template <typename Ref, typename V>
+class generator<Ref, V>::promise_type : public detail::frame_allocation,
+                                        public detail::no_await {
+   public:
+    generator get_return_object() noexcept {
+        return generator(handle::from_promise(*this));
+    }
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    std::suspend_always final_suspend() const noexcept { return {}; }
+
+    std::suspend_always yield_value(yielded x) noexcept {
+        value_ = std::addressof(x);
+        return {};
+    }
+    // lvalue entregue como rvalue: a cópia vive no 'awaiter', que fica no
+    // quadro até a corrotina ser retomada.
+    auto yield_value(const std::remove_reference_t<yielded>& x)
+        requires std::is_rvalue_reference_v<yielded> &&
+                 std::constructible_from<std::remove_cvref_t<yielded>,
+                                         const std::remove_reference_t<
+                                             yielded>&>
+    {
+        struct awaiter {
+            std::remove_cvref_t<yielded> copy;
+            promise_type* promise;
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<>) noexcept {
+                promise->value_ = std::addressof(copy);
+            }
+            void await_resume() const noexcept {}
+        };
+        return awaiter{x, this};
+    }
+
+    void return_void() const noexcept {}
+    // a exceção sai da retomada, no incremento do iterador.
+    void unhandled_exception() { throw; }
+
+   private:
+    friend iterator;
+    std::add_pointer_t<yielded> value_ = nullptr;
+};
+
+template <typename Ref, typename V>
+class generator<Ref, V>::iterator {
+   public:
+    using value_type = generator::value_type;
+    using difference_type = std::ptrdiff_t;
+
+    iterator(iterator&& other) noexcept
+        : handle_(std::exchange(other.handle_, {})) {}
+    iterator& operator=(iterator&& other) noexcept {
+        handle_ = std::exchange(other.handle_, {});
+        return *this;
+    }
+
+    reference operator*() const
+        noexcept(std::is_nothrow_copy_constructible_v<reference>) {
+        return static_cast<reference>(*handle_.promise().value_);
+    }
+    iterator& operator++() {
+        handle_.resume();
+        return *this;
+    }
+    void operator++(int) { ++*this; }
+
+    friend bool operator==(const iterator& it, std::default_sentinel_t) {
+        return it.handle_.done();
+    }
+
+   private:
+    friend generator;
+    explicit iterator(handle h) noexcept : handle_(h) {}
+
+    handle handle_;
+};
+
+template <typename T, std::size_t N = 64>
+    requires std::same_as<T, std::remove_cvref_t<T>> && (N > 0)
+class batch_generator
+    : public std::ranges::view_interface<batch_generator<T, N>> {
+   public:
+    class promise_type;
+    class iterator;
+
+    batch_generator(batch_generator&&) noexcept = default;
+    batch_generator& operator=(batch_generator other) noexcept {
+        std::swap(frame_, other.frame_);
+        return *this;
+    }
+
+    // retoma a corrotina até o primeiro lote; só pode ser chamada uma vez.
+    iterator begin() {
+        iterator it(frame_.get());
+        it.fill();
+        return it;
+    }
+    std::default_sentinel_t end() const noexcept { return {}; }
+
+   private:
+    using handle = std::coroutine_handle<promise_type>;
+    explicit batch_generator(handle h) noexcept : frame_(h) {}
+
+    detail::owned_handle<promise_type> frame_;
+};
+
+template <typename T, std::size_t N>
+    requires std::same_as<T, std::remove_cvref_t<T>> && (N > 0)
+class batch_generator<T, N>::promise_type : public detail::frame_allocation,
+                                            public detail::no_await {
+    // suspende a corrotina apenas quando o buffer enche.
+    struct awaiter {
+        bool ready;
+
+        bool await_ready() const noexcept { return ready; }
+        void await_suspend(std::coroutine_handle<>) const noexcept {}
+        void await_resume() const noexcept {}
+    };
+
+   public:
+    promise_type() = default;
+    promise_type(const promise_type&) = delete;
+    ~promise_type() { clear(); }
+
+    batch_generator get_return_object() noexcept {
+        return batch_generator(handle::from_promise(*this));
+    }
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    std::suspend_always final_suspend() const noexcept { return {}; }
+
+    template <typename U = T>
+        requires std::constructible_from<T, U>
+    awaiter yield_value(U&& x) {
+        std::construct_at(data() + size_, std::forward<U>(x));
+        ++size_;
+        return {size_ < N};
+    }
+    // lote inteiro guardado pelo próprio produtor, entregue sem cópias depois
+    // dos elementos que já estão no buffer; a memória de 's' precisa
+    // continuar válida até a corrotina ser retomada.
+    std::suspend_always yield_value(std::span<T> s) noexcept {
+        pending_ = s;
+        return {};
+    }
+
+    void return_void() const noexcept {}
+    // guardada até o consumidor esgotar o lote atual.
+    void unhandled_exception() noexcept { error_ = std::current_exception(); }
+
+   private:
+    friend iterator;
+
+    T* data() noexcept { return reinterpret_cast<T*>(buffer_); }
+    void clear() noexcept {
+        std::destroy_n(data(), size_);
+        size_ = 0;
+    }
+
+    alignas(T) std::byte buffer_[N * sizeof(T)];
+    std::size_t size_ = 0;
+    std::span<T> pending_;
+    std::exception_ptr error_;
+};
+
+template <typename T, std::size_t N>
+    requires std::same_as<T, std::remove_cvref_t<T>> && (N > 0)
+class batch_generator<T, N>::iterator {
+   public:
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+
+    iterator(iterator&& other) noexcept
+        : handle_(std::exchange(other.handle_, {})),
+          current_(std::exchange(other.current_, nullptr)),
+          last_(std::exchange(other.last_, nullptr)) {}
+    iterator& operator=(iterator&& other) noexcept {
+        handle_ = std::exchange(other.handle_, {});
+        current_ = std::exchange(other.current_, nullptr);
+        last_ = std::exchange(other.last_, nullptr);
+        return *this;
+    }
+
+    T& operator*() const noexcept { return *current_; }
+    iterator& operator++() {
+        if (++current_ == last_) fill();
+        return *this;
+    }
+    void operator++(int) { ++*this; }
+
+    // o lote só fica vazio depois de a corrotina terminar.
+    friend bool operator==(const iterator& it, std::default_sentinel_t) {
+        return it.current_ == it.last_;
+    }
+
+   private:
+    friend batch_generator;
+    explicit iterator(handle h) noexcept : handle_(h) {}
+
+    // troca o lote consumido pelo próximo (o buffer da promise ou um
+    // 'std::span' do produtor); '[current_, last_)' é o lote atual, lido sem
+    // passar pela promise a cada elemento, e fica vazio no fim.
+    void fill() {
+        promise_type& p = handle_.promise();
+        p.clear();
+        for (;;) {
+            if (!p.pending_.empty()) {
+                current_ = p.pending_.data();
+                last_ = current_ + p.pending_.size();
+                p.pending_ = {};
+                return;
+            }
+            if (handle_.done()) break;
+            handle_.resume();
+            if (p.size_ > 0) {
+                current_ = p.data();
+                last_ = current_ + p.size_;
+                return;
+            }
+        }
+        current_ = last_ = nullptr;
+        if (p.error_) std::rethrow_exception(std::exchange(p.error_, {}));
+    }
+
+    handle handle_;
+    T* current_ = nullptr;
+    T* last_ = nullptr;
+};
+
+}  // namespace coro
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <array>
 #include <boost/type_index.hpp>
 #include <concepts>
 #include <execution>
@@ -8,9 +9,14 @@
 #include <print>
 #include <random>
 #include <ranges>
+#include <span>
 #include <typeinfo>
 #include <vector>
 
+#include "generator.hpp"
+#include "prng.hpp"
+#include "simd_copy.hpp"
+
 namespace generators {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -29,6 +35,37 @@ auto stringify(Rng&& seq) {
     return "{" + std::string(std::begin(b), std::end(b)) + "}";
 }
 
+// produtores sob demanda: a sequência de Fibonacci não tem fim, e o
+// consumidor decide quantos elementos ler.
+coro::generator<long> fibonacci() {
+    for (long a = 0, b = 1;; b = std::exchange(a, b) + b) co_yield a;
+}
+
+// quadrados a partir de 'first'; fora da corrotina, o laço é otimizado como
+// o de qualquer função.
+void fill_squares(std::span<long> batch, long first) {
+    for (long& x : batch) {
+        x = first * first;
+        ++first;
+    }
+}
+
+// os quadrados são calculados num lote local e entregues de uma vez, com uma
+// retomada da corrotina a cada 'batch.size()' elementos.
+coro::batch_generator<long> squares() {
+    std::array<long, 64> batch;
+    for (long i = 0;; i += static_cast<long>(batch.size())) {
+        fill_squares(batch, i);
+        co_yield std::span(batch);
+    }
+}
+
+// o quadro da corrotina vem de 'arena'.
+coro::generator<int> countdown(std::allocator_arg_t, coro::frame_arena&,
+                               int n) {
+    while (n > 0) co_yield n--;
+}
+
 void main() {
     cout << endl;
     cout << "std::ranges::fill(v, 24):" << endl;
@@ -42,6 +79,15 @@ void main() {
     rg::fill(rg::subrange(v1.begin() + 2, v1.begin() + 4), 42);
     cout << "refilled 'v': " << stringify(v1) << endl;
 
+    cout << endl;
+    cout << "simd::fill(std::execution::par, v, 7):" << endl;
+    // acima de 'simd::streaming_threshold()' bytes, stores não temporais.
+    simd::fill(std::execution::par, v1, 7);
+    cout << "filled 'v': " << stringify(v1) << endl;
+    simd::fill_n(std::back_inserter(v1), 2, 9);
+    cout << "simd::fill_n(std::back_inserter(v), 2, 9): " << stringify(v1)
+         << endl;
+
     cout << endl;
     cout << "std::ranges::generate(v, [i=0]() mutable {return (++i) % 2;}):"
          << endl;
@@ -50,6 +96,19 @@ void main() {
     rg::generate(v2, [i = 0]() mutable { return (++i) % 2; });
     cout << "generated 'v': " << stringify(v2) << endl;
 
+    cout << endl;
+    cout << "prng::generate(std::execution::par, v, 7, "
+            "std::uniform_int_distribution(1, 6)):"
+         << endl;
+    // cada segmento de 'v' tem seu próprio gerador Philox, derivado da semente.
+    vector<int> v2b(10);
+    prng::generate(std::execution::par, v2b, 7,
+                   std::uniform_int_distribution(1, 6));
+    cout << "generated 'v': " << stringify(v2b) << endl;
+    vector<std::uint32_t> bits(4);
+    prng::fill_bits(bits, 7);
+    cout << "prng::fill_bits(v, 7): " << stringify(bits) << endl;
+
     cout << endl;
     cout << "std::ranges::fill_n(std::back_inserter(v), 5, 42):" << endl;
     vector<int> v3;
@@ -86,5 +145,37 @@ void main() {
     rg::transform(vw::iota(1, 10), vw::iota(5), std::back_inserter(v6),
                   std::plus<>{});
     cout << "transformed 'v': " << stringify(v6) << endl;
+
+    cout << endl;
+    cout << "rg::copy(fibonacci() | vw::take(10), std::back_inserter(v)):"
+         << endl;
+    vector<long> v7;
+    rg::copy(fibonacci() | vw::take(10), std::back_inserter(v7));
+    cout << "generated 'v': " << stringify(v7) << endl;
+    // a range temporária não é 'borrowed': o gerador precisa de um nome para
+    // que o iterador devolvido continue válido.
+    auto fib = fibonacci();
+    cout << "*rg::find_if(fib, [](long a) { return a > 1000; }): "
+         << *rg::find_if(fib, [](long a) { return a > 1000; }) << endl;
+
+    cout << endl;
+    cout << "rg::copy(squares() | vw::take(8), std::back_inserter(v)):"
+         << endl;
+    vector<long> v8;
+    rg::copy(squares() | vw::take(8), std::back_inserter(v8));
+    cout << "generated 'v': " << stringify(v8) << endl;
+
+    cout << endl;
+    cout << "rg::copy(countdown(std::allocator_arg, arena, 5), "
+            "std::back_inserter(v)):"
+         << endl;
+    coro::frame_arena arena;
+    vector<int> v9;
+    for (int i = 0; i < 2; ++i) {
+        rg::copy(countdown(std::allocator_arg, arena, 5),
+                 std::back_inserter(v9));
+    }
+    cout << "generated 'v' (duas vezes, com o mesmo quadro): "
+         << stringify(v9) << endl;
 };
 }  // namespace generators
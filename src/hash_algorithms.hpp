@@ -0,0 +1,520 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory_resource>
+#include <ranges>
+#include <type_traits>
+#include <vector>
+
+#include "flat_hash.hpp"
+#include "parallel.hpp"
+
+// Algoritmos sobre multiconjuntos que trocam comparações par a par por
+// contagem (histograma ou tabela hash), reduzindo o custo de O(n²) para O(n),
+// ou que dispensam a ordenação prévia exigida pelos algoritmos da stl.
+namespace hash_algorithms {
+
+namespace detail {
+template <typename V>
+concept hashable = requires(const V& v) {
+    { std::hash<V>{}(v) } -> std::convertible_to<std::size_t>;
+};
+
+template <typename It, typename Proj>
+using projected_value_t =
+    std::remove_cvref_t<std::indirect_result_t<Proj&, It>>;
+
+// abaixo deste tamanho o 'is_permutation' quadrático da stl é mais barato.
+inline constexpr std::size_t small_input = 32;
+
+// maior domínio [min, max] aceito pelo histograma (contagem direta).
+inline constexpr std::size_t counting_domain_limit = std::size_t{1} << 20;
+
+template <typename P, typename It1, typename It2, typename Proj1,
+          typename Proj2>
+bool counting_permutation(P&& policy, It1 f1, It2 f2, std::size_t n,
+                          Proj1& proj1, Proj2& proj2, bool& applicable) {
+    using V = projected_value_t<It1, Proj1>;
+    const std::size_t chunks = parallel::chunk_count(policy, n);
+
+    // domínio dos valores, calculado por bloco.
+    std::vector<std::pair<V, V>> bounds(chunks);
+    parallel::for_each_chunk(
+        policy, n, chunks, [&](std::size_t c, std::size_t b, std::size_t e) {
+            V lo = std::invoke(proj1, f1[b]);
+            V hi = lo;
+            for (std::size_t i = b; i < e; ++i) {
+                V x = std::invoke(proj1, f1[i]);
+                V y = std::invoke(proj2, f2[i]);
+                lo = std::min({lo, x, y});
+                hi = std::max({hi, x, y});
+            }
+            bounds[c] = {lo, hi};
+        });
+    V lo = bounds[0].first;
+    V hi = bounds[0].second;
+    for (auto& [l, h] : bounds) {
+        lo = std::min(lo, l);
+        hi = std::max(hi, h);
+    }
+    using U = std::make_unsigned_t<std::common_type_t<V, int>>;
+    const U span = static_cast<U>(hi) - static_cast<U>(lo);
+    if (span >= counting_domain_limit || span > 4 * n) {
+        applicable = false;
+        return false;
+    }
+    applicable = true;
+
+    // um histograma por bloco: +1 para 'r1' e -1 para 'r2'. Os blocos são
+    // limitados para que os histogramas somados não passem de '4 * n'
+    // contadores.
+    const std::size_t domain = static_cast<std::size_t>(span) + 1;
+    const std::size_t hists =
+        std::clamp<std::size_t>(4 * n / domain, 1, chunks);
+    std::vector<std::vector<std::ptrdiff_t>> hist(hists);
+    parallel::for_each_chunk(
+        policy, n, hists, [&](std::size_t c, std::size_t b, std::size_t e) {
+            hist[c].assign(domain, 0);
+            for (std::size_t i = b; i < e; ++i) {
+                ++hist[c][static_cast<U>(std::invoke(proj1, f1[i])) -
+                          static_cast<U>(lo)];
+                --hist[c][static_cast<U>(std::invoke(proj2, f2[i])) -
+                          static_cast<U>(lo)];
+            }
+        });
+    for (std::size_t c = 1; c < hists; ++c) {
+        std::transform(hist[0].begin(), hist[0].end(), hist[c].begin(),
+                       hist[0].begin(), std::plus<>{});
+    }
+    return std::all_of(hist[0].begin(), hist[0].end(),
+                       [](std::ptrdiff_t k) { return k == 0; });
+}
+
+// partição de um hash entre 'shards'; usa bits que não são os mesmos usados
+// pela tabela para escolher o grupo (bits baixos) e a etiqueta (bits altos).
+inline std::size_t shard_of(std::size_t h, std::size_t shards) {
+    return ((h >> 32) & 0xffffff) % shards;
+}
+
+// índices [0, n) agrupados por partição do hash, preservando a ordem
+// original dentro de cada partição: a partição 's' ocupa
+// 'order[begin[s], begin[s + 1])'. Os hashes, dados por 'hash_at(i)', ficam
+// em 'hashes'.
+template <typename Index>
+struct hash_partition {
+    std::vector<std::size_t> hashes;
+    std::vector<Index> order;
+    std::vector<std::size_t> begin;
+};
+
+template <typename Index, typename P, typename HashAt>
+hash_partition<Index> partition_by_hash(P&& policy, std::size_t n,
+                                        std::size_t shards, HashAt&& hash_at) {
+    const std::size_t chunks = parallel::chunk_count(policy, n);
+    hash_partition<Index> part{std::vector<std::size_t>(n),
+                               std::vector<Index>(n),
+                               std::vector<std::size_t>(shards + 1, 0)};
+    std::vector<std::size_t> offsets(chunks * shards, 0);
+    parallel::for_each_chunk(
+        policy, n, chunks, [&](std::size_t c, std::size_t b, std::size_t e) {
+            for (std::size_t i = b; i < e; ++i) {
+                part.hashes[i] = hash_at(i);
+                ++offsets[c * shards + shard_of(part.hashes[i], shards)];
+            }
+        });
+
+    // prefixo exclusivo na ordem (partição, bloco).
+    std::size_t total = 0;
+    for (std::size_t s = 0; s < shards; ++s) {
+        part.begin[s] = total;
+        for (std::size_t c = 0; c < chunks; ++c) {
+            total += std::exchange(offsets[c * shards + s], total);
+        }
+    }
+    part.begin[shards] = total;
+
+    parallel::for_each_chunk(
+        policy, n, chunks, [&](std::size_t c, std::size_t b, std::size_t e) {
+            for (std::size_t i = b; i < e; ++i) {
+                const std::size_t s = shard_of(part.hashes[i], shards);
+                part.order[offsets[c * shards + s]++] = static_cast<Index>(i);
+            }
+        });
+    return part;
+}
+
+// contagem numa tabela de endereçamento aberto, particionada pelo hash: uma
+// passada distribui os índices das duas entradas pelas partições, e cada
+// partição conta só as suas chaves, numa tabela própria alocada numa arena,
+// sem sincronização entre as threads. Partições de tamanhos diferentes nas
+// duas entradas já decidem o resultado.
+template <typename Index, typename P, typename It1, typename It2,
+          typename Proj1, typename Proj2>
+bool hash_permutation(P&& policy, It1 f1, It2 f2, std::size_t n, Proj1& proj1,
+                      Proj2& proj2) {
+    using V = projected_value_t<It1, Proj1>;
+    flat_hash::hash<V> hash;
+    const std::size_t shards = parallel::chunk_count(policy, n);
+    const auto p1 = partition_by_hash<Index>(
+        policy, n, shards,
+        [&](std::size_t i) { return hash(std::invoke(proj1, f1[i])); });
+    const auto p2 = partition_by_hash<Index>(
+        policy, n, shards,
+        [&](std::size_t i) { return hash(std::invoke(proj2, f2[i])); });
+    if (p1.begin != p2.begin) return false;
+
+    std::vector<char> ok(shards, 1);
+    parallel::for_each_chunk(
+        policy, shards, shards, [&](std::size_t s, std::size_t, std::size_t) {
+            const std::size_t b = p1.begin[s];
+            const std::size_t e = p1.begin[s + 1];
+            std::pmr::monotonic_buffer_resource arena;
+            // uma entrada por chave distinta: a sua primeira posição em 'r1'
+            // e quantas ocorrências ainda faltam encontrar em 'r2'.
+            std::pmr::vector<Index> first(&arena);
+            std::pmr::vector<std::ptrdiff_t> counts(&arena);
+            flat_hash::detail::index_table<Index> table(&arena);
+            table.rehash(e - b, 0, [](std::size_t) { return 0; });
+            for (std::size_t k = b; k < e; ++k) {
+                const Index i = p1.order[k];
+                auto&& key = std::invoke(proj1, f1[i]);
+                const auto [d, inserted] = table.find_or_insert(
+                    p1.hashes[i],
+                    [&](Index d) {
+                        return std::invoke(proj1, f1[first[d]]) == key;
+                    },
+                    static_cast<Index>(first.size()));
+                if (inserted) {
+                    first.push_back(i);
+                    counts.push_back(1);
+                } else {
+                    ++counts[d];
+                }
+            }
+            // com o mesmo número de elementos dos dois lados, nenhuma
+            // contagem negativa implica todas zeradas.
+            for (std::size_t k = b; k < e; ++k) {
+                const Index i = p2.order[k];
+                auto&& key = std::invoke(proj2, f2[i]);
+                const Index* d = table.find(p2.hashes[i], [&](Index d) {
+                    return std::invoke(proj1, f1[first[d]]) == key;
+                });
+                if (!d || counts[*d]-- == 0) {
+                    ok[s] = 0;
+                    return;
+                }
+            }
+        });
+    return std::all_of(ok.begin(), ok.end(), [](char c) { return c != 0; });
+}
+
+template <typename P, typename It1, typename It2, typename Proj1,
+          typename Proj2>
+bool sort_permutation(P&& policy, It1 f1, It2 f2, std::size_t n, Proj1& proj1,
+                      Proj2& proj2) {
+    using V = projected_value_t<It1, Proj1>;
+    std::vector<V> a;
+    std::vector<V> b;
+    a.reserve(n);
+    b.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        a.push_back(std::invoke(proj1, f1[i]));
+        b.push_back(std::invoke(proj2, f2[i]));
+    }
+    std::sort(policy, a.begin(), a.end());
+    std::sort(policy, b.begin(), b.end());
+    return std::equal(policy, a.begin(), a.end(), b.begin());
+}
+}  // namespace detail
+
+// 'is_permutation' que escolhe a estratégia pelo tipo e tamanho da entrada:
+// - inteiros de domínio pequeno: histograma (contagem direta), O(n);
+// - demais números: ordenação das cópias e comparação, O(n log n);
+// - outros tipos com 'std::hash': contagem em tabela hash, O(n) esperado;
+// - tipos apenas ordenáveis: ordenação das cópias e comparação, O(n log n);
+// - demais casos (ou predicado próprio): 'std::ranges::is_permutation'.
+// Aceita projeções e, opcionalmente, uma política de execução.
+struct is_permutation_fn {
+    template <parallel::execution_policy P, std::ranges::forward_range R1,
+              std::ranges::forward_range R2,
+              typename Pred = std::ranges::equal_to,
+              typename Proj1 = std::identity, typename Proj2 = std::identity>
+        requires std::indirectly_comparable<std::ranges::iterator_t<R1>,
+                                            std::ranges::iterator_t<R2>, Pred,
+                                            Proj1, Proj2>
+    bool operator()(P&& policy, R1&& r1, R2&& r2, Pred pred = {},
+                    Proj1 proj1 = {}, Proj2 proj2 = {}) const {
+        using It1 = std::ranges::iterator_t<R1>;
+        using It2 = std::ranges::iterator_t<R2>;
+        using V1 = detail::projected_value_t<It1, Proj1>;
+        using V2 = detail::projected_value_t<It2, Proj2>;
+        if constexpr (std::ranges::random_access_range<R1> &&
+                      std::ranges::random_access_range<R2> &&
+                      std::ranges::sized_range<R1> &&
+                      std::ranges::sized_range<R2> &&
+                      std::same_as<Pred, std::ranges::equal_to> &&
+                      std::same_as<V1, V2>) {
+            using V = V1;
+            const auto n = static_cast<std::size_t>(std::ranges::size(r1));
+            if (n != static_cast<std::size_t>(std::ranges::size(r2))) {
+                return false;
+            }
+            // o prefixo em comum não precisa ser contado.
+            auto [f1, f2] = std::ranges::mismatch(r1, r2, pred, proj1, proj2);
+            const auto k =
+                n - static_cast<std::size_t>(f1 - std::ranges::begin(r1));
+            if (k > detail::small_input) {
+                if constexpr (std::integral<V> && !std::same_as<V, bool>) {
+                    bool applicable = false;
+                    bool res = detail::counting_permutation(
+                        policy, f1, f2, k, proj1, proj2, applicable);
+                    if (applicable) return res;
+                }
+                if constexpr (std::is_arithmetic_v<V>) {
+                    // cópias de números ordenam mais rápido do que qualquer
+                    // tabela hash as conta.
+                    return detail::sort_permutation(policy, f1, f2, k, proj1,
+                                                    proj2);
+                } else if constexpr (detail::hashable<V> &&
+                                     std::equality_comparable<V>) {
+                    if (k <= std::numeric_limits<std::uint32_t>::max()) {
+                        return detail::hash_permutation<std::uint32_t>(
+                            policy, f1, f2, k, proj1, proj2);
+                    }
+                    return detail::hash_permutation<std::uint64_t>(
+                        policy, f1, f2, k, proj1, proj2);
+                } else if constexpr (std::totally_ordered<V> &&
+                                     std::copyable<V>) {
+                    return detail::sort_permutation(policy, f1, f2, k, proj1,
+                                                    proj2);
+                }
+            }
+            return std::ranges::is_permutation(
+                std::ranges::subrange(f1, std::ranges::end(r1)),
+                std::ranges::subrange(f2, std::ranges::end(r2)), pred, proj1,
+                proj2);
+        } else {
+            return std::ranges::is_permutation(r1, r2, std::move(pred),
+                                               std::move(proj1),
+                                               std::move(proj2));
+        }
+    }
+
+    template <std::ranges::forward_range R1, std::ranges::forward_range R2,
+              typename Pred = std::ranges::equal_to,
+              typename Proj1 = std::identity, typename Proj2 = std::identity>
+        requires std::indirectly_comparable<std::ranges::iterator_t<R1>,
+                                            std::ranges::iterator_t<R2>, Pred,
+                                            Proj1, Proj2>
+    bool operator()(R1&& r1, R2&& r2, Pred pred = {}, Proj1 proj1 = {},
+                    Proj2 proj2 = {}) const {
+        return (*this)(std::execution::seq, r1, r2, std::move(pred),
+                       std::move(proj1), std::move(proj2));
+    }
+};
+inline constexpr is_permutation_fn is_permutation{};
+
+namespace detail {
+
+// marca a primeira ocorrência de cada chave em [first, first + n).
+// Em paralelo, os índices são distribuídos por partição do hash (preservando
+// a ordem original dentro de cada partição) e cada partição é deduplicada por
+// uma tabela própria, alocada numa arena, sem sincronização entre threads.
+template <typename Index, typename P, typename It, typename Proj>
+std::vector<char> mark_first_occurrences(P&& policy, It first, std::size_t n,
+                                         Proj& proj) {
+    using V = projected_value_t<It, Proj>;
+    flat_hash::hash<V> hash;
+    const std::size_t shards = parallel::chunk_count(policy, n);
+    const auto [hashes, order, shard_begin] = partition_by_hash<Index>(
+        policy, n, shards,
+        [&](std::size_t i) { return hash(std::invoke(proj, first[i])); });
+
+    std::vector<char> keep(n, 0);
+    parallel::for_each_chunk(
+        policy, shards, shards, [&](std::size_t s, std::size_t, std::size_t) {
+            const std::size_t b = shard_begin[s];
+            const std::size_t e = shard_begin[s + 1];
+            std::pmr::monotonic_buffer_resource arena;
+            flat_hash::detail::index_table<Index> table(&arena);
+            table.rehash(e - b, 0, [](std::size_t) { return 0; });
+            for (std::size_t k = b; k < e; ++k) {
+                const Index i = order[k];
+                auto&& key = std::invoke(proj, first[i]);
+                keep[i] = table
+                              .find_or_insert(
+                                  hashes[i],
+                                  [&](Index j) {
+                                      return std::invoke(proj, first[j]) == key;
+                                  },
+                                  i)
+                              .second;
+            }
+        });
+    return keep;
+}
+
+// versão sequencial, em uma única passada: as chaves mantidas são movidas
+// para o início e a tabela guarda as suas posições finais, de forma que
+// nenhuma chave é copiada.
+template <typename Index, typename It, typename Proj>
+std::size_t dedup_in_place(It first, std::size_t n, Proj& proj) {
+    using V = projected_value_t<It, Proj>;
+    flat_hash::hash<V> hash;
+    std::pmr::monotonic_buffer_resource arena;
+    flat_hash::detail::index_table<Index> table(&arena);
+    // as chaves mantidas ocupam [0, w), então a tabela pode crescer sob
+    // demanda em vez de ser dimensionada para 'n' chaves distintas.
+    auto hash_at = [&](std::size_t j) {
+        return hash(std::invoke(proj, first[j]));
+    };
+    table.rehash(std::min<std::size_t>(n, 1024), 0, hash_at);
+    std::size_t w = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (table.growth_left() == 0) table.rehash(2 * w, w, hash_at);
+        auto&& key = std::invoke(proj, first[i]);
+        const bool inserted =
+            table
+                .find_or_insert(
+                    hash(key),
+                    [&](Index j) { return std::invoke(proj, first[j]) == key; },
+                    static_cast<Index>(w))
+                .second;
+        if (inserted) {
+            if (w != i) first[w] = std::ranges::iter_move(first + i);
+            ++w;
+        }
+    }
+    return w;
+}
+
+template <typename P, typename It, typename Proj>
+std::vector<char> mark_first(P&& policy, It first, std::size_t n, Proj& proj) {
+    if (n <= std::numeric_limits<std::uint32_t>::max()) {
+        return mark_first_occurrences<std::uint32_t>(policy, first, n, proj);
+    }
+    return mark_first_occurrences<std::uint64_t>(policy, first, n, proj);
+}
+
+template <typename R, typename Proj>
+concept dedup_projection =
+    std::ranges::input_range<R> &&
+    hashable<projected_value_t<std::ranges::iterator_t<R>, Proj>> &&
+    std::equality_comparable<
+        projected_value_t<std::ranges::iterator_t<R>, Proj>>;
+}  // namespace detail
+
+// 'dedup' remove as repetições (segundo a projeção 'proj') mantendo a
+// primeira ocorrência de cada chave e a ordem original, sem exigir que a
+// range esteja ordenada. Como 'std::ranges::unique', retorna a subrange
+// [novo fim, fim) a ser apagada pelo chamador.
+struct dedup_fn {
+    template <parallel::execution_policy P, std::ranges::forward_range R,
+              typename Proj = std::identity>
+        requires std::permutable<std::ranges::iterator_t<R>> &&
+                 detail::dedup_projection<R, Proj>
+    std::ranges::borrowed_subrange_t<R> operator()(P&& policy, R&& r,
+                                                   Proj proj = {}) const {
+        using V =
+            detail::projected_value_t<std::ranges::iterator_t<R>, Proj>;
+        auto first = std::ranges::begin(r);
+        auto last = std::ranges::end(r);
+        if constexpr (std::ranges::random_access_range<R> &&
+                      std::ranges::sized_range<R>) {
+            const auto n = static_cast<std::size_t>(std::ranges::size(r));
+            std::size_t w = 0;
+            if (parallel::chunk_count(policy, n) > 1) {
+                auto keep = detail::mark_first(policy, first, n, proj);
+                for (std::size_t i = 0; i < n; ++i) {
+                    if (!keep[i]) continue;
+                    if (w != i) first[w] = std::ranges::iter_move(first + i);
+                    ++w;
+                }
+            } else if (n <= std::numeric_limits<std::uint32_t>::max()) {
+                w = detail::dedup_in_place<std::uint32_t>(first, n, proj);
+            } else {
+                w = detail::dedup_in_place<std::uint64_t>(first, n, proj);
+            }
+            return {first + w, last};
+        } else {
+            std::pmr::monotonic_buffer_resource arena;
+            flat_hash::set<V> seen(&arena);
+            auto out = first;
+            for (; first != last; ++first) {
+                if (seen.insert(std::invoke(proj, *first)).second) {
+                    if (out != first) *out = std::ranges::iter_move(first);
+                    ++out;
+                }
+            }
+            return {out, last};
+        }
+    }
+
+    template <std::ranges::forward_range R, typename Proj = std::identity>
+        requires std::permutable<std::ranges::iterator_t<R>> &&
+                 detail::dedup_projection<R, Proj>
+    std::ranges::borrowed_subrange_t<R> operator()(R&& r,
+                                                   Proj proj = {}) const {
+        return (*this)(std::execution::seq, std::forward<R>(r),
+                       std::move(proj));
+    }
+};
+inline constexpr dedup_fn dedup{};
+
+// 'dedup_copy' copia para 'out' a primeira ocorrência de cada chave, na
+// ordem original.
+struct dedup_copy_fn {
+    template <parallel::execution_policy P, std::ranges::input_range R,
+              std::weakly_incrementable O, typename Proj = std::identity>
+        requires std::indirectly_copyable<std::ranges::iterator_t<R>, O> &&
+                 detail::dedup_projection<R, Proj>
+    std::ranges::unique_copy_result<std::ranges::borrowed_iterator_t<R>, O>
+    operator()(P&& policy, R&& r, O out, Proj proj = {}) const {
+        using V =
+            detail::projected_value_t<std::ranges::iterator_t<R>, Proj>;
+        auto first = std::ranges::begin(r);
+        auto last = std::ranges::end(r);
+        if constexpr (std::ranges::random_access_range<R> &&
+                      std::ranges::sized_range<R>) {
+            const auto n = static_cast<std::size_t>(std::ranges::size(r));
+            auto keep = detail::mark_first(policy, first, n, proj);
+            for (std::size_t i = 0; i < n; ++i) {
+                if (keep[i]) {
+                    *out = first[i];
+                    ++out;
+                }
+            }
+            return {first + n, std::move(out)};
+        } else {
+            std::pmr::monotonic_buffer_resource arena;
+            flat_hash::set<V> seen(&arena);
+            for (; first != last; ++first) {
+                if (seen.insert(std::invoke(proj, *first)).second) {
+                    *out = *first;
+                    ++out;
+                }
+            }
+            return {std::move(first), std::move(out)};
+        }
+    }
+
+    template <std::ranges::input_range R, std::weakly_incrementable O,
+              typename Proj = std::identity>
+        requires std::indirectly_copyable<std::ranges::iterator_t<R>, O> &&
+                 detail::dedup_projection<R, Proj>
+    std::ranges::unique_copy_result<std::ranges::borrowed_iterator_t<R>, O>
+    operator()(R&& r, O out, Proj proj = {}) const {
+        return (*this)(std::execution::seq, std::forward<R>(r), std::move(out),
+                       std::move(proj));
+    }
+};
+inline constexpr dedup_copy_fn dedup_copy{};
+
+}  // namespace hash_algorithms
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <utility>
+#include <vector>
+
+// Ordenação incremental ("lazy quicksort", Paredes e Navarro, 2006): a range é
+// ordenada no próprio lugar à medida que os elementos são consumidos, em ordem
+// crescente, como uma range de entrada.
+// Uma pilha guarda as posições dos pivôs já colocados no lugar definitivo;
+// para entregar o próximo elemento basta particionar o segmento entre a parte
+// já ordenada e o pivô do topo até que o menor elemento esteja no lugar. Os
+// primeiros 'k' elementos custam O(n + k log k) no total (O(log n) amortizado
+// por elemento), e o estado das partições é mantido entre uma página e outra,
+// ao contrário de chamar 'partial_sort' de novo a cada página.
+// Quando a profundidade das partições passa de 2 log2(n) (pivôs ruins), o
+// segmento é ordenado inteiro de uma vez com 'std::ranges::sort', como no
+// introsort, o que limita o pior caso a O(n log n) no total, qualquer que
+// seja o tamanho das páginas pedidas (inclusive de um elemento por vez).
+namespace lazy_sort {
+
+// ordena incrementalmente [first, last) segundo 'comp' e 'proj'; os elementos
+// ainda não consumidos são permutados, mas não há cópias.
+template <std::random_access_iterator I, std::sentinel_for<I> S,
+          typename Comp = std::ranges::less, typename Proj = std::identity>
+    requires std::sortable<I, Comp, Proj>
+class sorter {
+   public:
+    class iterator;
+
+    sorter(I first, S last, Comp comp = {}, Proj proj = {})
+        : first_(first),
+          size_(static_cast<std::size_t>(std::ranges::distance(first, last))),
+          comp_(std::move(comp)),
+          proj_(std::move(proj)) {
+        if (size_ > 0) {
+            bounds_.push_back({size_, 2 * std::bit_width(size_)});
+        }
+    }
+
+    // garante que os 'n' primeiros elementos estão ordenados e no lugar
+    // definitivo; devolve o iterador para o fim dessa parte.
+    I sort_until(std::size_t n) {
+        n = std::min(n, size_);
+        while (sorted_ < n) step();
+        return first_ + static_cast<std::ptrdiff_t>(n);
+    }
+
+    // página [offset, offset + count) da sequência ordenada; as páginas
+    // anteriores continuam ordenadas e válidas.
+    std::ranges::subrange<I> page(std::size_t offset, std::size_t count) {
+        offset = std::min(offset, size_);
+        const I last = sort_until(offset + std::min(count, size_ - offset));
+        return {first_ + static_cast<std::ptrdiff_t>(offset), last};
+    }
+
+    std::iter_reference_t<I> operator[](std::size_t i) {
+        sort_until(i + 1);
+        return first_[static_cast<std::ptrdiff_t>(i)];
+    }
+
+    iterator begin() { return iterator(this, 0); }
+    std::default_sentinel_t end() const { return std::default_sentinel; }
+
+    std::size_t size() const { return size_; }
+    std::size_t sorted() const { return sorted_; }
+
+   private:
+    // fim de um segmento ainda não ordenado, que começa em 'sorted_', e
+    // quantas partições ele ainda pode sofrer antes do recurso ao heap.
+    struct bound {
+        std::size_t end;
+        std::size_t depth;
+    };
+
+    static constexpr std::size_t small = 32;
+
+    decltype(auto) key(std::size_t i) {
+        return std::invoke(proj_, first_[static_cast<std::ptrdiff_t>(i)]);
+    }
+    bool less(std::size_t a, std::size_t b) {
+        return std::invoke(comp_, key(a), key(b));
+    }
+
+    // avança 'sorted_' em pelo menos um elemento, particionando só o segmento
+    // que contém o próximo.
+    void step() {
+        auto [hi, depth] = bounds_.back();
+        const std::size_t lo = sorted_;
+        if (hi == lo) {
+            bounds_.pop_back();
+            return;
+        }
+        const auto at = [&](std::size_t i) {
+            return first_ + static_cast<std::ptrdiff_t>(i);
+        };
+        if (hi - lo <= small) {
+            std::ranges::sort(at(lo), at(hi), comp_, proj_);
+            sorted_ = hi;
+            bounds_.pop_back();
+            return;
+        }
+        if (depth == 0) {
+            // pivôs ruins demais: ordena o segmento inteiro de uma vez. Um
+            // 'partial_sort' só do que foi pedido refaria o heap a cada
+            // chamada, o que fica quadrático pedindo um elemento por vez.
+            std::ranges::sort(at(lo), at(hi), comp_, proj_);
+            sorted_ = hi;
+            bounds_.pop_back();
+            return;
+        }
+        // mediana de três, levada para o início do segmento.
+        std::size_t a = lo, b = lo + (hi - lo) / 2, c = hi - 1;
+        if (less(b, a)) std::swap(a, b);
+        if (less(c, b)) b = less(c, a) ? a : c;
+        std::ranges::iter_swap(at(lo), at(b));
+        // partição em três: menores, iguais ao pivô e maiores; os iguais já
+        // estão no lugar definitivo, o que evita o caso quadrático quando há
+        // muitas repetições.
+        auto&& pivot = key(lo);
+        const auto m1 = std::ranges::partition(
+            at(lo + 1), at(hi),
+            [&](auto&& x) { return std::invoke(comp_, x, pivot); }, proj_);
+        const auto m2 = std::ranges::partition(
+            m1.begin(), at(hi),
+            [&](auto&& x) { return !std::invoke(comp_, pivot, x); }, proj_);
+        // o pivô vai para o fim da faixa dos menores.
+        const I eq = std::prev(m1.begin());
+        std::ranges::iter_swap(at(lo), eq);
+        const auto e1 = static_cast<std::size_t>(eq - first_);
+        const auto e2 = static_cast<std::size_t>(m2.begin() - first_);
+        // o segmento do topo passa a ser só a faixa dos maiores, que também
+        // gasta uma partição do seu limite.
+        bounds_.back().depth = depth - 1;
+        if (e2 < hi) bounds_.push_back({e2, depth - 1});
+        if (e1 == lo) {
+            sorted_ = e2;
+        } else {
+            // a faixa dos iguais é resolvida numa única passada mais tarde.
+            bounds_.push_back({e1, depth - 1});
+        }
+    }
+
+    I first_;
+    std::size_t size_;
+    Comp comp_;
+    Proj proj_;
+    std::size_t sorted_ = 0;
+    std::vector<bound> bounds_;
+};
+
+// iterador de entrada sobre a sequência ordenada: cada elemento só é colocado
+// no lugar quando desreferenciado.
+template <std::random_access_iterator I, std::sentinel_for<I> S,
+          typename Comp, typename Proj>
+    requires std::sortable<I, Comp, Proj>
+class sorter<I, S, Comp, Proj>::iterator {
+   public:
+    using value_type = std::iter_value_t<I>;
+    using difference_type = std::ptrdiff_t;
+
+    iterator() = default;
+
+    std::iter_reference_t<I> operator*() const { return (*owner_)[pos_]; }
+    iterator& operator++() {
+        ++pos_;
+        return *this;
+    }
+    void operator++(int) { ++pos_; }
+
+    friend bool operator==(const iterator& it, std::default_sentinel_t) {
+        return it.pos_ == it.owner_->size();
+    }
+
+   private:
+    friend sorter;
+    iterator(sorter* owner, std::size_t pos) : owner_(owner), pos_(pos) {}
+
+    sorter* owner_ = nullptr;
+    std::size_t pos_ = 0;
+};
+
+// 'lazy_sort::sorted(v)' ordena 'v' no lugar, sob demanda.
+struct sorted_fn {
+    template <std::ranges::random_access_range R,
+              typename Comp = std::ranges::less, typename Proj = std::identity>
+        requires std::ranges::borrowed_range<R> &&
+                 std::sortable<std::ranges::iterator_t<R>, Comp, Proj>
+    auto operator()(R&& r, Comp comp = {}, Proj proj = {}) const {
+        return sorter<std::ranges::iterator_t<R>, std::ranges::sentinel_t<R>,
+                      Comp, Proj>(std::ranges::begin(r), std::ranges::end(r),
+                                  std::move(comp), std::move(proj));
+    }
+};
+
+inline constexpr sorted_fn sorted{};
+
+}  // namespace lazy_sort
@@ -8,9 +8,12 @@
 #include <print>
 #include <random>
 #include <ranges>
+#include <span>
 #include <typeinfo>
 #include <vector>
 
+#include "fused.hpp"
+
 namespace left_folds {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -69,6 +72,23 @@ void main() {
     cout << "'v': " << stringify(v4) << endl;
     cout << "sum of differences: " << sum4 << endl;
 
+    cout << endl;
+    cout << "fused::sum(fused::abs(a - b)) e fused::sum(x * y + 2.0 * z)"
+         << endl;
+    vector<double> x7{6, 4, 3, 7, 2, 1};
+    vector<double> y7{1, 2, 3, 4, 5, 6};
+    vector<double> z7{0.5, 1.5, 2.5, 3.5, 4.5, 5.5};
+    // as mesmas diferenças adjacentes do exemplo anterior, sem temporários.
+    auto a7 = fused::col(std::span(x7).first(x7.size() - 1));
+    auto b7 = fused::col(std::span(x7).subspan(1));
+    cout << "sum of differences: " << fused::sum(fused::abs(a7 - b7)) << endl;
+    // três colunas lidas numa única passada (também com 'std::execution::par').
+    auto x = fused::col(x7);
+    auto y = fused::col(y7);
+    auto z = fused::col(z7);
+    cout << "weighted sum: "
+         << fused::sum(std::execution::par, x * y + 2.0 * z) << endl;
+
     cout << endl;
     cout << "" << endl;
     vector<int> v5(6);
@@ -10,6 +10,8 @@
 #include <typeinfo>
 #include <vector>
 
+#include "hash_algorithms.hpp"
+
 namespace linear_operations {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -145,5 +147,36 @@ void main() {
     cout << "'v': " << stringify(v6) << endl;
     std::ranges::unique_copy(v6, std::back_inserter(out6));
     cout << "'out': " << stringify(out6) << endl;
+
+    cout << endl;
+    // 'unique' e 'unique_copy' removem apenas repetições adjacentes e exigem
+    // uma ordenação prévia (O(n log n)), que perde a ordem original. As
+    // versões de 'hash_algorithms' usam uma tabela hash e mantêm a primeira
+    // ocorrência de cada elemento, na ordem original.
+    cout << "hash_algorithms::dedup(v):" << endl;
+    vector<int> v7{1, 1, 2, 2, 3, 4, 5, 6, 6, 6};
+    std::ranges::shuffle(v7, std::random_device{});
+    cout << "'v': " << stringify(v7) << endl;
+    auto [first7, last7] = hash_algorithms::dedup(v7);
+    v7.erase(first7, last7);
+    cout << "deduplicated 'v': " << stringify(v7) << endl;
+
+    cout << endl;
+    cout << "hash_algorithms::dedup_copy(std::execution::par, v, "
+            "std::back_inserter(out), &LabeledValue::label):"
+         << endl;
+    vector<LabeledValue> v8{
+        {1, "primeiro"}, {2, "segundo"}, {3, "primeiro"},
+        {4, "terceiro"}, {5, "segundo"},
+    };
+    vector<LabeledValue> out8;
+    hash_algorithms::dedup_copy(std::execution::par, v8,
+                                std::back_inserter(out8), &LabeledValue::label);
+    cout << "'v': " << stringify(v8, [](const LabeledValue& l) {
+        return "{" + std::to_string(l.value) + ", " + l.label + "}";
+    }) << endl;
+    cout << "'out': " << stringify(out8, [](const LabeledValue& l) {
+        return "{" + std::to_string(l.value) + ", " + l.label + "}";
+    }) << endl;
 };
 }  // namespace linear_operations
@@ -0,0 +1,367 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Views que guardam os elementos calculados por uma pipeline cara, já que
+// 'std::views::transform' chama a sua função a cada desreferência:
+// - 'cache_latest' guarda apenas o último elemento desreferenciado (como a
+//   'std::views::cache_latest' do C++26). Serve para pipelines de uma
+//   passada em que o mesmo elemento é lido mais de uma vez, como um
+//   'std::views::filter' depois de um 'transform' (o predicado e o laço
+//   desreferenciam o mesmo iterador). É uma range de entrada.
+// - 'memoize' materializa a range, sob demanda: cada elemento é calculado no
+//   máximo uma vez, na primeira leitura, e as leituras seguintes (outra
+//   passada, ou as comparações de uma ordenação) devolvem a cópia guardada. É
+//   de acesso aleatório, mas exige uma origem de acesso aleatório e com
+//   tamanho.
+// Como as views da stl, ambas ficam desatualizadas se a origem mudar, mas a
+// invalidação é explícita: 'invalidate()' descarta os valores guardados e
+// 'memoize' detecta mudanças no tamanho da origem ('stale()'), lançando
+// 'memo::stale_cache' em vez de devolver valores antigos ao ser percorrida.
+//
+//     auto keys = v | std::views::transform(expensive) | memo::memoize;
+//     std::ranges::sort(ids, {}, [&](std::size_t i) { return keys[i]; });
+namespace memo {
+
+// uso de uma 'memoize' cuja origem mudou de tamanho desde o último
+// 'invalidate()'.
+class stale_cache : public std::logic_error {
+   public:
+    using std::logic_error::logic_error;
+};
+
+namespace detail {
+
+// 'std::optional' que não é copiado junto com a view, como o cache de
+// 'std::views::filter': a cópia de uma view começa sem cache.
+template <typename T>
+struct latest : std::optional<T> {
+    latest() = default;
+    latest(const latest&) noexcept {}
+    latest(latest&& other) noexcept { other.reset(); }
+    latest& operator=(const latest& other) noexcept {
+        if (this != &other) this->reset();
+        return *this;
+    }
+    latest& operator=(latest&& other) noexcept {
+        this->reset();
+        other.reset();
+        return *this;
+    }
+};
+
+// adaptadores que não recebem argumentos: 'r | f' é 'f(r)'.
+template <typename F>
+struct closure {
+    template <std::ranges::viewable_range R>
+        requires std::invocable<const F&, R>
+    friend auto operator|(R&& r, const F& f) {
+        return f(std::forward<R>(r));
+    }
+};
+
+}  // namespace detail
+
+template <std::ranges::input_range V>
+    requires std::ranges::view<V>
+class cache_latest_view
+    : public std::ranges::view_interface<cache_latest_view<V>> {
+    using reference = std::ranges::range_reference_t<V>;
+    // referências são guardadas como ponteiros, e os demais resultados por
+    // valor.
+    using cached = std::conditional_t<std::is_reference_v<reference>,
+                                      std::add_pointer_t<reference>, reference>;
+
+   public:
+    class iterator;
+    class sentinel;
+
+    cache_latest_view() = default;
+    explicit cache_latest_view(V base) : base_(std::move(base)) {}
+
+    V base() const& { return base_; }
+    V base() && { return std::move(base_); }
+
+    iterator begin() {
+        latest_.reset();
+        return iterator(this, std::ranges::begin(base_));
+    }
+    sentinel end() { return sentinel(std::ranges::end(base_)); }
+
+    auto size()
+        requires std::ranges::sized_range<V>
+    {
+        return std::ranges::size(base_);
+    }
+
+    // descarta o elemento guardado: a próxima desreferência lê a origem de
+    // novo (por exemplo, depois de o elemento atual ter sido alterado).
+    void invalidate() noexcept { latest_.reset(); }
+
+   private:
+    std::remove_reference_t<reference>& get(
+        const std::ranges::iterator_t<V>& it) {
+        if (!latest_) {
+            if constexpr (std::is_reference_v<reference>) {
+                reference x = *it;
+                latest_.emplace(std::addressof(x));
+            } else {
+                latest_.emplace(*it);
+            }
+        }
+        if constexpr (std::is_reference_v<reference>) {
+            return **latest_;
+        } else {
+            return *latest_;
+        }
+    }
+
+    V base_ = V();
+    detail::latest<cached> latest_;
+};
+
+template <std::ranges::input_range V>
+    requires std::ranges::view<V>
+class cache_latest_view<V>::iterator {
+   public:
+    using value_type = std::ranges::range_value_t<V>;
+    using difference_type = std::ranges::range_difference_t<V>;
+
+    iterator() = default;
+
+    const std::ranges::iterator_t<V>& base() const& noexcept {
+        return current_;
+    }
+
+    std::remove_reference_t<reference>& operator*() const {
+        return parent_->get(current_);
+    }
+    iterator& operator++() {
+        ++current_;
+        parent_->latest_.reset();
+        return *this;
+    }
+    void operator++(int) { ++*this; }
+
+    friend std::ranges::range_rvalue_reference_t<V> iter_move(
+        const iterator& it) {
+        if constexpr (std::is_reference_v<reference>) {
+            return std::ranges::iter_move(it.current_);
+        } else {
+            return std::move(*it);
+        }
+    }
+
+   private:
+    friend cache_latest_view;
+    iterator(cache_latest_view* parent, std::ranges::iterator_t<V> current)
+        : parent_(parent), current_(std::move(current)) {}
+
+    cache_latest_view* parent_ = nullptr;
+    std::ranges::iterator_t<V> current_ = std::ranges::iterator_t<V>();
+};
+
+template <std::ranges::input_range V>
+    requires std::ranges::view<V>
+class cache_latest_view<V>::sentinel {
+   public:
+    sentinel() = default;
+
+    friend bool operator==(const iterator& it, const sentinel& s) {
+        return it.base() == s.end_;
+    }
+
+   private:
+    friend cache_latest_view;
+    explicit sentinel(std::ranges::sentinel_t<V> end) : end_(std::move(end)) {}
+
+    std::ranges::sentinel_t<V> end_ = std::ranges::sentinel_t<V>();
+};
+
+template <typename R>
+cache_latest_view(R&&) -> cache_latest_view<std::views::all_t<R>>;
+
+template <std::ranges::random_access_range V>
+    requires std::ranges::view<V> && std::ranges::sized_range<V>
+class memoize_view : public std::ranges::view_interface<memoize_view<V>> {
+   public:
+    using value_type = std::remove_cvref_t<std::ranges::range_reference_t<V>>;
+    class iterator;
+
+    memoize_view() = default;
+    explicit memoize_view(V base)
+        : base_(std::move(base)),
+          values_(static_cast<std::size_t>(std::ranges::size(base_))) {}
+
+    // os valores guardados não são copiados: a view só pode ser movida.
+    memoize_view(const memoize_view&) = delete;
+    memoize_view& operator=(const memoize_view&) = delete;
+    memoize_view(memoize_view&&) = default;
+    memoize_view& operator=(memoize_view&&) = default;
+
+    // lançam 'stale_cache' se a origem mudou de tamanho; os iteradores, como
+    // 'operator[]', não fazem essa verificação.
+    iterator begin() {
+        check();
+        return iterator(this, 0);
+    }
+    iterator end() {
+        check();
+        return iterator(this, values_.size());
+    }
+
+    std::size_t size() const noexcept { return values_.size(); }
+
+    // elemento 'i', calculado na primeira leitura.
+    const value_type& operator[](std::size_t i) {
+        std::optional<value_type>& x = values_[i];
+        if (!x) {
+            x.emplace(std::ranges::begin(base_)[static_cast<diff>(i)]);
+            ++computed_;
+        }
+        return *x;
+    }
+
+    // quantos elementos já foram calculados.
+    std::size_t computed() const noexcept { return computed_; }
+
+    // a origem mudou de tamanho desde a construção ou o último
+    // 'invalidate()'; mudanças nos elementos não são detectadas.
+    bool stale() {
+        return static_cast<std::size_t>(std::ranges::size(base_)) !=
+               values_.size();
+    }
+
+    // descarta todos os valores guardados e adota o tamanho atual da origem.
+    void invalidate() {
+        const auto n = static_cast<std::size_t>(std::ranges::size(base_));
+        values_.assign(n, std::nullopt);
+        computed_ = 0;
+    }
+    // descarta o valor guardado do elemento 'i'.
+    void invalidate(std::size_t i) {
+        if (values_[i]) {
+            values_[i].reset();
+            --computed_;
+        }
+    }
+
+   private:
+    using diff = std::ranges::range_difference_t<V>;
+
+    void check() {
+        if (stale()) {
+            throw stale_cache("memo::memoize: a origem mudou de tamanho");
+        }
+    }
+
+    V base_ = V();
+    std::vector<std::optional<value_type>> values_;
+    std::size_t computed_ = 0;
+};
+
+template <std::ranges::random_access_range V>
+    requires std::ranges::view<V> && std::ranges::sized_range<V>
+class memoize_view<V>::iterator {
+   public:
+    using iterator_concept = std::random_access_iterator_tag;
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = memoize_view::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = const value_type&;
+
+    iterator() = default;
+
+    reference operator*() const { return (*parent_)[pos_]; }
+    reference operator[](difference_type n) const {
+        return (*parent_)[pos_ + static_cast<std::size_t>(n)];
+    }
+
+    iterator& operator++() {
+        ++pos_;
+        return *this;
+    }
+    iterator operator++(int) {
+        iterator tmp = *this;
+        ++pos_;
+        return tmp;
+    }
+    iterator& operator--() {
+        --pos_;
+        return *this;
+    }
+    iterator operator--(int) {
+        iterator tmp = *this;
+        --pos_;
+        return tmp;
+    }
+    iterator& operator+=(difference_type n) {
+        pos_ += static_cast<std::size_t>(n);
+        return *this;
+    }
+    iterator& operator-=(difference_type n) {
+        pos_ -= static_cast<std::size_t>(n);
+        return *this;
+    }
+
+    friend iterator operator+(iterator it, difference_type n) {
+        return it += n;
+    }
+    friend iterator operator+(difference_type n, iterator it) {
+        return it += n;
+    }
+    friend iterator operator-(iterator it, difference_type n) {
+        return it -= n;
+    }
+    friend difference_type operator-(const iterator& a, const iterator& b) {
+        return static_cast<difference_type>(a.pos_) -
+               static_cast<difference_type>(b.pos_);
+    }
+    friend bool operator==(const iterator& a, const iterator& b) {
+        return a.pos_ == b.pos_;
+    }
+    friend auto operator<=>(const iterator& a, const iterator& b) {
+        return a.pos_ <=> b.pos_;
+    }
+
+   private:
+    friend memoize_view;
+    iterator(memoize_view* parent, std::size_t pos)
+        : parent_(parent), pos_(pos) {}
+
+    memoize_view* parent_ = nullptr;
+    std::size_t pos_ = 0;
+};
+
+template <typename R>
+memoize_view(R&&) -> memoize_view<std::views::all_t<R>>;
+
+struct cache_latest_fn : detail::closure<cache_latest_fn> {
+    template <std::ranges::viewable_range R>
+        requires std::ranges::input_range<R>
+    auto operator()(R&& r) const {
+        return cache_latest_view(std::forward<R>(r));
+    }
+};
+
+struct memoize_fn : detail::closure<memoize_fn> {
+    template <std::ranges::viewable_range R>
+        requires std::ranges::random_access_range<R> &&
+                 std::ranges::sized_range<R>
+    auto operator()(R&& r) const {
+        return memoize_view(std::forward<R>(r));
+    }
+};
+
+inline constexpr cache_latest_fn cache_latest{};
+inline constexpr memoize_fn memoize{};
+
+}  // namespace memo
@@ -11,6 +11,8 @@
 #include <typeinfo>
 #include <vector>
 
+#include "minmax_ref.hpp"
+
 namespace min_max_algorithms {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -100,5 +102,45 @@ void main() {
         cout << "'max res': " << to_string(*max)
              << " na posição: " << std::distance(v.begin(), max) << endl;
     };
+    {
+        cout << endl;
+        cout << "minmax::min_of(a, b, c), minmax::minmax_ref(a, b, c) e "
+                "minmax::clamp_ref(a, b, c) (referências, sem cópias):"
+             << endl;
+        X a{42}, b{-2}, c{24};
+        X::copy_count = X::move_count = 0;
+        X& min = minmax::min_of(a, b, c);
+        auto [lo, hi] = minmax::minmax_ref(a, b, c);
+        const X& clamped = minmax::clamp_ref(a, b, c);
+        cout << "'min': " << to_string(min) << ", 'minmax': {"
+             << to_string(lo) << ", " << to_string(hi)
+             << "}, 'clamp': " << to_string(clamped) << endl;
+        cout << "cópias: " << X::copy_count
+             << ", movimentos: " << X::move_count << endl;
+    };
+    {
+        cout << endl;
+        cout << "minmax::max_of.with(std::ranges::less{}, &X::value)"
+                "(X{2}, X{42}, X{24}) (temporários são movidos):"
+             << endl;
+        X::copy_count = X::move_count = 0;
+        X max = minmax::max_of.with(std::ranges::less{}, &X::value)(
+            X{2}, X{42}, X{24});
+        cout << "'max': " << to_string(max) << endl;
+        cout << "cópias: " << X::copy_count
+             << ", movimentos: " << X::move_count << endl;
+    };
+    {
+        cout << endl;
+        cout << "minmax::clamp_all(v, X{0}, X{10}):" << endl;
+        vector<X> v{{2}, {-2}, {42}, {24}, {7}};
+        cout << "'v': " << stringify(v) << endl;
+        const X lo{0}, hi{10};
+        X::copy_count = X::move_count = 0;
+        minmax::clamp_all(v, lo, hi);
+        cout << "'v': " << stringify(v) << endl;
+        cout << "cópias: " << X::copy_count
+             << " (apenas os elementos fora do intervalo)" << endl;
+    };
 };
 }  // namespace min_max_algorithms
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <execution>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "parallel.hpp"
+
+// Versões de 'std::min', 'std::max', 'std::minmax' e 'std::clamp' que não
+// copiam e não criam 'dangling references':
+// - se todos os argumentos são lvalues, o resultado é uma referência ao
+//   argumento escolhido ('T&' se nenhum é const, 'const T&' caso contrário);
+// - se algum argumento é rvalue, o resultado é um valor 'T', construído por
+//   movimento a partir do argumento escolhido quando ele é rvalue (e copiado
+//   somente quando o escolhido é um lvalue misturado a temporários).
+// As versões variádicas comparam os argumentos numa sequência desenrolada em
+// tempo de compilação, e aceitam comparador e projeção por meio de
+// 'min_of.with(comp, proj)(a, b, c)'. Assim como na stl, 'min_of' devolve o
+// primeiro menor, 'max_of' o primeiro maior e 'minmax_ref' o primeiro menor e
+// o último maior.
+namespace minmax {
+
+namespace detail {
+
+// todos os argumentos têm o mesmo tipo, a menos de const e referência.
+template <typename... Args>
+concept same_decayed =
+    sizeof...(Args) > 0 &&
+    (std::same_as<std::remove_cvref_t<Args>,
+                  std::remove_cvref_t<std::tuple_element_t<
+                      0, std::tuple<Args...>>>> && ...);
+
+template <typename... Args>
+using value_t =
+    std::remove_cvref_t<std::tuple_element_t<0, std::tuple<Args...>>>;
+
+// referência comum quando todos são lvalues; senão, um valor.
+template <typename... Args>
+using result_t =
+    std::conditional_t<(std::is_lvalue_reference_v<Args> && ...),
+                       std::common_reference_t<Args...>, value_t<Args...>>;
+
+// argumento 'i', convertido em 'R'; com 'R' por valor, o único movimento (ou
+// cópia) é o da conversão, já que o resultado é um prvalue.
+template <typename R, typename A, typename... Rest>
+constexpr R pick(std::size_t i, A&& a, Rest&&... rest) {
+    if constexpr (sizeof...(Rest) == 0) {
+        return static_cast<R>(std::forward<A>(a));
+    } else {
+        return i == 0 ? static_cast<R>(std::forward<A>(a))
+                      : pick<R>(i - 1, std::forward<Rest>(rest)...);
+    }
+}
+
+// índice do argumento escolhido; 'replace(a, b)' diz se o candidato 'b'
+// substitui o atual 'a'.
+template <typename Replace, typename... Args>
+constexpr std::size_t select(Replace replace, const Args&... args) {
+    using T = value_t<Args...>;
+    const T* const p[] = {std::addressof(args)...};
+    std::size_t best = 0;
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        ((best = replace(*p[best], *p[I + 1]) ? I + 1 : best), ...);
+    }(std::make_index_sequence<sizeof...(Args) - 1>{});
+    return best;
+}
+
+template <typename Comp, typename Proj, typename T>
+concept projected_order =
+    std::indirect_strict_weak_order<Comp, std::projected<const T*, Proj>>;
+
+}  // namespace detail
+
+template <typename Comp = std::ranges::less, typename Proj = std::identity>
+struct min_of_fn {
+    [[no_unique_address]] Comp comp{};
+    [[no_unique_address]] Proj proj{};
+
+    template <typename... Args>
+        requires detail::same_decayed<Args...> &&
+                 detail::projected_order<Comp, Proj, detail::value_t<Args...>>
+    constexpr detail::result_t<Args&&...> operator()(Args&&... args) const {
+        const std::size_t i = detail::select(
+            [&](const auto& best, const auto& x) {
+                return std::invoke(comp, std::invoke(proj, x),
+                                   std::invoke(proj, best));
+            },
+            args...);
+        return detail::pick<detail::result_t<Args&&...>>(
+            i, std::forward<Args>(args)...);
+    }
+
+    template <typename C, typename P = std::identity>
+    constexpr min_of_fn<C, P> with(C c, P p = {}) const {
+        return {std::move(c), std::move(p)};
+    }
+};
+
+template <typename Comp = std::ranges::less, typename Proj = std::identity>
+struct max_of_fn {
+    [[no_unique_address]] Comp comp{};
+    [[no_unique_address]] Proj proj{};
+
+    template <typename... Args>
+        requires detail::same_decayed<Args...> &&
+                 detail::projected_order<Comp, Proj, detail::value_t<Args...>>
+    constexpr detail::result_t<Args&&...> operator()(Args&&... args) const {
+        const std::size_t i = detail::select(
+            [&](const auto& best, const auto& x) {
+                return std::invoke(comp, std::invoke(proj, best),
+                                   std::invoke(proj, x));
+            },
+            args...);
+        return detail::pick<detail::result_t<Args&&...>>(
+            i, std::forward<Args>(args)...);
+    }
+
+    template <typename C, typename P = std::identity>
+    constexpr max_of_fn<C, P> with(C c, P p = {}) const {
+        return {std::move(c), std::move(p)};
+    }
+};
+
+// '{min, max}', como 'std::ranges::minmax'. O resultado é um agregado, de
+// forma que cada membro é construído diretamente a partir do argumento. Exige
+// ao menos dois argumentos, o que garante que os dois índices são distintos e
+// nenhum argumento é movido duas vezes.
+template <typename Comp = std::ranges::less, typename Proj = std::identity>
+struct minmax_ref_fn {
+    [[no_unique_address]] Comp comp{};
+    [[no_unique_address]] Proj proj{};
+
+    template <typename... Args>
+        requires(sizeof...(Args) >= 2) && detail::same_decayed<Args...> &&
+                detail::projected_order<Comp, Proj, detail::value_t<Args...>>
+    constexpr std::ranges::minmax_result<detail::result_t<Args&&...>>
+    operator()(Args&&... args) const {
+        using R = detail::result_t<Args&&...>;
+        const std::size_t lo = detail::select(
+            [&](const auto& best, const auto& x) {
+                return std::invoke(comp, std::invoke(proj, x),
+                                   std::invoke(proj, best));
+            },
+            args...);
+        const std::size_t hi = detail::select(
+            [&](const auto& best, const auto& x) {
+                return !std::invoke(comp, std::invoke(proj, x),
+                                    std::invoke(proj, best));
+            },
+            args...);
+        return {detail::pick<R>(lo, std::forward<Args>(args)...),
+                detail::pick<R>(hi, std::forward<Args>(args)...)};
+    }
+
+    template <typename C, typename P = std::identity>
+    constexpr minmax_ref_fn<C, P> with(C c, P p = {}) const {
+        return {std::move(c), std::move(p)};
+    }
+};
+
+// como 'std::ranges::clamp(v, lo, hi, comp, proj)', com as mesmas regras de
+// retorno; exige '!comp(proj(hi), proj(lo))'.
+struct clamp_ref_fn {
+    template <typename V, typename L, typename H,
+              typename Comp = std::ranges::less, typename Proj = std::identity>
+        requires detail::same_decayed<V, L, H> &&
+                 detail::projected_order<Comp, Proj, detail::value_t<V>>
+    constexpr detail::result_t<V&&, L&&, H&&> operator()(V&& v, L&& lo, H&& hi,
+                                                         Comp comp = {},
+                                                         Proj proj = {}) const {
+        auto&& key = std::invoke(proj, v);
+        const std::size_t i =
+            std::invoke(comp, key, std::invoke(proj, lo))   ? 1
+            : std::invoke(comp, std::invoke(proj, hi), key) ? 2
+                                                            : 0;
+        return detail::pick<detail::result_t<V&&, L&&, H&&>>(
+            i, std::forward<V>(v), std::forward<L>(lo), std::forward<H>(hi));
+    }
+};
+
+// limita cada elemento de 'r' a [lo, hi] no próprio lugar: apenas os
+// elementos fora do intervalo são atribuídos (por cópia de 'lo' ou 'hi').
+struct clamp_all_fn {
+    template <std::ranges::forward_range R, typename Comp = std::ranges::less,
+              typename Proj = std::identity>
+        requires std::indirectly_copyable<
+                     const std::ranges::range_value_t<R>*,
+                     std::ranges::iterator_t<R>> &&
+                 std::indirect_strict_weak_order<
+                     Comp, std::projected<std::ranges::iterator_t<R>, Proj>>
+    constexpr std::ranges::borrowed_iterator_t<R> operator()(
+        R&& r, const std::ranges::range_value_t<R>& lo,
+        const std::ranges::range_value_t<R>& hi, Comp comp = {},
+        Proj proj = {}) const {
+        auto first = std::ranges::begin(r);
+        const auto last = std::ranges::end(r);
+        for (; first != last; ++first) {
+            clamp_one(*first, lo, hi, comp, proj);
+        }
+        return first;
+    }
+
+    template <parallel::execution_policy P, std::ranges::random_access_range R,
+              typename Comp = std::ranges::less, typename Proj = std::identity>
+        requires std::ranges::sized_range<R> &&
+                 std::indirectly_copyable<
+                     const std::ranges::range_value_t<R>*,
+                     std::ranges::iterator_t<R>> &&
+                 std::indirect_strict_weak_order<
+                     Comp, std::projected<std::ranges::iterator_t<R>, Proj>>
+    std::ranges::borrowed_iterator_t<R> operator()(
+        P&& policy, R&& r, const std::ranges::range_value_t<R>& lo,
+        const std::ranges::range_value_t<R>& hi, Comp comp = {},
+        Proj proj = {}) const {
+        auto first = std::ranges::begin(r);
+        const auto n = static_cast<std::size_t>(std::ranges::size(r));
+        parallel::for_each_chunk(
+            policy, n, parallel::chunk_count(policy, n),
+            [&](std::size_t, std::size_t b, std::size_t e) {
+                for (std::size_t i = b; i < e; ++i) {
+                    clamp_one(first[static_cast<std::ptrdiff_t>(i)], lo, hi,
+                              comp, proj);
+                }
+            });
+        return first + static_cast<std::ptrdiff_t>(n);
+    }
+
+   private:
+    template <typename E, typename T, typename Comp, typename Proj>
+    static constexpr void clamp_one(E&& x, const T& lo, const T& hi,
+                                    Comp& comp, Proj& proj) {
+        auto&& key = std::invoke(proj, x);
+        if (std::invoke(comp, key, std::invoke(proj, lo))) {
+            x = lo;
+        } else if (std::invoke(comp, std::invoke(proj, hi), key)) {
+            x = hi;
+        }
+    }
+};
+
+inline constexpr min_of_fn<> min_of{};
+inline constexpr max_of_fn<> max_of{};
+inline constexpr minmax_ref_fn<> minmax_ref{};
+inline constexpr clamp_ref_fn clamp_ref{};
+inline constexpr clamp_all_fn clamp_all{};
+
+}  // namespace minmax
@@ -0,0 +1,448 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "parallel.hpp"
+
+// Codificação de chaves normalizadas: os campos escolhidos de uma struct
+// (inteiros, enums, 'float'/'double' e strings, cada um crescente ou
+// decrescente) são convertidos numa chave cuja ordem é a da comparação campo a
+// campo, de forma que um único 'memcmp' ou uma comparação de inteiros
+// substitui o comparador com um 'if' por campo.
+// - 'bytes(x)' devolve uma 'std::string' (comparada como 'unsigned char').
+//   Inteiros são gravados em big-endian com o bit de sinal invertido; números
+//   de ponto flutuante têm o bit de sinal invertido (positivos) ou todos os
+//   bits invertidos (negativos); strings têm cada '\0' escapado como
+//   "\0\xff" e terminam em "\0\0", o que mantém a ordem e impede que o fim de
+//   uma string se confunda com o campo seguinte. Campos decrescentes têm os
+//   bytes complementados.
+// - 'key(x)' devolve um 'uint64_t' ou 'unsigned __int128' quando todos os
+//   campos têm largura fixa e somam até 16 bytes. Uma string entra na chave
+//   fixa só como último campo e com uma largura explícita de até 8 bytes
+//   ('asc<&T::nome, 4>'): os primeiros bytes, completados com zeros, o que
+//   deixa empates entre strings distintas ('exact' é falso nesse caso).
+// - O próprio encoder serve como projeção ('std::ranges::set_union(a, b, out,
+//   {}, enc, enc)'): devolve 'key(x)' quando a chave fixa é exata, e
+//   'bytes(x)' nos demais casos, já que uma chave truncada juntaria
+//   elementos distintos em buscas e operações de conjunto.
+// Como a codificação de ponto flutuante segue os bits, -0.0 é normalizado
+// para 0.0 e todo NaN para o mesmo NaN positivo, que fica depois do infinito.
+namespace normalized_key {
+
+enum class order { ascending, descending };
+
+// campo 'Proj' (ponteiro para membro ou função sem estado) de um objeto.
+template <auto Proj, order O = order::ascending, std::size_t Width = 0>
+struct field {
+    static constexpr order direction = O;
+    static constexpr std::size_t width = Width;
+
+    template <typename T>
+    static decltype(auto) get(const T& x) {
+        return std::invoke(Proj, x);
+    }
+};
+
+template <auto Proj, std::size_t Width = 0>
+using asc = field<Proj, order::ascending, Width>;
+template <auto Proj, std::size_t Width = 0>
+using desc = field<Proj, order::descending, Width>;
+
+namespace detail {
+
+template <typename V>
+concept integer_like = std::integral<V> || std::is_enum_v<V>;
+
+template <typename V>
+concept float_like = std::same_as<V, float> || std::same_as<V, double>;
+
+template <typename V>
+concept string_like =
+    !integer_like<V> && std::convertible_to<const V&, std::string_view>;
+
+// inteiro sem sinal cuja ordem é a de 'v'.
+template <integer_like V>
+constexpr auto ordered_bits(V v) {
+    if constexpr (std::is_enum_v<V>) {
+        return ordered_bits(static_cast<std::underlying_type_t<V>>(v));
+    } else if constexpr (std::same_as<V, bool>) {
+        return static_cast<std::uint8_t>(v);
+    } else {
+        using U = std::make_unsigned_t<V>;
+        auto u = static_cast<U>(v);
+        if constexpr (std::is_signed_v<V>) {
+            u ^= static_cast<U>(U{1} << (std::numeric_limits<U>::digits - 1));
+        }
+        return u;
+    }
+}
+
+template <float_like V>
+constexpr auto ordered_bits(V v) {
+    using U = std::conditional_t<sizeof(V) == 4, std::uint32_t, std::uint64_t>;
+    constexpr U sign = U{1} << (std::numeric_limits<U>::digits - 1);
+    if (v == 0) v = 0;
+    if (std::isnan(v)) v = std::numeric_limits<V>::quiet_NaN();
+    const auto u = std::bit_cast<U>(v);
+    return (u & sign) ? static_cast<U>(~u) : static_cast<U>(u | sign);
+}
+
+template <typename F, typename T>
+using field_t = std::remove_cvref_t<decltype(F::get(std::declval<const T&>()))>;
+
+// largura do campo na chave fixa; 0 se o campo não cabe numa chave fixa.
+template <typename F, typename T>
+constexpr std::size_t fixed_width() {
+    using V = field_t<F, T>;
+    if constexpr (integer_like<V> || float_like<V>) {
+        return sizeof(ordered_bits(V{}));
+    } else if constexpr (string_like<V>) {
+        // o prefixo ocupa um 'uint64_t'.
+        return F::width <= 8 ? F::width : 0;
+    } else {
+        return 0;
+    }
+}
+
+// um prefixo de string empata strings distintas; os campos seguintes
+// desempatariam essas strings fora de ordem, então ele só pode ser o último.
+template <typename T, typename... Fields>
+constexpr bool strings_last() {
+    constexpr bool str[] = {string_like<field_t<Fields, T>>...};
+    return std::ranges::count(str, true) == 0 ||
+           (std::ranges::count(str, true) == 1 && str[sizeof...(Fields) - 1]);
+}
+
+template <typename F, typename T>
+concept encodable_field =
+    integer_like<field_t<F, T>> || float_like<field_t<F, T>> ||
+    string_like<field_t<F, T>>;
+
+// 'bits' nos 'w' bytes menos significativos, complementados se 'desc'.
+template <typename K, typename U>
+constexpr K place(K k, U bits, std::size_t w, bool desc) {
+    constexpr std::size_t kbits = 8 * sizeof(K);
+    K b = static_cast<K>(bits);
+    if (desc) {
+        b = ~b;
+        if (8 * w < kbits) b &= (K{1} << (8 * w)) - 1;
+    }
+    return (8 * w < kbits ? k << (8 * w) : K{0}) | b;
+}
+
+// 'w' primeiros bytes de 's' em big-endian, completados com zeros.
+inline std::uint64_t string_prefix(std::string_view s, std::size_t w) {
+    std::uint64_t k = 0;
+    for (std::size_t i = 0; i < w; ++i) {
+        const auto c = i < s.size() ? static_cast<unsigned char>(s[i]) : 0u;
+        k = (k << 8) | c;
+    }
+    return k;
+}
+
+}  // namespace detail
+
+template <typename T, typename... Fields>
+    requires(sizeof...(Fields) > 0) &&
+            (detail::encodable_field<Fields, T> && ...)
+class encoder {
+   public:
+    // bytes da chave fixa, se todos os campos têm largura fixa.
+    static constexpr std::size_t width =
+        (detail::fixed_width<Fields, T>() + ...);
+    static constexpr bool fixed =
+        ((detail::fixed_width<Fields, T>() != 0) && ...) && width <= 16 &&
+        detail::strings_last<T, Fields...>();
+    // chaves fixas iguais implicam campos iguais.
+    static constexpr bool exact =
+        !(detail::string_like<detail::field_t<Fields, T>> || ...);
+
+    using key_type = std::conditional_t<width <= 8, std::uint64_t,
+                                        unsigned __int128>;
+
+    // acrescenta a codificação de 'x' a 'out'.
+    static void append(std::string& out, const T& x) {
+        (append_field<Fields>(out, x), ...);
+    }
+
+    static std::string bytes(const T& x) {
+        std::string out;
+        append(out, x);
+        return out;
+    }
+
+    static key_type key(const T& x)
+        requires fixed
+    {
+        key_type k = 0;
+        ((k = key_field<Fields>(k, x)), ...);
+        return k;
+    }
+
+    // como projeção: a chave fixa quando ela é exata, senão os bytes, que
+    // distinguem todos os campos.
+    auto operator()(const T& x) const {
+        if constexpr (fixed && exact) {
+            return key(x);
+        } else {
+            return bytes(x);
+        }
+    }
+
+   private:
+    template <typename F>
+    static void append_field(std::string& out, const T& x) {
+        using V = detail::field_t<F, T>;
+        const std::size_t start = out.size();
+        if constexpr (detail::string_like<V>) {
+            const std::string_view s = F::get(x);
+            for (char c : s) {
+                out.push_back(c);
+                if (c == '\0') out.push_back('\xff');
+            }
+            out.append(2, '\0');
+        } else {
+            const auto bits = detail::ordered_bits(F::get(x));
+            for (std::size_t i = sizeof bits; i-- > 0;) {
+                out.push_back(static_cast<char>(bits >> (8 * i)));
+            }
+        }
+        if constexpr (F::direction == order::descending) {
+            for (std::size_t i = start; i < out.size(); ++i) {
+                out[i] = static_cast<char>(~out[i]);
+            }
+        }
+    }
+
+    template <typename F>
+    static key_type key_field(key_type k, const T& x) {
+        using V = detail::field_t<F, T>;
+        constexpr std::size_t w = detail::fixed_width<F, T>();
+        constexpr bool desc = F::direction == order::descending;
+        if constexpr (detail::string_like<V>) {
+            static_assert(w <= 8, "prefixo de string de até 8 bytes");
+            return detail::place(k, detail::string_prefix(F::get(x), w), w,
+                                 desc);
+        } else {
+            return detail::place(k, detail::ordered_bits(F::get(x)), w, desc);
+        }
+    }
+};
+
+namespace detail {
+
+template <typename K>
+struct keyed_index {
+    K key;
+    std::size_t index;
+};
+
+// número de bits significativos de 'k'.
+template <typename K>
+std::size_t bit_width(K k) {
+    if constexpr (sizeof(K) > sizeof(std::uint64_t)) {
+        const auto hi = static_cast<std::uint64_t>(k >> 64);
+        return hi ? 64 + std::bit_width(hi)
+                  : std::bit_width(static_cast<std::uint64_t>(k));
+    } else {
+        return std::bit_width(k);
+    }
+}
+
+// ordena 'a[0, n)' por chave e, nos empates, pela posição original (o que
+// equivale a uma ordenação estável), usando 'b' como buffer; devolve 'a' ou
+// 'b', conforme onde o resultado ficou. Uma passada de radix
+// sort MSD distribui as chaves pelos 11 primeiros bits em que elas diferem
+// (o prefixo comum a todas, que é o da menor e da maior, é pulado), e cada
+// balde, pequeno o bastante para caber no cache, é ordenado com
+// comparações de inteiros. Em paralelo, cada bloco conta e distribui a sua
+// parte, e os baldes são ordenados independentemente.
+template <parallel::execution_policy P, typename K>
+keyed_index<K>* radix_sort(P&& policy, keyed_index<K>* a, keyed_index<K>* b,
+                           std::size_t n, std::size_t chunks) {
+    constexpr std::size_t digit_bits = 11;
+    constexpr std::size_t buckets = std::size_t{1} << digit_bits;
+    if (n < 2) return a;
+    const auto [lo, hi] = std::ranges::minmax(std::ranges::subrange(a, a + n),
+                                              {}, &keyed_index<K>::key);
+    const std::size_t w = detail::bit_width(lo.key ^ hi.key);
+    if (w == 0) return a;
+    const std::size_t shift = w > digit_bits ? w - digit_bits : 0;
+    const auto digit = [shift](const K& k) {
+        return static_cast<std::size_t>(k >> shift) & (buckets - 1);
+    };
+    // posição de destino de cada (bloco, dígito), na ordem (dígito, bloco).
+    std::vector<std::size_t> pos(chunks * buckets, 0);
+    parallel::for_each_chunk(
+        policy, n, chunks, [&](std::size_t c, std::size_t l, std::size_t h) {
+            for (std::size_t i = l; i < h; ++i) {
+                ++pos[c * buckets + digit(a[i].key)];
+            }
+        });
+    std::vector<std::size_t> start(buckets + 1, 0);
+    for (std::size_t d = 0; d < buckets; ++d) {
+        start[d + 1] = start[d];
+        for (std::size_t c = 0; c < chunks; ++c) {
+            start[d + 1] += std::exchange(pos[c * buckets + d], start[d + 1]);
+        }
+    }
+    parallel::for_each_chunk(
+        policy, n, chunks, [&](std::size_t c, std::size_t l, std::size_t h) {
+            std::size_t* p = pos.data() + c * buckets;
+            for (std::size_t i = l; i < h; ++i) b[p[digit(a[i].key)]++] = a[i];
+        });
+    parallel::for_each_chunk(
+        policy, buckets, std::min(buckets, 4 * chunks),
+        [&](std::size_t, std::size_t l, std::size_t h) {
+            for (std::size_t d = l; d < h; ++d) {
+                std::sort(b + start[d], b + start[d + 1],
+                          [](const keyed_index<K>& x, const keyed_index<K>& y) {
+                              return x.key < y.key ||
+                                     (x.key == y.key && x.index < y.index);
+                          });
+            }
+        });
+    return b;
+}
+
+// reordena pelos bytes completos ('bytes_of(index)') cada faixa de
+// 'sorted[0, n)' com chaves fixas iguais, que não são exatas quando há prefixos
+// de string; a ordem pela posição original nos empates é mantida.
+template <parallel::execution_policy P, typename K, typename BytesOf>
+void break_ties(P&& policy, keyed_index<K>* sorted, std::size_t n,
+                BytesOf&& bytes_of) {
+    std::vector<keyed_index<std::string>> run;
+    for (std::size_t i = 0, j = 0; i < n; i = j) {
+        while (j < n && sorted[j].key == sorted[i].key) ++j;
+        if (j - i < 2) continue;
+        run.clear();
+        for (std::size_t k = i; k < j; ++k) {
+            run.push_back({bytes_of(sorted[k].index), sorted[k].index});
+        }
+        std::stable_sort(policy, run.begin(), run.end(),
+                         [](const auto& x, const auto& y) {
+                             return x.key < y.key;
+                         });
+        for (std::size_t k = i; k < j; ++k) sorted[k].index = run[k - i].index;
+    }
+}
+
+// move os elementos de 'first' para a ordem dada pelos índices de 'order',
+// no próprio lugar: a posição 'j' recebe o elemento 'order[j].index'. Cada
+// ciclo da permutação começa num temporário, e cada elemento é movido uma
+// única vez; os índices das posições preenchidas passam a apontar para si
+// mesmas.
+template <typename I, typename Order>
+void apply_order(I first, Order&& order) {
+    const auto at = [&](std::size_t i) {
+        return first + static_cast<std::iter_difference_t<I>>(i);
+    };
+    const auto n = static_cast<std::size_t>(std::ranges::size(order));
+    auto o = std::ranges::begin(order);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (o[i].index == i) continue;
+        std::iter_value_t<I> tmp = std::ranges::iter_move(at(i));
+        std::size_t j = i;
+        for (std::size_t src = o[j].index; src != i; src = o[j].index) {
+            *at(j) = std::ranges::iter_move(at(src));
+            o[j].index = j;
+            j = src;
+        }
+        *at(j) = std::move(tmp);
+        o[j].index = j;
+    }
+}
+
+}  // namespace detail
+
+// ordenação estável de 'r' pela chave de 'Encoder': radix sort das chaves
+// fixas ou 'std::stable_sort' das chaves em bytes. Chaves fixas que não são
+// exatas têm os empates desfeitos pelos bytes completos. Os elementos são
+// movidos uma única vez, no final, no próprio lugar (mais um movimento para
+// um temporário por ciclo da permutação).
+struct sort_fn {
+    template <parallel::execution_policy P, std::ranges::random_access_range R,
+              typename T, typename... Fields>
+        requires std::ranges::sized_range<R> &&
+                 std::permutable<std::ranges::iterator_t<R>> &&
+                 std::convertible_to<std::ranges::range_reference_t<R>,
+                                     const T&>
+    void operator()(P&& policy, R&& r, encoder<T, Fields...>) const {
+        using E = encoder<T, Fields...>;
+        const auto n = static_cast<std::size_t>(std::ranges::size(r));
+        auto first = std::ranges::begin(r);
+        const std::size_t chunks = parallel::chunk_count(policy, n);
+        const auto at = [&](std::size_t i) -> const T& {
+            return first[static_cast<std::ptrdiff_t>(i)];
+        };
+        if constexpr (E::fixed) {
+            using K = typename E::key_type;
+            // sem inicialização: 'a' é preenchido logo abaixo e 'b' só é
+            // lido onde já foi escrito.
+            using entry = detail::keyed_index<K>;
+            auto a = std::make_unique_for_overwrite<entry[]>(n);
+            auto b = std::make_unique_for_overwrite<entry[]>(n);
+            parallel::for_each_chunk(
+                policy, n, chunks,
+                [&](std::size_t, std::size_t lo, std::size_t hi) {
+                    for (std::size_t i = lo; i < hi; ++i) {
+                        a[i] = {E::key(at(i)), i};
+                    }
+                });
+            auto* sorted =
+                detail::radix_sort(policy, a.get(), b.get(), n, chunks);
+            if constexpr (!E::exact) {
+                detail::break_ties(policy, sorted, n, [&](std::size_t i) {
+                    return E::bytes(at(i));
+                });
+            }
+            detail::apply_order(first,
+                                std::ranges::subrange(sorted, sorted + n));
+        } else {
+            std::vector<detail::keyed_index<std::string>> a(n);
+            parallel::for_each_chunk(
+                policy, n, chunks,
+                [&](std::size_t, std::size_t lo, std::size_t hi) {
+                    for (std::size_t i = lo; i < hi; ++i) {
+                        a[i] = {E::bytes(at(i)), i};
+                    }
+                });
+            std::stable_sort(policy, a.begin(), a.end(),
+                             [](const auto& x, const auto& y) {
+                                 return x.key < y.key;
+                             });
+            detail::apply_order(first, a);
+        }
+    }
+
+    template <std::ranges::random_access_range R, typename T,
+              typename... Fields>
+        requires std::ranges::sized_range<R> &&
+                 std::permutable<std::ranges::iterator_t<R>> &&
+                 std::convertible_to<std::ranges::range_reference_t<R>,
+                                     const T&>
+    void operator()(R&& r, encoder<T, Fields...> e) const {
+        (*this)(std::execution::seq, std::forward<R>(r), e);
+    }
+};
+
+inline constexpr sort_fn sort{};
+
+}  // namespace normalized_key
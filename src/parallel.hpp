@@ -0,0 +1,66 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <execution>
+#include <numeric>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Utilitários para paralelizar algoritmos próprios por meio das mesmas
+// políticas de execução de 'std::execution' aceitas pelos algoritmos da stl.
+// A range de trabalho é dividida em blocos contíguos ('chunks') e cada bloco é
+// processado por uma chamada de 'std::for_each(policy, ...)'.
+namespace parallel {
+
+template <typename P>
+concept execution_policy =
+    std::is_execution_policy_v<std::remove_cvref_t<P>>;
+
+template <typename P>
+constexpr bool is_sequenced() {
+    return std::is_same_v<std::remove_cvref_t<P>,
+                          std::execution::sequenced_policy> ||
+           std::is_same_v<std::remove_cvref_t<P>,
+                          std::execution::unsequenced_policy>;
+}
+
+inline std::size_t hardware_threads() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// número de blocos para 'n' elementos, com no mínimo 'grain' elementos cada.
+template <execution_policy P>
+std::size_t chunk_count(const P&, std::size_t n, std::size_t grain = 1 << 14) {
+    if constexpr (is_sequenced<P>()) {
+        return 1;
+    } else {
+        return std::clamp<std::size_t>(n / std::max<std::size_t>(grain, 1), 1,
+                                       4 * hardware_threads());
+    }
+}
+
+// limites [begin, end) do bloco 'i' de 'chunks' blocos sobre 'n' elementos.
+inline std::pair<std::size_t, std::size_t> chunk_bounds(std::size_t i,
+                                                        std::size_t chunks,
+                                                        std::size_t n) {
+    return {n * i / chunks, n * (i + 1) / chunks};
+}
+
+// invoca 'f(i, begin, end)' para cada bloco, segundo a política 'policy'.
+template <execution_policy P, typename F>
+void for_each_chunk(P&& policy, std::size_t n, std::size_t chunks, F&& f) {
+    if (chunks <= 1) {
+        f(std::size_t{0}, std::size_t{0}, n);
+        return;
+    }
+    std::vector<std::size_t> ids(chunks);
+    std::iota(ids.begin(), ids.end(), 0);
+    std::for_each(policy, ids.begin(), ids.end(), [&](std::size_t i) {
+        auto [b, e] = chunk_bounds(i, chunks, n);
+        f(i, b, e);
+    });
+}
+
+}  // namespace parallel
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <execution>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "parallel.hpp"
+
+// Aplicação de uma mesma permutação a várias colunas (struct-of-arrays): depois
+// de 'apply(perm, a, b, c)', 'a[i]' é o antigo 'a[perm[i]]', e o mesmo vale
+// para 'b' e 'c' (é a permutação devolvida por um 'argsort', por exemplo).
+// - 'apply' é a versão fora do lugar: cada coluna é coletada num buffer, em
+//   blocos de 'block' índices (as escritas são sequenciais, e com uma
+//   política de execução paralela os blocos são divididos entre as threads),
+//   e devolvida com uma varredura sequencial. As colunas são tratadas uma de
+//   cada vez: o pico de memória é o da maior coluna, e as leituras
+//   aleatórias de uma coluna não disputam a cache e a TLB com as das outras
+//   (coletar todas as colunas a cada bloco de índices foi mais lento).
+// - 'apply_in_place' segue os ciclos da permutação, sem buffers além de um
+//   bit por posição, e anda cada ciclo uma única vez para todas as colunas.
+//   As trocas são feitas por 'std::ranges::iter_swap', que usa o 'swap'
+//   próprio do tipo quando há um (como 'Library::swap' em 'swaps.cpp'). Os
+//   acessos de um ciclo são aleatórios e dependentes entre si, o que a torna
+//   várias vezes mais lenta que 'apply' em colunas grandes: serve quando não
+//   há memória para o buffer.
+// Em ambas, 'perm' precisa ser uma permutação de [0, n), e cada coluna ter ao
+// menos 'n' elementos; as posições a partir de 'n' não são alteradas.
+namespace permutation {
+
+namespace detail {
+
+template <typename R>
+concept index_range = std::ranges::random_access_range<R> &&
+                      std::ranges::sized_range<R> &&
+                      std::integral<std::ranges::range_value_t<R>>;
+
+template <typename C>
+concept column = std::ranges::random_access_range<C> &&
+                 std::ranges::sized_range<C> &&
+                 std::permutable<std::ranges::iterator_t<C>>;
+
+// índices por bloco da coleta: 16 KiB de índices de 32 bits, ou 32 KiB de 64.
+inline constexpr std::size_t block = 1 << 12;
+
+template <typename I>
+std::iter_difference_t<I> at(std::size_t i) {
+    return static_cast<std::iter_difference_t<I>>(i);
+}
+
+}  // namespace detail
+
+struct apply_fn {
+    template <parallel::execution_policy P, detail::index_range Perm,
+              detail::column... Cols>
+        requires(sizeof...(Cols) > 0) &&
+                (std::default_initializable<
+                     std::ranges::range_value_t<Cols>> && ...)
+    void operator()(P&& policy, const Perm& perm, Cols&&... cols) const {
+        (apply_column(policy, perm, std::ranges::begin(cols)), ...);
+    }
+
+    template <detail::index_range Perm, detail::column... Cols>
+        requires(sizeof...(Cols) > 0) &&
+                (std::default_initializable<
+                     std::ranges::range_value_t<Cols>> && ...)
+    void operator()(const Perm& perm, Cols&&... cols) const {
+        (*this)(std::execution::seq, perm, std::forward<Cols>(cols)...);
+    }
+
+   private:
+    // coleta a coluna em 'first' num buffer, bloco a bloco de índices, e a
+    // devolve numa varredura sequencial.
+    template <typename P, typename Perm, typename I>
+    static void apply_column(P& policy, const Perm& perm, I first) {
+        using T = std::iter_value_t<I>;
+        const auto n = static_cast<std::size_t>(std::ranges::size(perm));
+        const auto p = std::ranges::begin(perm);
+        const auto buffer = std::make_unique_for_overwrite<T[]>(n);
+        T* out = buffer.get();
+        const std::size_t blocks = (n + detail::block - 1) / detail::block;
+        parallel::for_each_chunk(
+            policy, blocks, parallel::chunk_count(policy, blocks, 1),
+            [&](std::size_t, std::size_t bb, std::size_t be) {
+                const std::size_t hi = std::min(n, be * detail::block);
+                for (std::size_t i = bb * detail::block; i < hi; ++i) {
+                    const auto k =
+                        static_cast<std::size_t>(p[detail::at<decltype(p)>(i)]);
+                    out[i] = std::ranges::iter_move(first + detail::at<I>(k));
+                }
+            });
+        parallel::for_each_chunk(
+            policy, n, parallel::chunk_count(policy, n),
+            [&](std::size_t, std::size_t lo, std::size_t hi) {
+                std::ranges::move(out + lo, out + hi,
+                                  first + detail::at<I>(lo));
+            });
+    }
+};
+
+struct apply_in_place_fn {
+    template <detail::index_range Perm, detail::column... Cols>
+        requires(sizeof...(Cols) > 0)
+    void operator()(const Perm& perm, Cols&&... cols) const {
+        const auto n = static_cast<std::size_t>(std::ranges::size(perm));
+        auto p = std::ranges::begin(perm);
+        const auto next = [&](std::size_t j) {
+            return static_cast<std::size_t>(p[detail::at<decltype(p)>(j)]);
+        };
+        const auto firsts = std::tuple(std::ranges::begin(cols)...);
+        std::vector<bool> done(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (done[i]) continue;
+            done[i] = true;
+            // a cada troca, a posição 'j' recebe o seu elemento final e o
+            // antigo 'x[i]' avança para 'k', até fechar o ciclo.
+            for (std::size_t j = i, k = next(i); k != i; j = k, k = next(k)) {
+                std::apply(
+                    [&](const auto&... first) {
+                        (std::ranges::iter_swap(
+                             first + detail::at<decltype(first)>(j),
+                             first + detail::at<decltype(first)>(k)),
+                         ...);
+                    },
+                    firsts);
+                done[k] = true;
+            }
+        }
+    }
+};
+
+inline constexpr apply_fn apply{};
+inline constexpr apply_in_place_fn apply_in_place{};
+
+}  // namespace permutation
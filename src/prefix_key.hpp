@@ -0,0 +1,173 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <execution>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "parallel.hpp"
+
+// Comparação de strings com um prefixo normalizado em cache: os 8 primeiros
+// bytes de cada string, em big-endian e completados com zeros, formam um
+// inteiro cuja ordem coincide com a de 'std::string' ('char_traits<char>'
+// compara como 'unsigned char'). A maior parte das comparações de uma
+// ordenação se decide nesse inteiro, sem desreferenciar o buffer da string no
+// heap; só prefixos iguais recorrem ao restante das strings.
+// Prefixos iguais com uma das strings de até 8 bytes se decidem pelo
+// tamanho: os zeros de preenchimento empatam com bytes '\0' de verdade, mas
+// nesse caso os 8 bytes da menor string já foram todos comparados.
+namespace prefix_key {
+
+// prefixo normalizado de 's'.
+inline std::uint64_t key(std::string_view s) noexcept {
+    std::uint64_t k = 0;
+    if (!s.empty()) {
+        std::memcpy(&k, s.data(), std::min<std::size_t>(s.size(), sizeof k));
+    }
+    if constexpr (std::endian::native == std::endian::little) {
+        k = std::byteswap(k);
+    }
+    return k;
+}
+
+// desempate de duas strings com o mesmo prefixo.
+inline std::strong_ordering compare_tail(std::string_view a,
+                                         std::string_view b) noexcept {
+    constexpr std::size_t n = sizeof(std::uint64_t);
+    if (a.size() <= n || b.size() <= n) return a.size() <=> b.size();
+    return a.substr(n).compare(b.substr(n)) <=> 0;
+}
+
+// string (ou 'string_view') acompanhada do seu prefixo.
+template <typename S = std::string_view>
+struct keyed {
+    std::uint64_t prefix;
+    S value;
+
+    keyed() = default;
+    explicit keyed(S s) : prefix(key(s)), value(std::move(s)) {}
+
+    std::string_view view() const noexcept { return value; }
+};
+
+struct compare_three_way {
+    template <typename A, typename B>
+    std::strong_ordering operator()(const keyed<A>& a,
+                                    const keyed<B>& b) const noexcept {
+        if (a.prefix != b.prefix) return a.prefix <=> b.prefix;
+        return compare_tail(a.view(), b.view());
+    }
+};
+
+struct less {
+    template <typename A, typename B>
+    bool operator()(const keyed<A>& a, const keyed<B>& b) const noexcept {
+        if (a.prefix != b.prefix) return a.prefix < b.prefix;
+        return compare_tail(a.view(), b.view()) < 0;
+    }
+};
+
+namespace detail {
+// as chaves guardam 'string_view's: a projeção tem que devolver uma
+// referência (ou uma view) aos dados do próprio elemento, nunca uma string
+// temporária.
+template <typename Proj, typename I>
+concept string_projection =
+    std::convertible_to<std::indirect_result_t<Proj&, I>, std::string_view> &&
+    (std::is_lvalue_reference_v<std::indirect_result_t<Proj&, I>> ||
+     std::ranges::borrowed_range<std::indirect_result_t<Proj&, I>>);
+}  // namespace detail
+
+// chaves de 'string_view' para cada elemento (projetado) de 'r'; as chaves
+// referenciam os elementos e valem enquanto eles não forem alterados.
+template <std::ranges::input_range R, typename Proj = std::identity>
+    requires detail::string_projection<Proj, std::ranges::iterator_t<R>>
+std::vector<keyed<>> make_keys(R&& r, Proj proj = {}) {
+    std::vector<keyed<>> keys;
+    if constexpr (std::ranges::sized_range<R>) {
+        keys.reserve(static_cast<std::size_t>(std::ranges::size(r)));
+    }
+    for (auto&& x : r) {
+        keys.emplace_back(std::string_view(std::invoke(proj, x)));
+    }
+    return keys;
+}
+
+// ordena 'r' (em ordem crescente da string projetada) ordenando apenas as
+// chaves (prefixo, 'string_view' e posição original) e aplicando a permutação
+// no final, no próprio lugar, com um movimento por elemento (mais um para um
+// temporário por ciclo da permutação).
+struct sort_fn {
+    template <parallel::execution_policy P, std::ranges::random_access_range R,
+              typename Proj = std::identity>
+        requires std::ranges::sized_range<R> &&
+                 std::permutable<std::ranges::iterator_t<R>> &&
+                 detail::string_projection<Proj, std::ranges::iterator_t<R>>
+    void operator()(P&& policy, R&& r, Proj proj = {}) const {
+        const auto n = static_cast<std::size_t>(std::ranges::size(r));
+        auto first = std::ranges::begin(r);
+        // chave e posição original de cada elemento.
+        struct entry {
+            keyed<> k;
+            std::size_t index;
+        };
+        std::vector<entry> keys(n);
+        parallel::for_each_chunk(
+            policy, n, parallel::chunk_count(policy, n),
+            [&](std::size_t, std::size_t b, std::size_t e) {
+                for (std::size_t i = b; i < e; ++i) {
+                    const std::string_view s = std::invoke(
+                        proj, first[static_cast<std::ptrdiff_t>(i)]);
+                    keys[i] = {keyed<>(s), i};
+                }
+            });
+        std::sort(policy, keys.begin(), keys.end(),
+                  [](const entry& a, const entry& b) {
+                      return less{}(a.k, b.k);
+                  });
+        // as chaves referenciam os elementos: só depois de ordenadas eles
+        // podem ser movidos. A posição 'j' recebe o elemento 'keys[j].index';
+        // cada ciclo começa num temporário, e as posições preenchidas passam
+        // a apontar para si mesmas.
+        const auto at = [&](std::size_t i) {
+            return first + static_cast<std::ptrdiff_t>(i);
+        };
+        for (std::size_t i = 0; i < n; ++i) {
+            if (keys[i].index == i) continue;
+            std::iter_value_t<decltype(first)> tmp =
+                std::ranges::iter_move(at(i));
+            std::size_t j = i;
+            for (std::size_t src = keys[j].index; src != i;
+                 src = keys[j].index) {
+                *at(j) = std::ranges::iter_move(at(src));
+                keys[j].index = j;
+                j = src;
+            }
+            *at(j) = std::move(tmp);
+            keys[j].index = j;
+        }
+    }
+
+    template <std::ranges::random_access_range R, typename Proj = std::identity>
+        requires std::ranges::sized_range<R> &&
+                 std::permutable<std::ranges::iterator_t<R>> &&
+                 detail::string_projection<Proj, std::ranges::iterator_t<R>>
+    void operator()(R&& r, Proj proj = {}) const {
+        (*this)(std::execution::seq, std::forward<R>(r), std::move(proj));
+    }
+};
+
+inline constexpr sort_fn sort{};
+
+}  // namespace prefix_key
@@ -0,0 +1,515 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <execution>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <type_traits>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+// Geração de números aleatórios reprodutível e paralela, baseada no gerador
+// por contador Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy
+// as 1, 2, 3"). O bloco de índice 'i' de um fluxo é uma função pura de
+// ('seed', 'stream', 'i'): não há estado a ser compartilhado ou avançado em
+// sequência, então qualquer thread gera qualquer trecho do fluxo, e os
+// vetores de 8 ou 16 contadores são cifrados de uma vez (AVX2/AVX-512).
+// Ao contrário de 'std::random_device' (uma chamada ao sistema por número) e
+// de 'std::mt19937' (estado de 2.5KB que não pode ser dividido entre threads):
+// - 'philox' satisfaz 'std::uniform_random_bit_generator' e pode ser usado com
+//   as distribuições da stl; 'philox::fill' gera blocos inteiros vetorizados;
+// - 'fill_bits' preenche uma range contígua de inteiros com bits aleatórios;
+// - 'generate' aplica uma distribuição em paralelo;
+// - 'shuffle' embaralha em paralelo com o MergeShuffle (Bacher et al.).
+// Os resultados dependem apenas da semente, e não do número de threads nem da
+// política de execução.
+namespace prng {
+
+namespace detail {
+inline constexpr std::uint32_t philox_m0 = 0xd2511f53;
+inline constexpr std::uint32_t philox_m1 = 0xcd9e8d57;
+inline constexpr std::uint32_t philox_w0 = 0x9e3779b9;
+inline constexpr std::uint32_t philox_w1 = 0xbb67ae85;
+inline constexpr int philox_rounds = 10;
+
+using block = std::array<std::uint32_t, 4>;
+
+constexpr block philox_block(std::uint64_t ctr, std::uint64_t stream,
+                             std::uint64_t key) {
+    std::uint32_t c0 = static_cast<std::uint32_t>(ctr);
+    std::uint32_t c1 = static_cast<std::uint32_t>(ctr >> 32);
+    std::uint32_t c2 = static_cast<std::uint32_t>(stream);
+    std::uint32_t c3 = static_cast<std::uint32_t>(stream >> 32);
+    std::uint32_t k0 = static_cast<std::uint32_t>(key);
+    std::uint32_t k1 = static_cast<std::uint32_t>(key >> 32);
+    for (int r = 0; r < philox_rounds; ++r) {
+        const std::uint64_t p0 = std::uint64_t{philox_m0} * c0;
+        const std::uint64_t p1 = std::uint64_t{philox_m1} * c2;
+        c0 = static_cast<std::uint32_t>(p1 >> 32) ^ c1 ^ k0;
+        c1 = static_cast<std::uint32_t>(p1);
+        c2 = static_cast<std::uint32_t>(p0 >> 32) ^ c3 ^ k1;
+        c3 = static_cast<std::uint32_t>(p0);
+        k0 += philox_w0;
+        k1 += philox_w1;
+    }
+    return {c0, c1, c2, c3};
+}
+}  // namespace detail
+
+#if SIMD_X86
+#pragma GCC push_options
+#pragma GCC target("avx2,bmi,popcnt")
+namespace avx2 {
+// partes alta e baixa dos produtos de 32x32 bits de cada lane por 'm'.
+inline void mulhilo(__m256i a, __m256i m, __m256i& hi, __m256i& lo) {
+    lo = _mm256_mullo_epi32(a, m);
+    const __m256i even = _mm256_mul_epu32(a, m);
+    const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), m);
+    hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xaa);
+}
+
+// 8 blocos consecutivos a partir do contador 'ctr', cuja metade baixa não
+// pode transbordar; os 32 resultados são escritos em ordem em 'out'.
+inline void philox_blocks(std::byte* out, std::uint64_t ctr,
+                          std::uint64_t stream, std::uint64_t key) {
+    __m256i c0 = _mm256_add_epi32(
+        _mm256_set1_epi32(static_cast<int>(ctr)),
+        _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    __m256i c1 = _mm256_set1_epi32(static_cast<int>(ctr >> 32));
+    __m256i c2 = _mm256_set1_epi32(static_cast<int>(stream));
+    __m256i c3 = _mm256_set1_epi32(static_cast<int>(stream >> 32));
+    const __m256i m0 = _mm256_set1_epi32(static_cast<int>(detail::philox_m0));
+    const __m256i m1 = _mm256_set1_epi32(static_cast<int>(detail::philox_m1));
+    auto k0 = static_cast<std::uint32_t>(key);
+    auto k1 = static_cast<std::uint32_t>(key >> 32);
+    for (int r = 0; r < detail::philox_rounds; ++r) {
+        __m256i hi0, lo0, hi1, lo1;
+        mulhilo(c0, m0, hi0, lo0);
+        mulhilo(c2, m1, hi1, lo1);
+        c0 = _mm256_xor_si256(
+            _mm256_xor_si256(hi1, c1),
+            _mm256_set1_epi32(static_cast<int>(k0)));
+        c1 = lo1;
+        c2 = _mm256_xor_si256(
+            _mm256_xor_si256(hi0, c3),
+            _mm256_set1_epi32(static_cast<int>(k1)));
+        c3 = lo0;
+        k0 += detail::philox_w0;
+        k1 += detail::philox_w1;
+    }
+    // transposição: cada lane 'j' de c0..c3 forma o bloco 'j'.
+    const __m256i t0 = _mm256_unpacklo_epi32(c0, c1);
+    const __m256i t1 = _mm256_unpackhi_epi32(c0, c1);
+    const __m256i t2 = _mm256_unpacklo_epi32(c2, c3);
+    const __m256i t3 = _mm256_unpackhi_epi32(c2, c3);
+    const __m256i u0 = _mm256_unpacklo_epi64(t0, t2);  // blocos 0 e 4
+    const __m256i u1 = _mm256_unpackhi_epi64(t0, t2);  // blocos 1 e 5
+    const __m256i u2 = _mm256_unpacklo_epi64(t1, t3);  // blocos 2 e 6
+    const __m256i u3 = _mm256_unpackhi_epi64(t1, t3);  // blocos 3 e 7
+    auto* o = reinterpret_cast<__m256i*>(out);
+    _mm256_storeu_si256(o, _mm256_permute2x128_si256(u0, u1, 0x20));
+    _mm256_storeu_si256(o + 1, _mm256_permute2x128_si256(u2, u3, 0x20));
+    _mm256_storeu_si256(o + 2, _mm256_permute2x128_si256(u0, u1, 0x31));
+    _mm256_storeu_si256(o + 3, _mm256_permute2x128_si256(u2, u3, 0x31));
+}
+}  // namespace avx2
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512bw,avx512vl,bmi,bmi2,popcnt")
+// os intrínsecos sem máscara do GCC 12 partem de '_mm512_undefined_*', o que
+// gera falsos '-Wuninitialized'/'-Wmaybe-uninitialized'.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+namespace avx512 {
+inline void mulhilo(__m512i a, __m512i m, __m512i& hi, __m512i& lo) {
+    lo = _mm512_mullo_epi32(a, m);
+    const __m512i even = _mm512_mul_epu32(a, m);
+    const __m512i odd = _mm512_mul_epu32(_mm512_srli_epi64(a, 32), m);
+    hi = _mm512_mask_blend_epi32(0xaaaa, _mm512_srli_epi64(even, 32), odd);
+}
+
+// 16 blocos consecutivos, como 'avx2::philox_blocks'.
+inline void philox_blocks(std::byte* out, std::uint64_t ctr,
+                          std::uint64_t stream, std::uint64_t key) {
+    __m512i c0 = _mm512_add_epi32(
+        _mm512_set1_epi32(static_cast<int>(ctr)),
+        _mm512_set_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1,
+                         0));
+    __m512i c1 = _mm512_set1_epi32(static_cast<int>(ctr >> 32));
+    __m512i c2 = _mm512_set1_epi32(static_cast<int>(stream));
+    __m512i c3 = _mm512_set1_epi32(static_cast<int>(stream >> 32));
+    const __m512i m0 = _mm512_set1_epi32(static_cast<int>(detail::philox_m0));
+    const __m512i m1 = _mm512_set1_epi32(static_cast<int>(detail::philox_m1));
+    auto k0 = static_cast<std::uint32_t>(key);
+    auto k1 = static_cast<std::uint32_t>(key >> 32);
+    for (int r = 0; r < detail::philox_rounds; ++r) {
+        __m512i hi0, lo0, hi1, lo1;
+        mulhilo(c0, m0, hi0, lo0);
+        mulhilo(c2, m1, hi1, lo1);
+        c0 = _mm512_ternarylogic_epi32(
+            hi1, c1, _mm512_set1_epi32(static_cast<int>(k0)), 0x96);
+        c1 = lo1;
+        c2 = _mm512_ternarylogic_epi32(
+            hi0, c3, _mm512_set1_epi32(static_cast<int>(k1)), 0x96);
+        c3 = lo0;
+        k0 += detail::philox_w0;
+        k1 += detail::philox_w1;
+    }
+    // a lane 'l' de 128 bits de 'u<w>' contém o bloco '4l + w'.
+    const __m512i t0 = _mm512_unpacklo_epi32(c0, c1);
+    const __m512i t1 = _mm512_unpackhi_epi32(c0, c1);
+    const __m512i t2 = _mm512_unpacklo_epi32(c2, c3);
+    const __m512i t3 = _mm512_unpackhi_epi32(c2, c3);
+    const __m512i u0 = _mm512_unpacklo_epi64(t0, t2);
+    const __m512i u1 = _mm512_unpackhi_epi64(t0, t2);
+    const __m512i u2 = _mm512_unpacklo_epi64(t1, t3);
+    const __m512i u3 = _mm512_unpackhi_epi64(t1, t3);
+    const __m512i a = _mm512_shuffle_i64x2(u0, u1, 0x44);
+    const __m512i b = _mm512_shuffle_i64x2(u2, u3, 0x44);
+    const __m512i c = _mm512_shuffle_i64x2(u0, u1, 0xee);
+    const __m512i d = _mm512_shuffle_i64x2(u2, u3, 0xee);
+    _mm512_storeu_si512(out, _mm512_shuffle_i64x2(a, b, 0x88));
+    _mm512_storeu_si512(out + 64, _mm512_shuffle_i64x2(a, b, 0xdd));
+    _mm512_storeu_si512(out + 128, _mm512_shuffle_i64x2(c, d, 0x88));
+    _mm512_storeu_si512(out + 192, _mm512_shuffle_i64x2(c, d, 0xdd));
+}
+}  // namespace avx512
+#pragma GCC diagnostic pop
+#pragma GCC pop_options
+#endif
+
+namespace detail {
+// escreve os blocos [ctr, ctr + count) do fluxo em 'out' (16 bytes cada).
+inline void philox_fill(std::byte* out, std::uint64_t ctr, std::size_t count,
+                        std::uint64_t stream, std::uint64_t key) {
+    std::size_t i = 0;
+#if SIMD_X86
+    // os kernels incrementam apenas a metade baixa do contador.
+    auto fits = [&](std::size_t lanes) {
+        return static_cast<std::uint32_t>(ctr + i) <=
+               std::numeric_limits<std::uint32_t>::max() - (lanes - 1);
+    };
+    switch (simd::active_isa()) {
+        case simd::isa::avx512:
+            for (; i + 16 <= count; i += 16) {
+                if (!fits(16)) break;
+                avx512::philox_blocks(out + 16 * i, ctr + i, stream, key);
+            }
+            break;
+        case simd::isa::avx2:
+            for (; i + 8 <= count; i += 8) {
+                if (!fits(8)) break;
+                avx2::philox_blocks(out + 16 * i, ctr + i, stream, key);
+            }
+            break;
+        case simd::isa::scalar:
+            break;
+    }
+#endif
+    for (; i < count; ++i) {
+        const block b = philox_block(ctr + i, stream, key);
+        std::memcpy(out + 16 * i, b.data(), sizeof(b));
+    }
+}
+}  // namespace detail
+
+// gerador Philox4x32-10: a semente é a chave da cifra e 'stream' escolhe um
+// fluxo independente (por exemplo, um por thread ou por tarefa).
+class philox {
+   public:
+    using result_type = std::uint32_t;
+    static constexpr std::uint64_t default_seed = 20111115;
+
+    explicit philox(std::uint64_t seed = default_seed, std::uint64_t stream = 0)
+        : key_(seed), stream_(stream) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    result_type operator()() {
+        if (index_ == words) refill();
+        return buffer_[index_++];
+    }
+
+    // número de palavras de 32 bits já produzidas.
+    std::uint64_t position() const { return 4 * counter_ - (words - index_); }
+
+    // posiciona o gerador na palavra 'pos' do fluxo, em tempo constante.
+    void seek(std::uint64_t pos) {
+        counter_ = pos / 4;
+        index_ = words;
+        if (pos % 4 != 0) {
+            refill();
+            index_ = static_cast<unsigned>(pos % 4);
+        }
+    }
+
+    void discard(unsigned long long z) { seek(position() + z); }
+
+    // equivale a 'out.size()' chamadas de 'operator()', com os blocos
+    // inteiros escritos diretamente em 'out'.
+    void fill(std::span<result_type> out) {
+        std::size_t i = 0;
+        for (; i < out.size() && index_ % 4 != 0; ++i) out[i] = (*this)();
+        if (i == out.size()) return;
+        // o restante do buffer começa num bloco inteiro: basta recuar.
+        counter_ -= (words - index_) / 4;
+        index_ = words;
+        const std::size_t blocks = (out.size() - i) / 4;
+        detail::philox_fill(reinterpret_cast<std::byte*>(out.data() + i),
+                            counter_, blocks, stream_, key_);
+        counter_ += blocks;
+        for (i += 4 * blocks; i < out.size(); ++i) out[i] = (*this)();
+    }
+
+    // mesma chave, mesmo fluxo e mesma posição (o buffer pode estar vazio em
+    // um e cheio no outro).
+    friend bool operator==(const philox& a, const philox& b) {
+        return a.key_ == b.key_ && a.stream_ == b.stream_ &&
+               a.position() == b.position();
+    }
+
+   private:
+    // 16 blocos por vez, o tamanho do lote do kernel AVX-512.
+    static constexpr unsigned blocks = 16;
+    static constexpr unsigned words = 4 * blocks;
+
+    void refill() {
+        detail::philox_fill(reinterpret_cast<std::byte*>(buffer_.data()),
+                            counter_, blocks, stream_, key_);
+        counter_ += blocks;
+        index_ = 0;
+    }
+
+    std::uint64_t key_;
+    std::uint64_t stream_;
+    std::uint64_t counter_ = 0;  // próximo bloco a cifrar
+    std::array<result_type, words> buffer_{};
+    unsigned index_ = words;  // próxima palavra de 'buffer_'
+};
+
+namespace detail {
+// inteiro uniforme em [0, s), s > 0, pelo método de Lemire (sem divisão no
+// caso comum).
+inline std::uint64_t bounded(philox& g, std::uint64_t s) {
+    if (s <= std::numeric_limits<std::uint32_t>::max()) {
+        const auto s32 = static_cast<std::uint32_t>(s);
+        std::uint64_t m = std::uint64_t{g()} * s32;
+        if (static_cast<std::uint32_t>(m) < s32) {
+            const std::uint32_t t = -s32 % s32;
+            while (static_cast<std::uint32_t>(m) < t) {
+                m = std::uint64_t{g()} * s32;
+            }
+        }
+        return m >> 32;
+    }
+    auto draw = [&] { return (std::uint64_t{g()} << 32) | g(); };
+    unsigned __int128 m = static_cast<unsigned __int128>(draw()) * s;
+    if (static_cast<std::uint64_t>(m) < s) {
+        const std::uint64_t t = -s % s;
+        while (static_cast<std::uint64_t>(m) < t) {
+            m = static_cast<unsigned __int128>(draw()) * s;
+        }
+    }
+    return static_cast<std::uint64_t>(m >> 64);
+}
+
+// bits aleatórios consumidos um a um.
+class bit_source {
+   public:
+    explicit bit_source(philox& g) : g_(g) {}
+    bool operator()() {
+        if (left_ == 0) {
+            bits_ = g_();
+            left_ = 32;
+        }
+        --left_;
+        const bool b = bits_ & 1;
+        bits_ >>= 1;
+        return b;
+    }
+
+   private:
+    philox& g_;
+    std::uint32_t bits_ = 0;
+    int left_ = 0;
+};
+
+// elementos por segmento de 'generate' e por bloco inicial de 'shuffle'.
+// Cada segmento tem seu próprio fluxo; os limites dependem apenas de 'n'.
+inline constexpr std::size_t segment = 1 << 12;
+inline constexpr std::size_t shuffle_block = 1 << 14;
+
+template <std::random_access_iterator I>
+void fisher_yates(I first, std::size_t n, philox& g) {
+    for (std::size_t i = n; i > 1; --i) {
+        std::ranges::iter_swap(first + (i - 1),
+                               first + static_cast<std::ptrdiff_t>(
+                                           bounded(g, i)));
+    }
+}
+
+// junta [start, mid) e [mid, end), já embaralhados, num embaralhamento
+// uniforme de [start, end): cada posição recebe o próximo elemento de uma das
+// metades, escolhida por um bit aleatório, até uma delas se esgotar; os
+// elementos restantes são inseridos em posições aleatórias, como no
+// Fisher-Yates.
+template <std::random_access_iterator I>
+void merge_shuffled(I t, std::size_t start, std::size_t mid, std::size_t end,
+                    philox& g) {
+    bit_source flip(g);
+    std::size_t i = start, j = mid;
+    // sem desvios dependentes do bit, que seriam mal previstos metade das
+    // vezes: com bit 0 a troca é de 't[i]' consigo mesmo.
+    while (true) {
+        const std::size_t b = flip();
+        if (((j == end) & b) | ((i == j) & !b)) break;
+        std::ranges::iter_swap(t + i, t + (i + (j - i) * b));
+        j += b;
+        ++i;
+    }
+    for (; i < end; ++i) {
+        const std::size_t m = start + bounded(g, i - start + 1);
+        std::ranges::iter_swap(t + i, t + m);
+    }
+}
+
+template <typename R>
+concept random_bits_range =
+    std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+    simd::lane_integral<std::ranges::range_value_t<R>> &&
+    !std::is_const_v<
+        std::remove_reference_t<std::ranges::range_reference_t<R>>>;
+}  // namespace detail
+
+// preenche os bytes de 'r' com o fluxo 0 da semente, em ordem: o elemento 'i'
+// é sempre o mesmo, qualquer que seja a divisão entre threads.
+template <parallel::execution_policy P, detail::random_bits_range R>
+void fill_bits(P&& policy, R&& r, std::uint64_t seed) {
+    const std::size_t bytes =
+        std::ranges::size(r) * sizeof(std::ranges::range_value_t<R>);
+    auto* out = reinterpret_cast<std::byte*>(std::ranges::data(r));
+    const std::size_t blocks = bytes / 16;
+    parallel::for_each_chunk(
+        policy, blocks, parallel::chunk_count(policy, blocks, 1 << 12),
+        [&](std::size_t, std::size_t b, std::size_t e) {
+            detail::philox_fill(out + 16 * b, b, e - b, 0, seed);
+        });
+    if (bytes % 16 != 0) {
+        const detail::block last = detail::philox_block(blocks, 0, seed);
+        std::memcpy(out + 16 * blocks, last.data(), bytes % 16);
+    }
+}
+
+template <detail::random_bits_range R>
+void fill_bits(R&& r, std::uint64_t seed) {
+    fill_bits(std::execution::seq, std::forward<R>(r), seed);
+}
+
+// 'r[i] = gen(g)' para cada elemento, onde 'gen' é uma distribuição (ou outro
+// invocável) e 'g' é um 'philox' próprio do segmento de 'i'. Cada segmento usa
+// uma cópia de 'gen', de modo que distribuições com estado (ex.:
+// 'std::normal_distribution') também produzem resultados reprodutíveis.
+template <parallel::execution_policy P, std::ranges::random_access_range R,
+          std::copy_constructible G>
+    requires std::ranges::sized_range<R> && std::invocable<G&, philox&> &&
+             std::indirectly_writable<std::ranges::iterator_t<R>,
+                                      std::invoke_result_t<G&, philox&>>
+std::ranges::borrowed_iterator_t<R> generate(P&& policy, R&& r,
+                                             std::uint64_t seed, G gen) {
+    auto first = std::ranges::begin(r);
+    const std::size_t n = std::ranges::size(r);
+    const std::size_t segments = (n + detail::segment - 1) / detail::segment;
+    parallel::for_each_chunk(
+        policy, segments, parallel::chunk_count(policy, segments, 4),
+        [&](std::size_t, std::size_t b, std::size_t e) {
+            for (std::size_t s = b; s < e; ++s) {
+                philox g(seed, s);
+                G local = gen;
+                const std::size_t last = std::min(n, (s + 1) * detail::segment);
+                for (std::size_t i = s * detail::segment; i < last; ++i) {
+                    first[static_cast<std::ptrdiff_t>(i)] =
+                        std::invoke(local, g);
+                }
+            }
+        });
+    return first + static_cast<std::ptrdiff_t>(n);
+}
+
+template <std::ranges::random_access_range R, std::copy_constructible G>
+    requires std::ranges::sized_range<R> && std::invocable<G&, philox&> &&
+             std::indirectly_writable<std::ranges::iterator_t<R>,
+                                      std::invoke_result_t<G&, philox&>>
+std::ranges::borrowed_iterator_t<R> generate(R&& r, std::uint64_t seed,
+                                             G gen) {
+    return generate(std::execution::seq, std::forward<R>(r), seed,
+                    std::move(gen));
+}
+
+// MergeShuffle: a range é dividida numa potência de 2 de blocos, embaralhados
+// independentemente com Fisher-Yates; os pares de blocos vizinhos são então
+// unidos por 'merge_shuffled', nível a nível, até restar um único bloco. Cada
+// bloco e cada junção tem seu próprio fluxo, então os níveis são paralelos
+// (só a última junção é sequencial) e o resultado é o mesmo para qualquer
+// número de threads.
+template <parallel::execution_policy P, std::ranges::random_access_range R>
+    requires std::ranges::sized_range<R> &&
+             std::permutable<std::ranges::iterator_t<R>>
+std::ranges::borrowed_iterator_t<R> shuffle(P&& policy, R&& r,
+                                            std::uint64_t seed) {
+    auto first = std::ranges::begin(r);
+    const std::size_t n = std::ranges::size(r);
+    const std::size_t blocks =
+        std::bit_ceil(std::max<std::size_t>(1, n / detail::shuffle_block));
+    auto bound = [&](std::size_t i) {
+        return parallel::chunk_bounds(i, blocks, n).first;
+    };
+    // fluxo da tarefa 'i' do nível 'level' (0 = Fisher-Yates).
+    auto stream = [](std::uint64_t level, std::uint64_t i) {
+        return (level << 48) | i;
+    };
+    auto for_each_task = [&](std::size_t tasks, auto&& task) {
+        parallel::for_each_chunk(
+            policy, tasks, parallel::chunk_count(policy, tasks, 1),
+            [&](std::size_t, std::size_t b, std::size_t e) {
+                for (std::size_t i = b; i < e; ++i) task(i);
+            });
+    };
+    for_each_task(blocks, [&](std::size_t i) {
+        philox g(seed, stream(0, i));
+        detail::fisher_yates(first + static_cast<std::ptrdiff_t>(bound(i)),
+                             bound(i + 1) - bound(i), g);
+    });
+    std::uint64_t level = 1;
+    for (std::size_t width = 1; width < blocks; width *= 2, ++level) {
+        for_each_task(blocks / (2 * width), [&](std::size_t p) {
+            philox g(seed, stream(level, p));
+            detail::merge_shuffled(first, bound(2 * p * width),
+                                   bound((2 * p + 1) * width),
+                                   bound((2 * p + 2) * width), g);
+        });
+    }
+    return first + static_cast<std::ptrdiff_t>(n);
+}
+
+template <std::ranges::random_access_range R>
+    requires std::ranges::sized_range<R> &&
+             std::permutable<std::ranges::iterator_t<R>>
+std::ranges::borrowed_iterator_t<R> shuffle(R&& r, std::uint64_t seed) {
+    return shuffle(std::execution::seq, std::forward<R>(r), seed);
+}
+
+}  // namespace prng
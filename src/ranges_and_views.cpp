@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <boost/type_index.hpp>
+#include <execution>
 #include <iomanip>
 #include <iostream>
 #include <list>
@@ -9,6 +10,12 @@
 #include <unordered_map>
 #include <vector>
 
+#include "chunk_par.hpp"
+#include "flat_hash.hpp"
+#include "memo_view.hpp"
+#include "soa_vector.hpp"
+#include "staged.hpp"
+
 namespace ranges_and_views {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -152,6 +159,52 @@ void main() {
         for (auto& a : v | vw::drop(4)) cout << a;
         cout << endl;
     };
+    {
+        // 'std::views::transform' chama a função a cada desreferência;
+        // 'memo::cache_latest' e 'memo::memoize' guardam os resultados, e a
+        // invalidação do cache é explícita.
+        cout << endl;
+        auto v = vw::iota(0, 9) | rg::to<vector<int>>();
+        int calls = 0;
+        auto square = [&calls](int a) {
+            ++calls;
+            return a * a;
+        };
+        auto even = [](int a) { return a % 2 == 0; };
+        cout << "'v': " << stringify(v) << endl;
+
+        for (int a : v | vw::transform(square) | vw::filter(even)) (void)a;
+        cout << "'v' | transform(square) | filter(even): " << calls
+             << " chamadas de 'square'" << endl;
+        calls = 0;
+        for (int a : v | vw::transform(square) | memo::cache_latest |
+                         vw::filter(even)) {
+            (void)a;
+        }
+        cout << "'v' | transform(square) | memo::cache_latest | filter(even): "
+             << calls << " chamadas de 'square'" << endl;
+
+        calls = 0;
+        auto keys = v | vw::transform(square) | memo::memoize;
+        vector<int> ids = vw::iota(0, 9) | rg::to<vector<int>>();
+        rg::sort(ids, rg::greater{}, [&keys](int i) { return keys[i]; });
+        cout << "keys = 'v' | transform(square) | memo::memoize;" << endl;
+        cout << "std::ranges::sort(ids, greater, keys[i]): " << stringify(ids)
+             << ", " << calls << " chamadas de 'square'" << endl;
+
+        v.push_back(9);
+        cout << "v.push_back(9); keys.stale(): " << std::boolalpha
+             << keys.stale() << endl;
+        try {
+            for (int a : keys) (void)a;
+        } catch (const memo::stale_cache& e) {
+            cout << "for (int a : keys): memo::stale_cache: " << e.what()
+                 << endl;
+        }
+        keys.invalidate();
+        cout << "keys.invalidate(); 'keys': "
+             << stringify(keys | rg::to<vector<int>>()) << endl;
+    };
     {
         cout << endl;
         println("'std::views::keys' e 'std::views::values':");
@@ -170,6 +223,28 @@ void main() {
         rg::copy(vw::values(umap), std::back_inserter(values));
         println("std::views::values('umap'): {}", stringify(values));
     };
+    {
+        // 'std::unordered_map' aloca um nó por elemento, e percorrê-lo
+        // significa seguir um ponteiro por elemento. 'flat_hash::map' guarda
+        // chaves e valores em vetores densos separados: 'keys()' e 'values()'
+        // são 'std::span' (leitura contígua), e 'std::views::keys' e
+        // 'std::views::values' continuam funcionando.
+        cout << endl;
+        println(
+            "'flat_hash::map' com 'std::views::keys' e 'std::views::values':");
+        auto fmap = vw::iota(0, 4) | vw::transform([](int i) {
+                        return std::make_pair(i, i * 0.5);
+                    }) |
+                    rg::to<flat_hash::map<int, double>>();
+        println("flat_hash::map<int, double> 'fmap': {}", stringify(fmap));
+
+        vector<int> keys;
+        rg::copy(vw::keys(fmap), std::back_inserter(keys));
+        println("std::views::keys('fmap'): {}", stringify(keys));
+
+        println("'fmap'.keys(): {}", stringify(fmap.keys()));
+        println("'fmap'.values(): {}", stringify(fmap.values()));
+    };
     {
         cout << endl;
         vector<string> vs{"Cat", "Dog", "Car"};
@@ -188,6 +263,28 @@ void main() {
         rg::copy(data | vw::elements<2>, std::back_inserter(third));
         println("std::views::elements<2>('data'): {}", stringify(third));
     };
+    {
+        // 'soa::soa_vector' guarda cada campo numa coluna contígua:
+        // 'elements<I>()' é um 'std::span' da coluna, e as linhas (proxies
+        // que apontam para as colunas) funcionam com os algoritmos de ranges.
+        cout << endl;
+        soa::soa_vector<int, int, string> cols{
+            {2, 98, "Car"}, {0, 100, "Cat"}, {1, 99, "Dog"}, {0, 100, "Cat"}};
+        println("soa::soa_vector<int, int, string> 'cols'.elements<1>(): {}",
+                stringify(cols.elements<1>()));
+
+        rg::sort(cols);
+        const auto dup = rg::unique(cols);
+        cols.erase(dup.begin(), dup.end());
+        println("std::ranges::sort + unique: 'cols'.elements<2>(): {}",
+                stringify(cols.elements<2>()));
+
+        rg::partition(cols, [](auto row) { return get<2>(row) != "Dog"; });
+        soa::sort(cols, rg::greater{}, [](auto row) { return get<1>(row); });
+        println("soa::sort('cols', greater, coluna 1): 'cols'.elements<0>(): "
+                "{}",
+                stringify(cols.elements<0>()));
+    };
     {
         cout << endl;
         auto v = vw::iota(0, 9) | rg::to<std::vector<int>>();
@@ -229,6 +326,31 @@ void main() {
              << stringify(v | vw::filter([](auto& a) { return a % 2 == 0; }))
              << endl;
     };
+    {
+        // 'chunk_par': a mesma pipeline roda em blocos de 'v' em paralelo, e
+        // as saídas dos blocos são concatenadas na ordem de 'v'.
+        cout << endl;
+        auto v = vw::iota(0, 1 << 20) | rg::to<std::vector<int>>();
+        auto pipe = vw::filter([](int a) { return a % 3 == 0; }) |
+                    vw::transform([](int a) { return a / 3; });
+        vector<int> seq;
+        rg::copy(v | pipe, std::back_inserter(seq));
+        auto par = v | chunk_par::pipeline(std::execution::par, pipe);
+        cout << "'v' = std::views::iota(0, 1 << 20);" << endl;
+        cout << "'v' | chunk_par::pipeline(std::execution::par, "
+                "std::views::filter(...) | std::views::transform(...)): "
+             << par.size() << " elementos, "
+             << (par == seq ? "iguais" : "diferentes")
+             << " aos de 'v' | filter | transform" << endl;
+
+        vector<string> words{"Car", "ros", " e ", "Lan", "chas"};
+        string joined;
+        chunk_par::copy(std::execution::par, words, vw::join,
+                        std::back_inserter(joined));
+        cout << "chunk_par::copy(std::execution::par, 'words', "
+                "std::views::join, ...): "
+             << joined << endl;
+    };
     {
         cout << endl;
         auto v = vw::iota(0, 9) | rg::to<std::vector<int>>();
@@ -382,5 +504,21 @@ void main() {
                           rg::to<vector<double>>())
              << endl;
     };
+    {
+        // 'staged::pipeline': a leitura de 'n', o filtro e a transformação
+        // rodam em threads próprias, ligadas por filas de lotes.
+        cout << endl;
+        std::istringstream n{"1 -2 24 -42 99 82"};
+        cout << "std::istringstream n{\"1 -2 24 -42 99 82\"};" << endl;
+        staged::pipeline p{
+            staged::options{.batch = 2},
+            staged::stage{vw::filter([](int i) { return i > 0; })},
+            staged::stage{vw::transform([](int i) { return i * i; }), 2}};
+        cout << "std::views::istream<int>(n) | staged::pipeline{"
+                "staged::stage{std::views::filter([](int i){return i>0;})}, "
+                "staged::stage{std::views::transform([](int i){return "
+                "i*i;}), 2}}: "
+             << stringify(vw::istream<int>(n) | p) << endl;
+    };
 };
 }  // namespace ranges_and_views
@@ -0,0 +1,463 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <execution>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <vector>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+// Somas e produtos internos de ponto flutuante rápidos e reprodutíveis.
+// 'std::accumulate' não pode ser vetorizado (a ordem das somas é imposta) e
+// 'std::reduce' com política paralela produz resultados que mudam com o
+// número de threads, pois a associação das somas depende da divisão do
+// trabalho. Aqui a ordem das operações é fixa e depende apenas de 'n':
+// - a entrada é dividida em blocos de tamanho fixo;
+// - cada bloco é somado por 16 acumuladores independentes (o elemento 'i' vai
+//   para o acumulador 'i % 16'), que depois são combinados numa árvore fixa;
+// - as somas dos blocos são combinadas numa árvore binária fixa.
+// As versões AVX2, AVX-512 e escalar executam exatamente as mesmas operações
+// (sem contração em FMA), e a versão paralela apenas distribui os blocos entre
+// as threads. Portanto o resultado é idêntico bit a bit entre execuções,
+// quantidade de threads e conjunto de instruções.
+namespace reduction {
+
+enum class summation {
+    fast,      // 16 acumuladores por bloco; erro ~ (n/16) ε no pior caso.
+    pairwise,  // blocos pequenos e árvore binária; erro ~ log2(n) ε.
+    kahan,     // acumuladores compensados (Kahan) e combinação exata.
+};
+
+inline constexpr std::size_t lanes = 16;
+
+template <typename T>
+concept real = std::same_as<T, float> || std::same_as<T, double>;
+
+// soma parcial: 'comp' guarda o erro de arredondamento (apenas em 'kahan').
+template <real T>
+struct partial {
+    T sum{};
+    T comp{};
+};
+
+#pragma GCC push_options
+#pragma GCC optimize("fp-contract=off")
+// os vetores trafegam apenas entre funções expandidas no mesmo kernel.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace detail {
+
+// 'a + b' mais o erro exato do arredondamento (TwoSum de Knuth).
+template <real T>
+partial<T> two_sum(T a, T b) {
+    const T s = a + b;
+    const T bb = s - a;
+    return {s, (a - (s - bb)) + (b - bb)};
+}
+
+template <real T>
+partial<T> combine(summation method, partial<T> a, partial<T> b) {
+    if (method != summation::kahan) return {a.sum + b.sum, T{}};
+    auto [s, e] = two_sum(a.sum, b.sum);
+    return {s, a.comp + b.comp + e};
+}
+
+// vetor de 'Bytes' bytes de elementos 'T' (extensão de vetores do GCC); com
+// 'Bytes == sizeof(T)' é o próprio escalar.
+template <real T, std::size_t Bytes>
+struct vec {
+    typedef T type __attribute__((vector_size(Bytes)));
+};
+template <real T>
+struct vec<T, sizeof(T)> {
+    using type = T;
+};
+
+// fontes de elementos: 'size()' e 'load<V>(i)', que lê os elementos
+// [i, i + W) como um vetor 'V' de W elementos (ou um escalar se W == 1).
+// Outras fontes (ex.: as expressões de 'fused.hpp') seguem o mesmo protocolo.
+template <typename S>
+concept source = real<typename S::value_type> && requires(const S& s) {
+    { s.size() } -> std::convertible_to<std::size_t>;
+    { s.template load<typename S::value_type>(0) }
+        -> std::same_as<typename S::value_type>;
+};
+
+template <real T>
+struct column {
+    using value_type = T;
+    const T* data;
+    std::size_t n;
+
+    std::size_t size() const { return n; }
+    template <typename V>
+    [[gnu::always_inline]] V load(std::size_t i) const {
+        V x;
+        std::memcpy(&x, data + i, sizeof(V));
+        return x;
+    }
+};
+
+template <real T>
+struct product {
+    using value_type = T;
+    column<T> a, b;
+
+    std::size_t size() const { return std::min(a.size(), b.size()); }
+    template <typename V>
+    [[gnu::always_inline]] V load(std::size_t i) const {
+        return a.template load<V>(i) * b.template load<V>(i);
+    }
+};
+
+// acumula os 'groups' grupos completos de 16 elementos de 'src' a partir de
+// 'first' nos acumuladores 'sum'/'comp'. É sempre expandido dentro das funções
+// compiladas para cada ISA, que determinam o código gerado.
+template <std::size_t Bytes, bool Kahan, source S,
+          typename T = typename S::value_type>
+[[gnu::always_inline]] inline void accumulate_groups(const S& src,
+                                                     std::size_t first,
+                                                     std::size_t groups,
+                                                     T* sum, T* comp) {
+    using V = typename vec<T, Bytes>::type;
+    constexpr std::size_t W = Bytes / sizeof(T);
+    constexpr std::size_t NV = lanes / W;
+    V s[NV];
+    V c[NV];
+    std::memcpy(s, sum, sizeof(s));
+    std::memcpy(c, comp, sizeof(c));
+    for (std::size_t g = 0; g < groups; ++g) {
+        for (std::size_t k = 0; k < NV; ++k) {
+            const V x = src.template load<V>(first + g * lanes + k * W);
+            if constexpr (Kahan) {
+                const V y = x - c[k];
+                const V t = s[k] + y;
+                c[k] = (t - s[k]) - y;
+                s[k] = t;
+            } else {
+                s[k] = s[k] + x;
+            }
+        }
+    }
+    std::memcpy(sum, s, sizeof(s));
+    std::memcpy(comp, c, sizeof(c));
+}
+
+template <bool Kahan, typename S, typename T>
+void accumulate_scalar(const S& src, std::size_t first, std::size_t groups,
+                       T* sum, T* comp) {
+    accumulate_groups<sizeof(T), Kahan>(src, first, groups, sum, comp);
+}
+
+#if SIMD_X86
+#pragma GCC push_options
+#pragma GCC target("avx2")
+template <bool Kahan, typename S, typename T>
+void accumulate_avx2(const S& src, std::size_t first, std::size_t groups,
+                     T* sum, T* comp) {
+    accumulate_groups<32, Kahan>(src, first, groups, sum, comp);
+}
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+template <bool Kahan, typename S, typename T>
+void accumulate_avx512(const S& src, std::size_t first, std::size_t groups,
+                       T* sum, T* comp) {
+    accumulate_groups<64, Kahan>(src, first, groups, sum, comp);
+}
+#pragma GCC pop_options
+#endif
+
+// soma do bloco [first, first + n): grupos completos vetorizados, cauda
+// escalar com a mesma atribuição de acumuladores, e combinação dos 16
+// acumuladores em árvore.
+template <bool Kahan, source S, typename T = typename S::value_type>
+partial<T> block(const S& src, std::size_t first, std::size_t n) {
+    T sum[lanes] = {};
+    T comp[lanes] = {};
+    const std::size_t groups = n / lanes;
+#if SIMD_X86
+    switch (simd::active_isa()) {
+        case simd::isa::avx512:
+            accumulate_avx512<Kahan>(src, first, groups, sum, comp);
+            break;
+        case simd::isa::avx2:
+            accumulate_avx2<Kahan>(src, first, groups, sum, comp);
+            break;
+        case simd::isa::scalar:
+            accumulate_scalar<Kahan>(src, first, groups, sum, comp);
+            break;
+    }
+#else
+    accumulate_scalar<Kahan>(src, first, groups, sum, comp);
+#endif
+    for (std::size_t i = groups * lanes; i < n; ++i) {
+        const std::size_t k = i % lanes;
+        const T x = src.template load<T>(first + i);
+        if constexpr (Kahan) {
+            const T y = x - comp[k];
+            const T t = sum[k] + y;
+            comp[k] = (t - sum[k]) - y;
+            sum[k] = t;
+        } else {
+            sum[k] = sum[k] + x;
+        }
+    }
+    const summation method = Kahan ? summation::kahan : summation::fast;
+    partial<T> p[lanes];
+    for (std::size_t k = 0; k < lanes; ++k) p[k] = {sum[k], -comp[k]};
+    for (std::size_t w = lanes / 2; w > 0; w /= 2) {
+        for (std::size_t k = 0; k < w; ++k) {
+            p[k] = combine(method, p[k], p[k + w]);
+        }
+    }
+    return p[0];
+}
+
+// combinação das somas dos blocos numa árvore binária fixa.
+template <real T>
+partial<T> tree(summation method, std::vector<partial<T>>& parts) {
+    if (parts.empty()) return {};
+    for (std::size_t w = 1; w < parts.size(); w *= 2) {
+        for (std::size_t k = 0; k + w < parts.size(); k += 2 * w) {
+            parts[k] = combine(method, parts[k], parts[k + w]);
+        }
+    }
+    return parts[0];
+}
+
+inline std::size_t block_size(summation method) {
+    return method == summation::pairwise ? 256 : 4096;
+}
+
+template <parallel::execution_policy P, source S,
+          typename T = typename S::value_type>
+T reduce(P&& policy, const S& src, summation method) {
+    const std::size_t n = src.size();
+    const std::size_t bs = block_size(method);
+    const std::size_t blocks = (n + bs - 1) / bs;
+    std::vector<partial<T>> parts(blocks);
+    // a divisão em chunks não altera a árvore: cada bloco tem posição fixa.
+    const std::size_t chunks =
+        std::min(blocks, parallel::chunk_count(policy, n));
+    parallel::for_each_chunk(
+        policy, blocks, chunks,
+        [&](std::size_t, std::size_t first, std::size_t last) {
+            for (std::size_t k = first; k < last; ++k) {
+                const std::size_t off = k * bs;
+                const std::size_t len = std::min(bs, n - off);
+                parts[k] = method == summation::kahan
+                               ? block<true>(src, off, len)
+                               : block<false>(src, off, len);
+            }
+        });
+    const partial<T> r = tree(method, parts);
+    return r.sum + r.comp;
+}
+
+}  // namespace detail
+
+#pragma GCC diagnostic pop
+#pragma GCC pop_options
+
+template <typename R>
+concept real_contiguous_range =
+    std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+    real<std::remove_cv_t<std::ranges::range_value_t<R>>>;
+
+// soma reprodutível de uma range contígua de float/double.
+template <parallel::execution_policy P, real_contiguous_range R>
+auto sum(P&& policy, R&& r, summation method = summation::pairwise) {
+    using T = std::remove_cv_t<std::ranges::range_value_t<R>>;
+    return detail::reduce(
+        policy,
+        detail::column<T>{std::ranges::data(r), std::ranges::size(r)}, method);
+}
+
+template <real_contiguous_range R>
+auto sum(R&& r, summation method = summation::pairwise) {
+    return sum(std::execution::seq, r, method);
+}
+
+// produto interno reprodutível ('std::inner_product' / 'transform_reduce'
+// com 'std::plus' e 'std::multiplies'). Usa o menor dos dois tamanhos.
+template <parallel::execution_policy P, real_contiguous_range R1,
+          real_contiguous_range R2>
+    requires std::same_as<std::remove_cv_t<std::ranges::range_value_t<R1>>,
+                          std::remove_cv_t<std::ranges::range_value_t<R2>>>
+auto dot(P&& policy, R1&& r1, R2&& r2, summation method = summation::pairwise) {
+    using T = std::remove_cv_t<std::ranges::range_value_t<R1>>;
+    return detail::reduce(
+        policy,
+        detail::product<T>{{std::ranges::data(r1), std::ranges::size(r1)},
+                           {std::ranges::data(r2), std::ranges::size(r2)}},
+        method);
+}
+
+template <real_contiguous_range R1, real_contiguous_range R2>
+    requires std::same_as<std::remove_cv_t<std::ranges::range_value_t<R1>>,
+                          std::remove_cv_t<std::ranges::range_value_t<R2>>>
+auto dot(R1&& r1, R2&& r2, summation method = summation::pairwise) {
+    return dot(std::execution::seq, r1, r2, method);
+}
+
+// Reduções de monóides não triviais (strings, vetores, agregados).
+// 'std::reduce' combina por 'a + b', que para strings cria um objeto novo a
+// cada passo e copia o acumulador inteiro: O(n²) bytes no total. Aqui o
+// acumulador é sempre modificado no lugar ('acc += x' ou, na falta dele,
+// 'acc = std::move(acc) + x', que reaproveita o buffer de 'std::string') e
+// nunca é copiado; a versão paralela reduz cada bloco separadamente e junta os
+// resultados em ordem, movendo-os. Sequências concatenáveis (string, vector)
+// têm o tamanho final calculado antes, e cada elemento é copiado uma única vez
+// para a sua posição definitiva.
+
+template <typename T, typename U>
+concept accumulable_with =
+    std::movable<T> &&
+    (requires(T& acc, U&& x) { acc += std::forward<U>(x); } ||
+     requires(T& acc, U&& x) { acc = std::move(acc) + std::forward<U>(x); });
+
+// sequências cujo conteúdo pode ser concatenado com tamanho pré-calculado.
+template <typename T>
+concept concatenable =
+    std::ranges::random_access_range<T> && std::ranges::sized_range<T> &&
+    std::default_initializable<std::ranges::range_value_t<T>> &&
+    requires(T& a, const T& b, std::size_t n) {
+        a.reserve(n);
+        a.resize(n);
+        a.insert(a.end(), b.begin(), b.end());
+    };
+
+namespace detail {
+
+template <typename T, typename U>
+void accumulate_into(T& acc, U&& x) {
+    if constexpr (requires { acc += std::forward<U>(x); }) {
+        acc += std::forward<U>(x);
+    } else {
+        acc = std::move(acc) + std::forward<U>(x);
+    }
+}
+
+// range de sequências concatenáveis do mesmo tipo do acumulador.
+template <typename R, typename T>
+concept concatenable_range =
+    concatenable<T> && std::ranges::random_access_range<R> &&
+    std::ranges::sized_range<R> &&
+    std::same_as<std::ranges::range_value_t<R>, T>;
+
+template <typename R, typename Proj>
+using concat_t = std::remove_cvref_t<
+    std::indirect_result_t<Proj&, std::ranges::iterator_t<R>>>;
+
+}  // namespace detail
+
+// concatena 'proj(x)' para cada 'x' de 'r', após 'init'.
+template <parallel::execution_policy P, std::ranges::random_access_range R,
+          typename Proj = std::identity,
+          concatenable T = detail::concat_t<R, Proj>>
+    requires std::ranges::sized_range<R>
+T concat(P&& policy, R&& r, Proj proj = {}, T init = {}) {
+    const std::size_t n = std::ranges::size(r);
+    auto first = std::ranges::begin(r);
+    const std::size_t chunks = parallel::chunk_count(policy, n, 1 << 10);
+    // tamanho de cada bloco, e daí a posição de cada bloco no resultado.
+    std::vector<std::size_t> offsets(chunks + 1, 0);
+    parallel::for_each_chunk(
+        policy, n, chunks, [&](std::size_t i, std::size_t b, std::size_t e) {
+            std::size_t len = 0;
+            for (std::size_t k = b; k < e; ++k) {
+                len += std::ranges::size(std::invoke(proj, first[k]));
+            }
+            offsets[i + 1] = len;
+        });
+    offsets[0] = std::ranges::size(init);
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    if (chunks <= 1) {
+        init.reserve(offsets.back());
+        for (std::size_t k = 0; k < n; ++k) {
+            const auto& x = std::invoke(proj, first[k]);
+            init.insert(init.end(), x.begin(), x.end());
+        }
+        return init;
+    }
+    init.resize(offsets.back());
+    parallel::for_each_chunk(
+        policy, n, chunks, [&](std::size_t i, std::size_t b, std::size_t e) {
+            auto out = init.begin() + offsets[i];
+            for (std::size_t k = b; k < e; ++k) {
+                const auto& x = std::invoke(proj, first[k]);
+                out = std::ranges::copy(x, out).out;
+            }
+        });
+    return init;
+}
+
+template <std::ranges::random_access_range R, typename Proj = std::identity,
+          concatenable T = detail::concat_t<R, Proj>>
+    requires std::ranges::sized_range<R>
+T concat(R&& r, Proj proj = {}, T init = {}) {
+    return concat(std::execution::seq, r, std::move(proj), std::move(init));
+}
+
+// redução em ordem (não exige comutatividade) de um monóide, acumulando no
+// lugar. Quando o acumulador e os elementos são a mesma sequência
+// concatenável, delega para 'concat'.
+template <std::ranges::input_range R, typename T>
+    requires accumulable_with<T, std::ranges::range_reference_t<R>> ||
+             detail::concatenable_range<R, T>
+T reduce(R&& r, T init) {
+    if constexpr (detail::concatenable_range<R, T>) {
+        return concat(r, std::identity{}, std::move(init));
+    } else {
+        for (auto&& x : r) {
+            detail::accumulate_into(init, std::forward<decltype(x)>(x));
+        }
+        return init;
+    }
+}
+
+template <parallel::execution_policy P, std::ranges::random_access_range R,
+          typename T>
+    requires std::ranges::sized_range<R> &&
+             ((accumulable_with<T, std::ranges::range_reference_t<R>> &&
+               accumulable_with<T, T> &&
+               std::constructible_from<T, std::ranges::range_reference_t<R>>) ||
+              detail::concatenable_range<R, T>)
+T reduce(P&& policy, R&& r, T init) {
+    if constexpr (detail::concatenable_range<R, T>) {
+        return concat(policy, r, std::identity{}, std::move(init));
+    } else {
+        const std::size_t n = std::ranges::size(r);
+        auto first = std::ranges::begin(r);
+        const std::size_t chunks = parallel::chunk_count(policy, n, 1 << 10);
+        if (chunks <= 1) return reduce(r, std::move(init));
+        // o bloco 0 parte de 'init'; os demais, do seu primeiro elemento.
+        std::vector<std::optional<T>> parts(chunks);
+        parts[0].emplace(std::move(init));
+        parallel::for_each_chunk(
+            policy, n, chunks,
+            [&](std::size_t i, std::size_t b, std::size_t e) {
+                if (i > 0) parts[i].emplace(first[b++]);
+                for (; b < e; ++b) detail::accumulate_into(*parts[i], first[b]);
+            });
+        T result = std::move(*parts[0]);
+        for (std::size_t i = 1; i < chunks; ++i) {
+            detail::accumulate_into(result, std::move(*parts[i]));
+        }
+        return result;
+    }
+}
+
+}  // namespace reduction
@@ -0,0 +1,409 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <execution>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "parallel.hpp"
+#include "prng.hpp"
+
+// Amostragem aleatória numa única passada, sobre ranges de entrada (inclusive
+// 'views::istream' e fluxos sem fim conhecido), como alternativa a
+// 'std::ranges::sample', que é apenas uniforme, sequencial e só é estável
+// (preserva a ordem) para ranges 'forward'.
+// - 'reservoir' implementa o Algoritmo L (Li, 1994): depois de cheio, o
+//   reservatório calcula diretamente quantos elementos pular até a próxima
+//   substituição, e gasta O(k (1 + log(n / k))) números aleatórios em vez de
+//   um por elemento. Em ranges de acesso aleatório os elementos pulados nem
+//   são lidos.
+// - 'weighted_reservoir' faz amostragem ponderada sem reposição pelo A-ExpJ
+//   (Efraimidis e Spirakis, 2006): cada item recebe a chave 'u^(1 / w)' e são
+//   mantidas as 'k' maiores, com saltos exponenciais sobre o peso acumulado.
+// - Ambos podem ser combinados com 'merge': reservatórios de fluxos disjuntos
+//   (ex.: um por thread) resultam numa amostra do fluxo concatenado com a
+//   mesma distribuição que um único reservatório teria.
+// As versões com política de execução de 'sample' e 'weighted_sample' dividem
+// a range em segmentos fixos, cada um com seu fluxo 'prng::philox', e juntam
+// os reservatórios em árvore: o resultado depende apenas da semente.
+namespace sampling {
+
+namespace detail {
+// uniforme no intervalo aberto (0, 1), com 53 bits.
+template <std::uniform_random_bit_generator G>
+double open_unit(G& g) {
+    std::uniform_int_distribution<std::uint64_t> bits(0, (1ull << 53) - 1);
+    return (static_cast<double>(bits(g)) + 0.5) * 0x1p-53;
+}
+
+template <std::uniform_random_bit_generator G>
+std::size_t below(G& g, std::size_t n) {
+    return std::uniform_int_distribution<std::size_t>(0, n - 1)(g);
+}
+
+// número de elementos a pular no Algoritmo L, dado o limiar 'w'.
+template <std::uniform_random_bit_generator G>
+std::uint64_t skip(G& g, double w) {
+    const double s = std::floor(std::log(open_unit(g)) / std::log1p(-w));
+    return s < 0x1p63 ? static_cast<std::uint64_t>(s)
+                      : std::numeric_limits<std::uint64_t>::max() / 2;
+}
+
+// 'k'-ésima menor de 'n' chaves uniformes: Beta(k, n - k + 1).
+template <std::uniform_random_bit_generator G>
+double order_statistic(G& g, std::size_t k, std::uint64_t n) {
+    const double x = std::gamma_distribution<double>(static_cast<double>(k))(g);
+    const double y =
+        std::gamma_distribution<double>(static_cast<double>(n - k + 1))(g);
+    return x / (x + y);
+}
+
+// referência a um gerador externo, para que 'sample(r, out, k, g)' avance o
+// próprio 'g', como 'std::ranges::sample' (e aceite 'std::random_device').
+template <std::uniform_random_bit_generator G>
+struct generator_ref {
+    using result_type = typename G::result_type;
+    G* g;
+
+    static constexpr result_type min() { return G::min(); }
+    static constexpr result_type max() { return G::max(); }
+    result_type operator()() { return (*g)(); }
+};
+
+// projeção que dá o peso de cada elemento de 'R'.
+template <typename Weight, typename R>
+concept weight_for =
+    std::invocable<Weight&, std::ranges::range_reference_t<R>> &&
+    std::convertible_to<
+        std::invoke_result_t<Weight&, std::ranges::range_reference_t<R>>,
+        double>;
+
+// segmentos das versões paralelas; dependem apenas do tamanho da range.
+inline constexpr std::size_t segment = 1 << 16;
+
+// junta 'parts' em árvore, da esquerda para a direita, em paralelo por nível.
+template <parallel::execution_policy P, typename Reservoir>
+Reservoir merge_tree(P&& policy, std::vector<Reservoir>& parts) {
+    for (std::size_t width = 1; width < parts.size(); width *= 2) {
+        const std::size_t pairs = (parts.size() + 2 * width - 1) / (2 * width);
+        parallel::for_each_chunk(
+            policy, pairs, parallel::chunk_count(policy, pairs, 1),
+            [&](std::size_t, std::size_t b, std::size_t e) {
+                for (std::size_t p = b; p < e; ++p) {
+                    const std::size_t l = 2 * p * width, r = l + width;
+                    if (r < parts.size()) parts[l].merge(std::move(parts[r]));
+                }
+            });
+    }
+    return std::move(parts.front());
+}
+}  // namespace detail
+
+// amostra uniforme de até 'k' elementos de um fluxo, sem reposição.
+template <std::movable T, std::uniform_random_bit_generator G = prng::philox>
+class reservoir {
+   public:
+    // a amostra cresce sob demanda: 'k' pode ser maior do que o fluxo (até
+    // 'SIZE_MAX', para "todos os elementos").
+    explicit reservoir(std::size_t k, G g = G{}) : k_(k), g_(std::move(g)) {}
+
+    template <typename U>
+        requires std::constructible_from<T, U&&>
+    void push(U&& x) {
+        if (k_ == 0) {
+            ++seen_;
+            return;
+        }
+        if (items_.size() < k_) {
+            items_.emplace_back(std::forward<U>(x));
+            if (++seen_ == k_) start();
+            return;
+        }
+        if (seen_ == next_) accept(std::forward<U>(x));
+        ++seen_;
+    }
+
+    // consome uma range inteira; em ranges de acesso aleatório com tamanho
+    // conhecido, apenas os elementos aceitos são lidos.
+    template <std::ranges::input_range R>
+        requires std::constructible_from<T, std::ranges::range_reference_t<R>>
+    void append(R&& r) {
+        if constexpr (std::ranges::random_access_range<R> &&
+                      std::ranges::sized_range<R>) {
+            auto first = std::ranges::begin(r);
+            const auto n = static_cast<std::uint64_t>(std::ranges::size(r));
+            items_.reserve(std::min<std::uint64_t>(k_, items_.size() + n));
+            std::uint64_t i = 0;
+            for (; i < n && items_.size() < k_; ++i) {
+                push(first[static_cast<std::ptrdiff_t>(i)]);
+            }
+            const std::uint64_t base = seen_ - i;
+            const bool full = k_ > 0 && items_.size() == k_;
+            while (full && next_ < base + n) {
+                seen_ = next_;
+                accept(first[static_cast<std::ptrdiff_t>(next_ - base)]);
+            }
+            seen_ = base + n;
+        } else {
+            for (auto&& x : r) push(std::forward<decltype(x)>(x));
+        }
+    }
+
+    // incorpora uma amostra de outro fluxo, disjunto deste, com o mesmo 'k':
+    // cada posição da nova amostra vem de um dos fluxos com probabilidade
+    // proporcional ao número de elementos ainda não escolhidos de cada um
+    // (distribuição hipergeométrica).
+    void merge(reservoir&& other) {
+        if (other.seen_ == 0) return;
+        std::vector<T> a = std::move(items_), b = std::move(other.items_);
+        std::uint64_t na = seen_, nb = other.seen_;
+        const std::size_t m = std::min<std::uint64_t>(k_, na + nb);
+        items_.clear();
+        items_.reserve(m);
+        auto take = [&](std::vector<T>& from) {
+            const std::size_t j = detail::below(g_, from.size());
+            std::swap(from[j], from.back());
+            items_.push_back(std::move(from.back()));
+            from.pop_back();
+        };
+        for (std::size_t j = 0; j < m; ++j) {
+            std::uniform_int_distribution<std::uint64_t> pick(0, na + nb - 1);
+            if (pick(g_) < na) {
+                take(a);
+                --na;
+            } else {
+                take(b);
+                --nb;
+            }
+        }
+        seen_ += other.seen_;
+        other.seen_ = 0;
+        if (seen_ >= k_ && k_ > 0) {
+            // o limiar é independente de quais elementos estão na amostra.
+            w_ = detail::order_statistic(g_, k_, seen_);
+            next_ = seen_ + detail::skip(g_, w_);
+        }
+    }
+
+    std::span<const T> sample() const { return items_; }
+    std::vector<T> take() && { return std::move(items_); }
+    std::uint64_t seen() const { return seen_; }
+    std::size_t capacity() const { return k_; }
+
+   private:
+    void start() {
+        w_ = std::exp(std::log(detail::open_unit(g_)) / k_);
+        next_ = seen_ + detail::skip(g_, w_);
+    }
+
+    template <typename U>
+    void accept(U&& x) {
+        items_[detail::below(g_, k_)] = T(std::forward<U>(x));
+        w_ *= std::exp(std::log(detail::open_unit(g_)) / k_);
+        next_ += detail::skip(g_, w_) + 1;
+    }
+
+    std::size_t k_;
+    G g_;
+    std::vector<T> items_;
+    std::uint64_t seen_ = 0;
+    std::uint64_t next_ = 0;  // índice do próximo elemento aceito
+    double w_ = 0;
+};
+
+// amostra de até 'k' elementos sem reposição, com probabilidade de inclusão
+// proporcional ao peso; pesos não positivos nunca são escolhidos.
+template <std::movable T, std::uniform_random_bit_generator G = prng::philox>
+class weighted_reservoir {
+   public:
+    // como em 'reservoir', a amostra cresce sob demanda.
+    explicit weighted_reservoir(std::size_t k, G g = G{})
+        : k_(k), g_(std::move(g)) {}
+
+    template <typename U>
+        requires std::constructible_from<T, U&&>
+    void push(U&& x, double weight) {
+        if (!(weight > 0) || k_ == 0) return;
+        if (heap_.size() < k_) {
+            // chaves em escala logarítmica: log(u^(1 / w)) = log(u) / w.
+            heap_.push_back({std::log(detail::open_unit(g_)) / weight,
+                             T(std::forward<U>(x))});
+            std::ranges::push_heap(heap_, std::greater{}, &entry::key);
+            if (heap_.size() == k_) jump();
+            return;
+        }
+        remaining_ -= weight;
+        if (remaining_ > 0) return;
+        // a chave do item que ultrapassou o salto é uniforme entre a menor
+        // chave atual e 1.
+        const double t = std::exp(heap_.front().key * weight);
+        const double r = t + (1 - t) * detail::open_unit(g_);
+        std::ranges::pop_heap(heap_, std::greater{}, &entry::key);
+        heap_.back() = {std::log(r) / weight, T(std::forward<U>(x))};
+        std::ranges::push_heap(heap_, std::greater{}, &entry::key);
+        jump();
+    }
+
+    template <std::ranges::input_range R, typename Weight = std::identity>
+        requires std::constructible_from<T, std::ranges::range_reference_t<R>>
+    void append(R&& r, Weight weight) {
+        if constexpr (std::ranges::sized_range<R>) {
+            const auto n = static_cast<std::uint64_t>(std::ranges::size(r));
+            heap_.reserve(std::min<std::uint64_t>(k_, heap_.size() + n));
+        }
+        for (auto&& x : r) {
+            const double w = std::invoke(weight, x);
+            push(std::forward<decltype(x)>(x), w);
+        }
+    }
+
+    // as chaves são independentes por item: a amostra conjunta é formada
+    // pelas 'k' maiores chaves das duas.
+    void merge(weighted_reservoir&& other) {
+        for (auto& e : other.heap_) heap_.push_back(std::move(e));
+        other.heap_.clear();
+        if (heap_.size() > k_) {
+            std::ranges::nth_element(heap_, heap_.begin() + k_, std::greater{},
+                                     &entry::key);
+            heap_.erase(heap_.begin() + k_, heap_.end());
+        }
+        std::ranges::make_heap(heap_, std::greater{}, &entry::key);
+        // os saltos são sem memória: basta sortear um novo.
+        if (heap_.size() == k_) jump();
+    }
+
+    std::vector<T> sample() const {
+        std::vector<T> out;
+        out.reserve(heap_.size());
+        for (const auto& e : heap_) out.push_back(e.value);
+        return out;
+    }
+    std::vector<T> take() && {
+        std::vector<T> out;
+        out.reserve(heap_.size());
+        for (auto& e : heap_) out.push_back(std::move(e.value));
+        return out;
+    }
+    std::size_t capacity() const { return k_; }
+
+   private:
+    struct entry {
+        double key;
+        T value;
+    };
+
+    // peso a acumular até a próxima substituição.
+    void jump() {
+        remaining_ = std::log(detail::open_unit(g_)) / heap_.front().key;
+    }
+
+    std::size_t k_;
+    G g_;
+    std::vector<entry> heap_;  // heap de mínimo pela chave
+    double remaining_ = 0;
+};
+
+// como 'std::ranges::sample', mas numa única passada também sobre ranges de
+// entrada; a ordem dos elementos escolhidos não é preservada.
+template <std::ranges::input_range R, std::weakly_incrementable O,
+          typename G>
+    requires std::indirectly_writable<O, std::ranges::range_value_t<R>> &&
+             std::uniform_random_bit_generator<std::remove_reference_t<G>>
+O sample(R&& r, O out, std::size_t k, G&& g) {
+    using T = std::ranges::range_value_t<R>;
+    using ref = detail::generator_ref<std::remove_reference_t<G>>;
+    reservoir<T, ref> res(k, ref{&g});
+    res.append(std::forward<R>(r));
+    return std::ranges::move(std::move(res).take(), std::move(out)).out;
+}
+
+// versão paralela: segmentos fixos com fluxos próprios, juntados em árvore.
+template <parallel::execution_policy P, std::ranges::random_access_range R,
+          std::weakly_incrementable O>
+    requires std::ranges::sized_range<R> &&
+             std::indirectly_writable<O, std::ranges::range_value_t<R>>
+O sample(P&& policy, R&& r, O out, std::size_t k, std::uint64_t seed) {
+    using T = std::ranges::range_value_t<R>;
+    auto first = std::ranges::begin(r);
+    const std::size_t n = std::ranges::size(r);
+    const std::size_t segments =
+        std::max<std::size_t>(1, (n + detail::segment - 1) / detail::segment);
+    std::vector<reservoir<T>> parts;
+    parts.reserve(segments);
+    for (std::size_t s = 0; s < segments; ++s) {
+        parts.emplace_back(k, prng::philox(seed, s));
+    }
+    parallel::for_each_chunk(
+        policy, segments, parallel::chunk_count(policy, segments, 1),
+        [&](std::size_t, std::size_t b, std::size_t e) {
+            for (std::size_t s = b; s < e; ++s) {
+                const std::size_t lo = s * detail::segment;
+                const std::size_t hi = std::min(n, lo + detail::segment);
+                parts[s].append(std::ranges::subrange(
+                    first + static_cast<std::ptrdiff_t>(lo),
+                    first + static_cast<std::ptrdiff_t>(hi)));
+            }
+        });
+    auto res = detail::merge_tree(policy, parts);
+    return std::ranges::move(std::move(res).take(), std::move(out)).out;
+}
+
+// amostra ponderada sem reposição; 'weight(x)' dá o peso de cada elemento.
+template <std::ranges::input_range R, std::weakly_incrementable O,
+          typename G, typename Weight>
+    requires std::indirectly_writable<O, std::ranges::range_value_t<R>> &&
+             std::uniform_random_bit_generator<std::remove_reference_t<G>> &&
+             detail::weight_for<Weight, R>
+O weighted_sample(R&& r, O out, std::size_t k, G&& g, Weight weight) {
+    using T = std::ranges::range_value_t<R>;
+    using ref = detail::generator_ref<std::remove_reference_t<G>>;
+    weighted_reservoir<T, ref> res(k, ref{&g});
+    res.append(std::forward<R>(r), std::move(weight));
+    return std::ranges::move(std::move(res).take(), std::move(out)).out;
+}
+
+template <parallel::execution_policy P, std::ranges::random_access_range R,
+          std::weakly_incrementable O, typename Weight>
+    requires std::ranges::sized_range<R> &&
+             std::indirectly_writable<O, std::ranges::range_value_t<R>> &&
+             detail::weight_for<Weight, R>
+O weighted_sample(P&& policy, R&& r, O out, std::size_t k, std::uint64_t seed,
+                  Weight weight) {
+    using T = std::ranges::range_value_t<R>;
+    auto first = std::ranges::begin(r);
+    const std::size_t n = std::ranges::size(r);
+    const std::size_t segments =
+        std::max<std::size_t>(1, (n + detail::segment - 1) / detail::segment);
+    std::vector<weighted_reservoir<T>> parts;
+    parts.reserve(segments);
+    for (std::size_t s = 0; s < segments; ++s) {
+        parts.emplace_back(k, prng::philox(seed, s));
+    }
+    parallel::for_each_chunk(
+        policy, segments, parallel::chunk_count(policy, segments, 1),
+        [&](std::size_t, std::size_t b, std::size_t e) {
+            for (std::size_t s = b; s < e; ++s) {
+                const std::size_t lo = s * detail::segment;
+                const std::size_t hi = std::min(n, lo + detail::segment);
+                parts[s].append(
+                    std::ranges::subrange(
+                        first + static_cast<std::ptrdiff_t>(lo),
+                        first + static_cast<std::ptrdiff_t>(hi)),
+                    weight);
+            }
+        });
+    auto res = detail::merge_tree(policy, parts);
+    return std::ranges::move(std::move(res).take(), std::move(out)).out;
+}
+
+}  // namespace sampling
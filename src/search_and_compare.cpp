@@ -11,6 +11,8 @@
 #include <typeinfo>
 #include <vector>
 
+#include "simd_search.hpp"
+
 namespace search_and_compare {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -248,6 +250,31 @@ void main() {
         long count2 = rg::count_if(v, [](int i) { return i > 3; });
         cout << "'res': " << count2 << endl;
     };
+    {
+        // para ranges contíguas de inteiros, 'simd::find', 'simd::count',
+        // 'simd::find_first_of' e 'simd::count_if' são substitutos diretos dos
+        // algoritmos de 'std::ranges', despachando para kernels AVX2/AVX-512.
+        cout << endl;
+        cout << "simd::find(s, ';'), simd::count(s, ';'), "
+                "simd::find_first_of(v, w), simd::count_if(v, [](int i) { "
+                "return i > 3; }):"
+             << endl;
+        string s = "João;Maria;Pedro;Diógenes;";
+        vector<int> v = {1, 0, 5, 8, 3, 3, 3, 2};
+        vector<int> w = {7, 5, 3};
+        cout << "'s': " << s << endl;
+        cout << "'v': " << stringify(v) << endl;
+        cout << "'w': " << stringify(w) << endl;
+        auto it = simd::find(s, ';');
+        cout << "simd::find(s, ';'): posição " << std::distance(s.begin(), it)
+             << endl;
+        cout << "simd::count(s, ';'): " << simd::count(s, ';') << endl;
+        auto it2 = simd::find_first_of(v, w);
+        cout << "simd::find_first_of(v, w): " << *it2
+             << " na posição: " << std::distance(v.begin(), it2) << endl;
+        cout << "simd::count_if(v, [](int i) { return i > 3; }): "
+             << simd::count_if(v, [](int i) { return i > 3; }) << endl;
+    };
     {
         cout << endl;
         cout << "std::ranges::equal(v, w):" << endl;
@@ -295,5 +322,32 @@ void main() {
                           [](int l, int r) { return l - r <= 0; });
         cout << "'res': " << "{" << *first2 << ", " << *second2 << "}" << endl;
     };
+    {
+        // 'simd::adjacent_find', 'simd::search_n', 'simd::mismatch' e
+        // 'simd::equal' retornam os mesmos iteradores que as versões de
+        // 'std::ranges', mas comparam 32-64 bytes por instrução em ranges
+        // contíguas de tipos aritméticos.
+        cout << endl;
+        cout << "simd::adjacent_find(v), simd::search_n(v, 3, 3), "
+                "simd::mismatch(v, w), simd::equal(v, w):"
+             << endl;
+        vector<int> v = {1, 0, 5, 8, 3, 3, 3, 2};
+        vector<int> w = {1, 0, 5, 9, 1, 3, 3, 2};
+        cout << "'v': " << stringify(v) << endl;
+        cout << "'w': " << stringify(w) << endl;
+        auto it = simd::adjacent_find(v);
+        cout << "simd::adjacent_find(v): " << "{" << *it << ", "
+             << *std::next(it) << "} na posição: "
+             << std::distance(v.begin(), it) << endl;
+        auto [first, last] = simd::search_n(v, 3, 3);
+        cout << "simd::search_n(v, 3, 3): "
+             << stringify(rg::subrange(first, last))
+             << " na posição: " << std::distance(v.begin(), first) << endl;
+        auto [first1, second1] = simd::mismatch(v, w);
+        cout << "simd::mismatch(v, w): " << "{" << *first1 << ", " << *second1
+             << "}" << endl;
+        cout << "simd::equal(v, w): " << std::boolalpha << simd::equal(v, w)
+             << endl;
+    };
 };
 }  // namespace search_and_compare
@@ -10,6 +10,8 @@
 #include <typeinfo>
 #include <vector>
 
+#include "normalized_key.hpp"
+
 namespace set_operations {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -177,5 +179,55 @@ void main() {
     //                                       &LabeledValue::value);
     std::ranges::set_intersection(v8, w8, std::back_inserter(r8), cmp8);
     cout << "'r': " << stringify(r8) << endl;
+
+    cout << endl;
+    cout << "std::set_union(v, w, std::back_inserter(r), {}, key, key):"
+         << endl;
+    // com uma chave normalizada (valor decrescente, rótulo crescente) como
+    // projeção, ordenação e operações de conjunto comparam strings de bytes
+    // em vez de chamar um comparador campo a campo.
+    using label_key = normalized_key::encoder<
+        LabeledValue, normalized_key::desc<&LabeledValue::value>,
+        normalized_key::asc<&LabeledValue::label>>;
+    vector<LabeledValue> v9 = {{"b", 1}, {"a", 2}, {"c", 1}, {"a", 1}};
+    vector<LabeledValue> w9 = {{"a", 1}, {"d", 3}, {"c", 1}};
+    normalized_key::sort(v9, label_key{});
+    normalized_key::sort(w9, label_key{});
+    vector<LabeledValue> r9;
+    cout << "'v': " << stringify(v9) << endl;
+    cout << "'w': " << stringify(w9) << endl;
+    std::ranges::set_union(v9, w9, std::back_inserter(r9), {}, label_key{},
+                           label_key{});
+    cout << "'r': " << stringify(r9) << endl;
+
+    cout << endl;
+    cout << "std::set_union(v, w, std::back_inserter(r), {}, key, key), com "
+            "um prefixo de 4 bytes do rótulo na chave:"
+         << endl;
+    // a chave fixa (valor e os 4 primeiros bytes do rótulo) empata "abcdX" e
+    // "abcdY"; como projeção o encoder usa os bytes completos, e as duas
+    // strings continuam distintas.
+    using label_prefix_key = normalized_key::encoder<
+        LabeledValue, normalized_key::asc<&LabeledValue::value>,
+        normalized_key::asc<&LabeledValue::label, 4>>;
+    static_assert(label_prefix_key::fixed && !label_prefix_key::exact);
+    vector<LabeledValue> v10 = {{"abcdX", 1}};
+    vector<LabeledValue> w10 = {{"abcdY", 1}};
+    vector<LabeledValue> r10;
+    std::ranges::set_union(v10, w10, std::back_inserter(r10), {},
+                           label_prefix_key{}, label_prefix_key{});
+    cout << "'r': " << stringify(r10) << endl;
+    const auto at = std::ranges::lower_bound(
+        r10, label_prefix_key::bytes({"abcdZ", 1}), {}, label_prefix_key{});
+    cout << "posição de {abcdZ, 1} em 'r': " << at - r10.begin() << endl;
+    // um prefixo maior que 8 bytes não cabe na chave fixa: o encoder usa só
+    // os bytes.
+    using long_prefix_key =
+        normalized_key::encoder<LabeledValue,
+                                normalized_key::asc<&LabeledValue::label, 12>>;
+    static_assert(!long_prefix_key::fixed);
+    normalized_key::sort(r10, long_prefix_key{});
+    cout << "'r' ordenado por um prefixo de 12 bytes: " << stringify(r10)
+         << endl;
 };
 }  // namespace set_operations
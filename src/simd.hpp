@@ -0,0 +1,152 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_X86 1
+#else
+#define SIMD_X86 0
+#endif
+
+// Infraestrutura comum aos kernels vetorizados do projeto.
+// Os kernels são escritos com intrínsecos de x86 e compilados por função
+// através de '#pragma GCC target', de forma que o binário continua
+// executável em qualquer máquina x86-64. A escolha do conjunto de instruções
+// (ISA) é feita em tempo de execução, uma única vez, por 'simd::active_isa()'.
+namespace simd {
+
+enum class isa { scalar, avx2, avx512 };
+
+inline isa detect_isa() {
+#if SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") &&
+        __builtin_cpu_supports("avx512bw") &&
+        __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("bmi2") &&
+        __builtin_cpu_supports("popcnt")) {
+        return isa::avx512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi") &&
+        __builtin_cpu_supports("popcnt")) {
+        return isa::avx2;
+    }
+#endif
+    return isa::scalar;
+}
+
+// permite rebaixar o ISA (útil para comparar os caminhos entre si).
+inline isa& isa_override() {
+    static isa forced = detect_isa();
+    return forced;
+}
+
+inline isa active_isa() { return isa_override(); }
+
+inline void force_isa(isa i) {
+    isa_override() = i <= detect_isa() ? i : detect_isa();
+}
+
+// tipos inteiros cuja igualdade equivale à igualdade bit a bit, e portanto
+// podem ser comparados diretamente por instruções 'cmpeq'.
+template <typename T>
+concept lane_integral =
+    std::integral<T> && !std::same_as<std::remove_cv_t<T>, bool> &&
+    (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+// tipos aritméticos (inteiros e ponto flutuante) suportados pelos kernels.
+template <typename T>
+concept lane_arithmetic =
+    lane_integral<T> ||
+    std::same_as<std::remove_cv_t<T>, float> ||
+    std::same_as<std::remove_cv_t<T>, double>;
+
+// range contígua de elementos aptos aos kernels inteiros.
+template <typename R>
+concept integral_contiguous_range =
+    std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+    lane_integral<std::ranges::range_value_t<R>>;
+
+template <typename R>
+concept arithmetic_contiguous_range =
+    std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+    lane_arithmetic<std::ranges::range_value_t<R>>;
+
+// reinterpreta o elemento como o inteiro sem sinal de mesma largura.
+template <std::size_t N>
+using uint_of_size_t = std::conditional_t<
+    N == 1, std::uint8_t,
+    std::conditional_t<N == 2, std::uint16_t,
+                       std::conditional_t<N == 4, std::uint32_t,
+                                          std::uint64_t>>>;
+
+// elementos trivialmente copiáveis que os kernels movem como inteiros de
+// mesma largura, sem olhar o conteúdo.
+template <typename T>
+concept lane_movable =
+    std::is_trivially_copyable_v<T> &&
+    (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+namespace detail {
+template <typename O>
+struct back_inserted {
+    static constexpr bool value = false;
+};
+template <typename C>
+struct back_inserted<std::back_insert_iterator<C>> {
+    static constexpr bool value = true;
+    using container = C;
+};
+
+// acesso ao container de um 'back_insert_iterator' (membro protegido).
+template <typename C>
+struct back_insert_access : std::back_insert_iterator<C> {
+    static C& container_of(std::back_insert_iterator<C>& it) {
+        return *(it.*&back_insert_access::container);
+    }
+};
+
+// destinos que aceitam 'n' elementos contíguos de 'T' de uma vez: iteradores
+// contíguos e 'back_inserter' de containers contíguos redimensionáveis.
+template <typename O, typename T>
+concept contiguous_output =
+    (std::contiguous_iterator<O> && std::same_as<std::iter_value_t<O>, T> &&
+     std::indirectly_writable<O, const T&>) ||
+    (back_inserted<O>::value &&
+     requires(typename back_inserted<O>::container& c, std::size_t n) {
+         requires std::ranges::contiguous_range<decltype(c)>;
+         requires std::same_as<std::ranges::range_value_t<decltype(c)>, T>;
+         c.resize(n);
+     });
+
+// ponteiro para 'n' posições de saída a partir de 'out'.
+template <typename T, typename O>
+T* output_for(O& out, std::size_t n) {
+    if constexpr (back_inserted<O>::value) {
+        auto& c = back_insert_access<typename back_inserted<O>::container>::
+            container_of(out);
+        const std::size_t old = std::ranges::size(c);
+        c.resize(old + n);
+        return std::ranges::data(c) + old;
+    } else {
+        return std::to_address(out);
+    }
+}
+
+template <typename O>
+O advanced(O out, std::size_t n) {
+    if constexpr (back_inserted<O>::value) {
+        return out;
+    } else {
+        return out + n;
+    }
+}
+}  // namespace detail
+
+}  // namespace simd
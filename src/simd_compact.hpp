@@ -0,0 +1,424 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <execution>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <ranges>
+#include <vector>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+// Compactação de fluxos ('stream compaction'): 'remove_if', 'erase_if' e
+// 'compact_copy_if' para ranges contíguas de elementos aritméticos.
+// O predicado é avaliado em blocos de 64 elementos, gerando uma máscara de
+// bits (sem desvios, como em 'simd::count_if'), e os elementos selecionados
+// são empacotados por instruções de compressão:
+// - AVX-512: 'vpcompressd'/'vpcompressq' (e 'vpcompressb'/'vpcompressw' com
+//   VBMI2) seguidos de um store mascarado;
+// - AVX2: não há compressão; ela é emulada por 'vpermd' com índices obtidos
+//   de uma tabela indexada pela máscara e um 'vpmaskmov';
+// - demais casos: percorre apenas os bits ligados da máscara.
+// Nas versões com política de execução paralela as máscaras são guardadas
+// (1 bit por elemento), cada bloco conta seus elementos, uma soma de prefixos
+// determina a posição de saída de cada bloco e o 'scatter' é feito em paralelo.
+namespace simd {
+
+namespace scalar {
+// copia para 'out' os elementos de 'in' com o bit correspondente em 'mask'.
+template <lane_arithmetic T>
+std::size_t compress(const T* in, std::uint64_t mask, T* out) {
+    std::size_t k = 0;
+    for (; mask; mask &= mask - 1) out[k++] = in[std::countr_zero(mask)];
+    return k;
+}
+}  // namespace scalar
+
+#if SIMD_X86
+namespace detail {
+// índices (um byte por índice de 32 bits) dos elementos selecionados por uma
+// máscara de 8 bits, em ordem; usados para emular a compressão com 'vpermd'.
+constexpr std::array<std::uint64_t, 256> compress_lut32 = [] {
+    std::array<std::uint64_t, 256> t{};
+    for (unsigned m = 0; m < 256; ++m) {
+        unsigned k = 0;
+        for (unsigned j = 0; j < 8; ++j) {
+            if (m >> j & 1) t[m] |= std::uint64_t{j} << (8 * k++);
+        }
+    }
+    return t;
+}();
+
+// o mesmo para elementos de 64 bits (4 por vetor): pares de índices de 32.
+constexpr std::array<std::uint64_t, 16> compress_lut64 = [] {
+    std::array<std::uint64_t, 16> t{};
+    for (unsigned m = 0; m < 16; ++m) {
+        unsigned k = 0;
+        for (unsigned j = 0; j < 4; ++j) {
+            if (m >> j & 1) {
+                t[m] |= std::uint64_t{2 * j} << (8 * k++);
+                t[m] |= std::uint64_t{2 * j + 1} << (8 * k++);
+            }
+        }
+    }
+    return t;
+}();
+
+inline bool has_vbmi2() {
+    static const bool b = (__builtin_cpu_init(),
+                           __builtin_cpu_supports("avx512vbmi2"));
+    return b;
+}
+}  // namespace detail
+
+#pragma GCC push_options
+#pragma GCC target("avx2,bmi,popcnt")
+namespace avx2 {
+// 64 elementos de 32 ou 64 bits; os stores nunca passam de 'out + popcount'.
+template <lane_arithmetic T>
+    requires(sizeof(T) >= 4)
+std::size_t compress(const T* in, std::uint64_t mask, T* out) {
+    constexpr std::size_t L = 32 / sizeof(T);
+    const __m256i iota = sizeof(T) == 4
+                             ? _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)
+                             : _mm256_setr_epi64x(0, 1, 2, 3);
+    std::size_t k = 0;
+    for (std::size_t j = 0; j < 64; j += L, mask >>= L) {
+        const unsigned m = static_cast<unsigned>(mask & ((1u << L) - 1));
+        const std::uint64_t lut = sizeof(T) == 4 ? detail::compress_lut32[m]
+                                                 : detail::compress_lut64[m];
+        const __m256i idx = _mm256_cvtepu8_epi32(
+            _mm_cvtsi64_si128(static_cast<long long>(lut)));
+        const __m256i v = _mm256_permutevar8x32_epi32(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + j)), idx);
+        const int c = std::popcount(m);
+        if constexpr (sizeof(T) == 4) {
+            _mm256_maskstore_epi32(
+                reinterpret_cast<int*>(out + k),
+                _mm256_cmpgt_epi32(_mm256_set1_epi32(c), iota), v);
+        } else {
+            _mm256_maskstore_epi64(
+                reinterpret_cast<long long*>(out + k),
+                _mm256_cmpgt_epi64(_mm256_set1_epi64x(c), iota), v);
+        }
+        k += c;
+    }
+    return k;
+}
+}  // namespace avx2
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512bw,avx512vl,bmi,bmi2,popcnt")
+namespace avx512 {
+template <lane_arithmetic T>
+    requires(sizeof(T) >= 4)
+std::size_t compress(const T* in, std::uint64_t mask, T* out) {
+    constexpr std::size_t L = 64 / sizeof(T);
+    std::size_t k = 0;
+    for (std::size_t j = 0; j < 64; j += L, mask >>= L) {
+        const __m512i v = _mm512_loadu_si512(in + j);
+        const unsigned c = std::popcount(mask & ((1ull << L) - 1));
+        if constexpr (sizeof(T) == 4) {
+            const __mmask16 m = static_cast<__mmask16>(mask);
+            _mm512_mask_storeu_epi32(out + k, _bzhi_u32(~0u, c),
+                                     _mm512_maskz_compress_epi32(m, v));
+        } else {
+            const __mmask8 m = static_cast<__mmask8>(mask);
+            _mm512_mask_storeu_epi64(out + k, _bzhi_u32(~0u, c),
+                                     _mm512_maskz_compress_epi64(m, v));
+        }
+        k += c;
+    }
+    return k;
+}
+}  // namespace avx512
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512bw,avx512vl,avx512vbmi2,bmi,bmi2,popcnt")
+namespace avx512 {
+template <lane_arithmetic T>
+    requires(sizeof(T) <= 2)
+std::size_t compress(const T* in, std::uint64_t mask, T* out) {
+    if constexpr (sizeof(T) == 1) {
+        const __m512i v = _mm512_loadu_si512(in);
+        const unsigned c = std::popcount(mask);
+        _mm512_mask_storeu_epi8(out, _bzhi_u64(~0ull, c),
+                                _mm512_maskz_compress_epi8(mask, v));
+        return c;
+    } else {
+        std::size_t k = 0;
+        for (std::size_t j = 0; j < 64; j += 32, mask >>= 32) {
+            const __mmask32 m = static_cast<__mmask32>(mask);
+            const unsigned c = std::popcount(m);
+            _mm512_mask_storeu_epi16(
+                out + k, _bzhi_u32(~0u, c),
+                _mm512_maskz_compress_epi16(m, _mm512_loadu_si512(in + j)));
+            k += c;
+        }
+        return k;
+    }
+}
+}  // namespace avx512
+#pragma GCC pop_options
+#endif
+
+// empacota um bloco completo de 64 elementos de 'in' segundo 'mask'.
+// 'out' pode ser igual ou anterior a 'in' (compactação no lugar): cada vetor é
+// lido antes de ser escrito, e nunca além do fim do vetor corrente.
+template <lane_arithmetic T>
+std::size_t compress_block(const T* in, std::uint64_t mask, T* out) {
+#if SIMD_X86
+    switch (active_isa()) {
+        case isa::avx512:
+            if constexpr (sizeof(T) >= 4) {
+                return avx512::compress(in, mask, out);
+            } else {
+                if (detail::has_vbmi2()) return avx512::compress(in, mask, out);
+                break;
+            }
+        case isa::avx2:
+            if constexpr (sizeof(T) >= 4) return avx2::compress(in, mask, out);
+            break;
+        case isa::scalar:
+            break;
+    }
+#endif
+    return scalar::compress(in, mask, out);
+}
+
+namespace detail {
+// máscara dos 'len' (<= 64) elementos de 'p' que satisfazem 'pred'.
+template <typename T, typename Pred, typename Proj>
+std::uint64_t select_mask(const T* p, std::size_t len, Pred& pred,
+                          Proj& proj) {
+    std::uint64_t mask = 0;
+    for (std::size_t j = 0; j < len; ++j) {
+        mask |= std::uint64_t{static_cast<bool>(
+                    std::invoke(pred, std::invoke(proj, p[j])))}
+                << j;
+    }
+    return mask;
+}
+
+// compacta [in, in + n) em 'out' mantendo os elementos para os quais
+// 'pred(proj(x)) != Remove'; devolve o número de elementos escritos.
+template <bool Remove, typename T, typename Pred, typename Proj>
+std::size_t compact(const T* in, std::size_t n, T* out, Pred& pred,
+                    Proj& proj) {
+    std::size_t k = 0;
+    for (std::size_t i = 0; i < n; i += 64) {
+        const std::size_t len = std::min<std::size_t>(64, n - i);
+        std::uint64_t mask = select_mask(in + i, len, pred, proj);
+        if constexpr (Remove) mask = ~mask & (~0ull >> (64 - len));
+        k += len == 64 ? compress_block(in + i, mask, out + k)
+                       : scalar::compress(in + i, mask, out + k);
+    }
+    return k;
+}
+
+// versão paralela em duas passadas; 'out' não pode sobrepor 'in'.
+template <bool Remove, typename T, parallel::execution_policy P,
+          typename Pred, typename Proj>
+std::size_t compact(P&& policy, const T* in, std::size_t n, T* out,
+                    Pred& pred, Proj& proj) {
+    const std::size_t blocks = (n + 63) / 64;
+    const std::size_t chunks =
+        std::min(blocks, parallel::chunk_count(policy, n));
+    if (chunks <= 1) return compact<Remove>(in, n, out, pred, proj);
+    std::vector<std::uint64_t> masks(blocks);
+    std::vector<std::size_t> offsets(chunks + 1, 0);
+    // 1. máscaras e contagem por chunk (em blocos de 64 elementos).
+    parallel::for_each_chunk(
+        policy, blocks, chunks,
+        [&](std::size_t c, std::size_t b, std::size_t e) {
+            std::size_t count = 0;
+            for (std::size_t k = b; k < e; ++k) {
+                const std::size_t len = std::min<std::size_t>(64, n - 64 * k);
+                std::uint64_t mask = select_mask(in + 64 * k, len, pred, proj);
+                if constexpr (Remove) mask = ~mask & (~0ull >> (64 - len));
+                masks[k] = mask;
+                count += std::popcount(mask);
+            }
+            offsets[c + 1] = count;
+        });
+    // 2. soma de prefixos: posição de saída de cada chunk.
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    // 3. scatter.
+    parallel::for_each_chunk(
+        policy, blocks, chunks,
+        [&](std::size_t c, std::size_t b, std::size_t e) {
+            T* o = out + offsets[c];
+            for (std::size_t k = b; k < e; ++k) {
+                o += 64 * k + 64 <= n
+                         ? compress_block(in + 64 * k, masks[k], o)
+                         : scalar::compress(in + 64 * k, masks[k], o);
+            }
+        });
+    return offsets.back();
+}
+
+template <typename R>
+concept compactable_range =
+    std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+    lane_arithmetic<std::ranges::range_value_t<R>>;
+
+template <typename R, typename O>
+concept compactable_output =
+    compactable_range<R> && std::contiguous_iterator<O> &&
+    std::same_as<std::iter_value_t<O>, std::ranges::range_value_t<R>>;
+
+template <typename Pred, typename Proj>
+auto composed(Pred& pred, Proj& proj) {
+    return [&](auto&& x) -> bool {
+        return std::invoke(pred, std::invoke(proj, x));
+    };
+}
+}  // namespace detail
+
+// 'std::ranges::remove_if' com compactação vetorizada. Como no original, os
+// elementos em [ret.begin(), ret.end()) ficam com valores não especificados.
+struct remove_if_fn {
+    template <std::ranges::forward_range R, typename Proj = std::identity,
+              std::indirect_unary_predicate<
+                  std::projected<std::ranges::iterator_t<R>, Proj>>
+                  Pred>
+        requires std::permutable<std::ranges::iterator_t<R>>
+    std::ranges::borrowed_subrange_t<R> operator()(R&& r, Pred pred,
+                                                   Proj proj = {}) const {
+        if constexpr (detail::compactable_range<R>) {
+            auto* p = std::ranges::data(r);
+            const std::size_t n = std::ranges::size(r);
+            const std::size_t k = detail::compact<true>(p, n, p, pred, proj);
+            return {std::ranges::begin(r) + k, std::ranges::begin(r) + n};
+        } else {
+            return std::ranges::remove_if(r, std::move(pred), std::move(proj));
+        }
+    }
+
+    // paralelo: os elementos mantidos são compactados num buffer temporário
+    // (duas passadas) e copiados de volta em paralelo.
+    template <parallel::execution_policy P,
+              std::ranges::random_access_range R,
+              typename Proj = std::identity,
+              std::indirect_unary_predicate<
+                  std::projected<std::ranges::iterator_t<R>, Proj>>
+                  Pred>
+        requires std::ranges::sized_range<R> &&
+                 std::permutable<std::ranges::iterator_t<R>>
+    std::ranges::borrowed_subrange_t<R> operator()(P&& policy, R&& r,
+                                                   Pred pred,
+                                                   Proj proj = {}) const {
+        auto first = std::ranges::begin(r);
+        const std::size_t n = std::ranges::size(r);
+        if constexpr (detail::compactable_range<R>) {
+            using T = std::ranges::range_value_t<R>;
+            if (parallel::chunk_count(policy, n) <= 1) {
+                return (*this)(r, std::move(pred), std::move(proj));
+            }
+            auto* p = std::ranges::data(r);
+            std::unique_ptr<T[]> tmp(new T[n]);
+            const std::size_t k =
+                detail::compact<true>(policy, p, n, tmp.get(), pred, proj);
+            std::copy(policy, tmp.get(), tmp.get() + k, p);
+            return {first + k, first + n};
+        } else {
+            auto last = std::remove_if(policy, first, first + n,
+                                       detail::composed(pred, proj));
+            return {last, first + n};
+        }
+    }
+};
+inline constexpr remove_if_fn remove_if{};
+
+// 'std::erase_if' para containers sequenciais, com projeção; devolve o número
+// de elementos removidos.
+struct erase_if_fn {
+    template <std::ranges::forward_range C, typename Proj = std::identity,
+              std::indirect_unary_predicate<
+                  std::projected<std::ranges::iterator_t<C>, Proj>>
+                  Pred>
+        requires requires(C& c) { c.erase(c.begin(), c.end()); }
+    std::size_t operator()(C& c, Pred pred, Proj proj = {}) const {
+        auto [first, last] = remove_if(c, std::move(pred), std::move(proj));
+        const auto removed =
+            static_cast<std::size_t>(std::ranges::distance(first, last));
+        c.erase(first, last);
+        return removed;
+    }
+
+    template <parallel::execution_policy P, std::ranges::random_access_range C,
+              typename Proj = std::identity,
+              std::indirect_unary_predicate<
+                  std::projected<std::ranges::iterator_t<C>, Proj>>
+                  Pred>
+        requires requires(C& c) { c.erase(c.begin(), c.end()); }
+    std::size_t operator()(P&& policy, C& c, Pred pred, Proj proj = {}) const {
+        auto [first, last] =
+            remove_if(policy, c, std::move(pred), std::move(proj));
+        const auto removed = static_cast<std::size_t>(last - first);
+        c.erase(first, last);
+        return removed;
+    }
+};
+inline constexpr erase_if_fn erase_if{};
+
+// 'std::ranges::copy_if' com compactação vetorizada quando 'out' é um
+// iterador contíguo do mesmo tipo de elemento (ex.: 'vector::iterator' de
+// um vetor pré-dimensionado com 'simd::count_if'). 'out' deve ter espaço para
+// todos os elementos selecionados e não pode sobrepor a entrada.
+struct compact_copy_if_fn {
+    template <std::ranges::input_range R, std::weakly_incrementable O,
+              typename Proj = std::identity,
+              std::indirect_unary_predicate<
+                  std::projected<std::ranges::iterator_t<R>, Proj>>
+                  Pred>
+        requires std::indirectly_copyable<std::ranges::iterator_t<R>, O>
+    std::ranges::copy_if_result<std::ranges::borrowed_iterator_t<R>, O>
+    operator()(R&& r, O out, Pred pred, Proj proj = {}) const {
+        if constexpr (detail::compactable_output<R, O>) {
+            const std::size_t n = std::ranges::size(r);
+            const std::size_t k = detail::compact<false>(
+                std::ranges::data(r), n, std::to_address(out), pred, proj);
+            return {std::ranges::begin(r) + n, out + k};
+        } else {
+            return std::ranges::copy_if(r, std::move(out), std::move(pred),
+                                        std::move(proj));
+        }
+    }
+
+    template <parallel::execution_policy P,
+              std::ranges::random_access_range R,
+              std::random_access_iterator O, typename Proj = std::identity,
+              std::indirect_unary_predicate<
+                  std::projected<std::ranges::iterator_t<R>, Proj>>
+                  Pred>
+        requires std::ranges::sized_range<R> &&
+                 std::indirectly_copyable<std::ranges::iterator_t<R>, O>
+    std::ranges::copy_if_result<std::ranges::borrowed_iterator_t<R>, O>
+    operator()(P&& policy, R&& r, O out, Pred pred, Proj proj = {}) const {
+        auto first = std::ranges::begin(r);
+        const std::size_t n = std::ranges::size(r);
+        if constexpr (detail::compactable_output<R, O>) {
+            const std::size_t k =
+                detail::compact<false>(policy, std::ranges::data(r), n,
+                                       std::to_address(out), pred, proj);
+            return {first + n, out + k};
+        } else {
+            return {first + n,
+                    std::copy_if(policy, first, first + n, std::move(out),
+                                 detail::composed(pred, proj))};
+        }
+    }
+};
+inline constexpr compact_copy_if_fn compact_copy_if{};
+
+}  // namespace simd
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include "simd.hpp"
+#include "simd_search.hpp"
+
+// Versões de 'lexicographical_compare' e 'lexicographical_compare_three_way'
+// para ranges contíguas de inteiros: a comparação se resume a achar a
+// primeira posição diferente ('mismatch' vetorizado) e comparar um único par
+// de elementos. Bytes sem sinal ('unsigned char', 'char8_t', 'std::byte' e
+// chaves codificadas em big-endian) vão direto para 'memcmp', cuja ordem é a
+// mesma.
+// O caminho rápido vale para os comparadores padrão ('less', 'greater' e
+// 'compare_three_way') sem projeções; os demais casos usam o algoritmo da stl.
+namespace simd {
+
+namespace detail {
+// elementos cuja ordem é a de 'memcmp'.
+template <typename T>
+concept byte_ordered =
+    std::same_as<T, unsigned char> || std::same_as<T, char8_t> ||
+    std::same_as<T, std::byte> ||
+    (std::same_as<T, char> && !std::is_signed_v<char>);
+
+template <typename R1, typename R2>
+concept lexicographic_path =
+    std::ranges::contiguous_range<R1> && std::ranges::sized_range<R1> &&
+    std::ranges::contiguous_range<R2> && std::ranges::sized_range<R2> &&
+    std::same_as<std::remove_cv_t<std::ranges::range_value_t<R1>>,
+                 std::remove_cv_t<std::ranges::range_value_t<R2>>> &&
+    (lane_integral<std::ranges::range_value_t<R1>> ||
+     byte_ordered<std::remove_cv_t<std::ranges::range_value_t<R1>>>);
+
+// +1 para comparadores equivalentes a '<', -1 para '>' e 0 para os demais.
+template <typename Comp, typename T>
+constexpr int order_of() {
+    if constexpr (std::same_as<Comp, std::ranges::less> ||
+                  std::same_as<Comp, std::less<>> ||
+                  std::same_as<Comp, std::less<T>>) {
+        return 1;
+    } else if constexpr (std::same_as<Comp, std::ranges::greater> ||
+                         std::same_as<Comp, std::greater<>> ||
+                         std::same_as<Comp, std::greater<T>>) {
+        return -1;
+    } else {
+        return 0;
+    }
+}
+
+// sinal da comparação do primeiro par diferente em [0, n), ou 0.
+template <typename T>
+int first_difference(const T* a, const T* b, std::size_t n) {
+    if constexpr (byte_ordered<T>) {
+        if (n == 0) return 0;
+        const int c = std::memcmp(a, b, n);
+        return (c > 0) - (c < 0);
+    } else {
+        const std::size_t i = mismatch_index(a, b, n);
+        if (i == n) return 0;
+        return a[i] < b[i] ? -1 : 1;
+    }
+}
+
+template <typename R1, typename R2>
+int first_difference(R1& r1, R2& r2) {
+    using T = std::remove_cv_t<std::ranges::range_value_t<R1>>;
+    const std::size_t n =
+        std::min<std::size_t>(std::ranges::size(r1), std::ranges::size(r2));
+    return first_difference<T>(std::ranges::data(r1), std::ranges::data(r2),
+                               n);
+}
+}  // namespace detail
+
+struct lexicographical_compare_fn {
+    template <std::ranges::input_range R1, std::ranges::input_range R2,
+              typename Proj1 = std::identity, typename Proj2 = std::identity,
+              std::indirect_strict_weak_order<
+                  std::projected<std::ranges::iterator_t<R1>, Proj1>,
+                  std::projected<std::ranges::iterator_t<R2>, Proj2>>
+                  Comp = std::ranges::less>
+    constexpr bool operator()(R1&& r1, R2&& r2, Comp comp = {},
+                              Proj1 proj1 = {}, Proj2 proj2 = {}) const {
+        using T = std::remove_cv_t<std::ranges::range_value_t<R1>>;
+        constexpr int order = detail::order_of<Comp, T>();
+        if constexpr (detail::lexicographic_path<R1, R2> && order != 0 &&
+                      std::same_as<Proj1, std::identity> &&
+                      std::same_as<Proj2, std::identity>) {
+            if (!std::is_constant_evaluated()) {
+                const int c = detail::first_difference(r1, r2);
+                if (c != 0) return c == -order;
+                return std::ranges::size(r1) < std::ranges::size(r2);
+            }
+        }
+        return std::ranges::lexicographical_compare(
+            r1, r2, std::move(comp), std::move(proj1), std::move(proj2));
+    }
+};
+inline constexpr lexicographical_compare_fn lexicographical_compare{};
+
+// como 'std::lexicographical_compare_three_way', sobre ranges.
+struct lexicographical_compare_three_way_fn {
+    template <std::ranges::input_range R1, std::ranges::input_range R2,
+              typename Comp = std::compare_three_way>
+        requires requires(Comp& comp, std::ranges::range_reference_t<R1> a,
+                          std::ranges::range_reference_t<R2> b) {
+            { comp(a, b) } -> std::convertible_to<std::partial_ordering>;
+        }
+    constexpr auto operator()(R1&& r1, R2&& r2, Comp comp = {}) const
+        -> decltype(comp(*std::ranges::begin(r1), *std::ranges::begin(r2))) {
+        using O =
+            decltype(comp(*std::ranges::begin(r1), *std::ranges::begin(r2)));
+        if constexpr (detail::lexicographic_path<R1, R2> &&
+                      std::same_as<Comp, std::compare_three_way>) {
+            if (!std::is_constant_evaluated()) {
+                const int c = detail::first_difference(r1, r2);
+                if (c != 0) return c <=> 0;
+                return std::ranges::size(r1) <=> std::ranges::size(r2);
+            }
+        }
+        auto f1 = std::ranges::begin(r1);
+        auto f2 = std::ranges::begin(r2);
+        const auto l1 = std::ranges::end(r1);
+        const auto l2 = std::ranges::end(r2);
+        for (; f1 != l1 && f2 != l2; ++f1, ++f2) {
+            if (O c = comp(*f1, *f2); c != 0) return c;
+        }
+        if (f1 != l1) return std::strong_ordering::greater;
+        if (f2 != l2) return std::strong_ordering::less;
+        return std::strong_ordering::equal;
+    }
+};
+inline constexpr lexicographical_compare_three_way_fn
+    lexicographical_compare_three_way{};
+
+}  // namespace simd
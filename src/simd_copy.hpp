@@ -0,0 +1,555 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <execution>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#endif
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+// Motor de cópia, movimentação e preenchimento de grandes blocos de memória
+// para elementos trivialmente copiáveis: 'copy', 'copy_n', 'copy_backward',
+// 'move', 'move_backward', 'fill', 'fill_n' e 'relocate'.
+// - Acima de 'streaming_threshold()' bytes (por padrão, o tamanho da cache de
+//   último nível) as escritas usam stores não temporais ('movntdq'), que vão
+//   direto para a memória sem expulsar da cache os dados do resto do
+//   processo; abaixo disso um 'memcpy' é mais rápido, pois o destino costuma
+//   ser lido logo em seguida.
+// - Com uma política de execução paralela, o bloco é dividido entre threads.
+// - Origem e destino podem se sobrepor em qualquer sentido (como 'memmove'):
+//   a cópia é feita em ondas do tamanho da distância entre eles, e dentro de
+//   cada onda não há sobreposição. Isso cobre o 'copy_backward' sobre o
+//   próprio vetor e o 'std::copy(v.begin(), v.begin() + 2, v.begin() + 2)'.
+// - 'relocate' move elementos para memória não inicializada e encerra os
+//   originais; para tipos trivialmente realocáveis (ex.: 'std::unique_ptr'
+//   após especializar 'trivially_relocatable') isso é um único 'memcpy'.
+namespace simd {
+
+// bytes a partir dos quais as escritas não passam pela cache.
+inline std::size_t& streaming_threshold() {
+    static std::size_t bytes = [] {
+        long llc = 0;
+#ifdef _SC_LEVEL3_CACHE_SIZE
+        llc = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+        return llc > 0 ? static_cast<std::size_t>(llc) : std::size_t{8} << 20;
+    }();
+    return bytes;
+}
+
+// tipos cujos objetos podem ser movidos para outro endereço copiando seus
+// bytes e abandonando os originais sem destruí-los. Vale para os trivialmente
+// copiáveis; outros tipos (ex.: 'std::unique_ptr', 'std::vector') podem ser
+// declarados especializando o trait. Não vale para a 'std::string' da
+// libstdc++, que aponta para o próprio buffer interno.
+template <typename T>
+struct trivially_relocatable : std::is_trivially_copyable<T> {};
+
+template <typename T>
+inline constexpr bool trivially_relocatable_v =
+    trivially_relocatable<std::remove_cv_t<T>>::value;
+
+#if SIMD_X86
+#pragma GCC push_options
+#pragma GCC target("avx2,bmi,popcnt")
+namespace avx2 {
+// 'memcpy' com stores não temporais alinhados em 32 bytes.
+inline void stream_copy(std::byte* dst, const std::byte* src, std::size_t n) {
+    std::size_t head = -reinterpret_cast<std::uintptr_t>(dst) & 31;
+    head = std::min(head, n);
+    std::memcpy(dst, src, head);
+    std::size_t i = head;
+    for (; i + 128 <= n; i += 128) {
+        const auto* s = reinterpret_cast<const __m256i*>(src + i);
+        auto* d = reinterpret_cast<__m256i*>(dst + i);
+        const __m256i a = _mm256_loadu_si256(s);
+        const __m256i b = _mm256_loadu_si256(s + 1);
+        const __m256i c = _mm256_loadu_si256(s + 2);
+        const __m256i e = _mm256_loadu_si256(s + 3);
+        _mm256_stream_si256(d, a);
+        _mm256_stream_si256(d + 1, b);
+        _mm256_stream_si256(d + 2, c);
+        _mm256_stream_si256(d + 3, e);
+    }
+    for (; i + 32 <= n; i += 32) {
+        _mm256_stream_si256(
+            reinterpret_cast<__m256i*>(dst + i),
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)));
+    }
+    std::memcpy(dst + i, src + i, n - i);
+    _mm_sfence();
+}
+
+// preenche 'n' bytes a partir de 'dst' (alinhado em 32) com 'pattern'.
+inline void stream_fill(std::byte* dst, std::size_t n, __m256i pattern) {
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + i), pattern);
+    }
+    std::memcpy(dst + i, &pattern, n - i);
+    _mm_sfence();
+}
+
+template <typename U>
+inline __m256i splat(U x) {
+    if constexpr (sizeof(U) == 1) {
+        return _mm256_set1_epi8(static_cast<char>(x));
+    } else if constexpr (sizeof(U) == 2) {
+        return _mm256_set1_epi16(static_cast<short>(x));
+    } else if constexpr (sizeof(U) == 4) {
+        return _mm256_set1_epi32(static_cast<int>(x));
+    } else {
+        return _mm256_set1_epi64x(static_cast<long long>(x));
+    }
+}
+}  // namespace avx2
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512bw,avx512vl,bmi,bmi2,popcnt")
+namespace avx512 {
+inline void stream_copy(std::byte* dst, const std::byte* src, std::size_t n) {
+    std::size_t head = -reinterpret_cast<std::uintptr_t>(dst) & 63;
+    head = std::min(head, n);
+    std::memcpy(dst, src, head);
+    std::size_t i = head;
+    for (; i + 256 <= n; i += 256) {
+        const __m512i a = _mm512_loadu_si512(src + i);
+        const __m512i b = _mm512_loadu_si512(src + i + 64);
+        const __m512i c = _mm512_loadu_si512(src + i + 128);
+        const __m512i e = _mm512_loadu_si512(src + i + 192);
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(dst + i), a);
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(dst + i + 64), b);
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(dst + i + 128), c);
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(dst + i + 192), e);
+    }
+    for (; i + 64 <= n; i += 64) {
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(dst + i),
+                            _mm512_loadu_si512(src + i));
+    }
+    std::memcpy(dst + i, src + i, n - i);
+    _mm_sfence();
+}
+
+// preenche 'n' bytes a partir de 'dst' (alinhado em 64) com 'pattern'.
+inline void stream_fill(std::byte* dst, std::size_t n, __m512i pattern) {
+    std::size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(dst + i), pattern);
+    }
+    std::memcpy(dst + i, &pattern, n - i);
+    _mm_sfence();
+}
+
+template <typename U>
+inline __m512i splat(U x) {
+    if constexpr (sizeof(U) == 1) {
+        return _mm512_set1_epi8(static_cast<char>(x));
+    } else if constexpr (sizeof(U) == 2) {
+        return _mm512_set1_epi16(static_cast<short>(x));
+    } else if constexpr (sizeof(U) == 4) {
+        return _mm512_set1_epi32(static_cast<int>(x));
+    } else {
+        return _mm512_set1_epi64(static_cast<long long>(x));
+    }
+}
+}  // namespace avx512
+#pragma GCC pop_options
+#endif
+
+namespace detail {
+// bytes mínimos por bloco ao dividir uma cópia entre threads.
+inline constexpr std::size_t copy_grain = 1 << 16;
+
+inline void copy_block(std::byte* dst, const std::byte* src, std::size_t n,
+                       [[maybe_unused]] bool stream) {
+#if SIMD_X86
+    if (stream) {
+        switch (active_isa()) {
+            case isa::avx512:
+                return avx512::stream_copy(dst, src, n);
+            case isa::avx2:
+                return avx2::stream_copy(dst, src, n);
+            case isa::scalar:
+                break;
+        }
+    }
+#endif
+    std::memcpy(dst, src, n);
+}
+
+template <parallel::execution_policy P>
+void copy_disjoint(P&& policy, std::byte* dst, const std::byte* src,
+                   std::size_t n, bool stream) {
+    parallel::for_each_chunk(
+        policy, n, parallel::chunk_count(policy, n, copy_grain),
+        [&](std::size_t, std::size_t b, std::size_t e) {
+            copy_block(dst + b, src + b, e - b, stream);
+        });
+}
+
+// copia 'n' bytes de 'src' para 'dst' com a semântica de 'memmove'.
+template <parallel::execution_policy P>
+void copy_bytes(P&& policy, void* to, const void* from, std::size_t n) {
+    auto* dst = static_cast<std::byte*>(to);
+    const auto* src = static_cast<const std::byte*>(from);
+    const auto d_addr = reinterpret_cast<std::uintptr_t>(dst);
+    const auto s_addr = reinterpret_cast<std::uintptr_t>(src);
+    if (n == 0 || d_addr == s_addr) return;
+    const bool stream = n >= streaming_threshold();
+    const std::size_t gap = d_addr < s_addr ? s_addr - d_addr : d_addr - s_addr;
+    if (gap >= n) {
+        copy_disjoint(policy, dst, src, n, stream);
+    } else if (parallel::chunk_count(policy, gap, copy_grain) <= 1) {
+        // ondas pequenas demais para compensar a divisão entre threads.
+        std::memmove(dst, src, n);
+    } else if (d_addr < s_addr) {
+        // a origem de cada onda é o destino da seguinte.
+        for (std::size_t i = 0; i < n; i += gap) {
+            copy_disjoint(policy, dst + i, src + i, std::min(gap, n - i),
+                          stream);
+        }
+    } else {
+        for (std::size_t i = n; i > 0;) {
+            const std::size_t len = std::min(gap, i);
+            i -= len;
+            copy_disjoint(policy, dst + i, src + i, len, stream);
+        }
+    }
+}
+
+template <lane_movable T>
+void fill_block(T* p, std::size_t n, const T& value,
+                [[maybe_unused]] bool stream) {
+#if SIMD_X86
+    using U = uint_of_size_t<sizeof(T)>;
+    U bits;
+    std::memcpy(&bits, &value, sizeof(T));
+    // o padrão do vetor só casa com os elementos se 'p' estiver alinhado ao
+    // tamanho do elemento; o início é preenchido até o alinhamento do vetor.
+    const auto addr = reinterpret_cast<std::uintptr_t>(p);
+    if (stream && addr % sizeof(T) == 0) {
+        auto head = [&](std::size_t align) {
+            return std::min(n, (-addr & (align - 1)) / sizeof(T));
+        };
+        switch (active_isa()) {
+            case isa::avx512: {
+                const std::size_t h = head(64);
+                std::fill(p, p + h, value);
+                return avx512::stream_fill(reinterpret_cast<std::byte*>(p + h),
+                                           (n - h) * sizeof(T),
+                                           avx512::splat(bits));
+            }
+            case isa::avx2: {
+                const std::size_t h = head(32);
+                std::fill(p, p + h, value);
+                return avx2::stream_fill(reinterpret_cast<std::byte*>(p + h),
+                                         (n - h) * sizeof(T),
+                                         avx2::splat(bits));
+            }
+            case isa::scalar:
+                break;
+        }
+    }
+#endif
+    std::fill(p, p + n, value);
+}
+
+template <parallel::execution_policy P, typename T>
+void fill_values(P&& policy, T* p, std::size_t n, const T& value) {
+    parallel::for_each_chunk(
+        policy, n, parallel::chunk_count(policy, n * sizeof(T), copy_grain),
+        [&, stream = n * sizeof(T) >= streaming_threshold()](
+            std::size_t, std::size_t b, std::size_t e) {
+            if constexpr (lane_movable<T>) {
+                fill_block(p + b, e - b, value, stream);
+            } else {
+                std::fill(p + b, p + e, value);
+            }
+        });
+}
+
+// ranges cujos bytes podem ser copiados diretamente.
+template <typename R>
+concept bitwise_range =
+    std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+    std::is_trivially_copyable_v<std::ranges::range_value_t<R>>;
+
+// tipo dos elementos escritos por um destino contíguo.
+template <typename O>
+struct output_value {};
+template <std::contiguous_iterator O>
+struct output_value<O> {
+    using type = std::iter_value_t<O>;
+};
+template <typename C>
+struct output_value<std::back_insert_iterator<C>> {
+    using type = typename C::value_type;
+};
+
+// destino contíguo (sem 'back_inserter'), para as variantes '_backward'.
+template <typename I, typename T>
+concept contiguous_iterator_of =
+    std::contiguous_iterator<I> && std::same_as<std::iter_value_t<I>, T> &&
+    std::indirectly_writable<I, const T&>;
+}  // namespace detail
+
+struct copy_fn {
+    template <std::ranges::input_range R, std::weakly_incrementable O>
+        requires std::indirectly_copyable<std::ranges::iterator_t<R>, O>
+    std::ranges::copy_result<std::ranges::borrowed_iterator_t<R>, O>
+    operator()(R&& r, O out) const {
+        return (*this)(std::execution::seq, std::forward<R>(r), std::move(out));
+    }
+
+    template <parallel::execution_policy P, std::ranges::input_range R,
+              std::weakly_incrementable O>
+        requires std::indirectly_copyable<std::ranges::iterator_t<R>, O>
+    std::ranges::copy_result<std::ranges::borrowed_iterator_t<R>, O>
+    operator()(P&& policy, R&& r, O out) const {
+        using T = std::ranges::range_value_t<R>;
+        if constexpr (detail::bitwise_range<R> &&
+                      detail::contiguous_output<O, T>) {
+            const std::size_t n = std::ranges::size(r);
+            const T* in = std::ranges::data(r);
+            detail::copy_bytes(policy, detail::output_for<T>(out, n), in,
+                               n * sizeof(T));
+            return {std::ranges::begin(r) + n, detail::advanced(out, n)};
+        } else if constexpr (!parallel::is_sequenced<P>() &&
+                             std::ranges::random_access_range<R> &&
+                             std::ranges::sized_range<R> &&
+                             std::forward_iterator<O>) {
+            auto first = std::ranges::begin(r);
+            auto last = first + std::ranges::size(r);
+            return {last, std::copy(policy, first, last, std::move(out))};
+        } else {
+            return std::ranges::copy(r, std::move(out));
+        }
+    }
+};
+inline constexpr copy_fn copy{};
+
+struct copy_n_fn {
+    template <std::input_iterator I, std::weakly_incrementable O>
+        requires std::indirectly_copyable<I, O>
+    std::ranges::copy_n_result<I, O> operator()(
+        I first, std::iter_difference_t<I> n, O out) const {
+        return (*this)(std::execution::seq, std::move(first), n,
+                       std::move(out));
+    }
+
+    template <parallel::execution_policy P, std::input_iterator I,
+              std::weakly_incrementable O>
+        requires std::indirectly_copyable<I, O>
+    std::ranges::copy_n_result<I, O> operator()(P&& policy, I first,
+                                                std::iter_difference_t<I> n,
+                                                O out) const {
+        if constexpr (std::random_access_iterator<I>) {
+            if (n <= 0) return {std::move(first), std::move(out)};
+            auto [last, o] =
+                copy(policy, std::ranges::subrange(first, first + n),
+                     std::move(out));
+            return {last, std::move(o)};
+        } else {
+            return std::ranges::copy_n(std::move(first), n, std::move(out));
+        }
+    }
+};
+inline constexpr copy_n_fn copy_n{};
+
+// copia 'r' para a faixa que termina em 'out_last'.
+struct copy_backward_fn {
+    template <std::ranges::bidirectional_range R, std::bidirectional_iterator O>
+        requires std::indirectly_copyable<std::ranges::iterator_t<R>, O>
+    std::ranges::copy_backward_result<std::ranges::borrowed_iterator_t<R>, O>
+    operator()(R&& r, O out_last) const {
+        return (*this)(std::execution::seq, std::forward<R>(r),
+                       std::move(out_last));
+    }
+
+    template <parallel::execution_policy P,
+              std::ranges::bidirectional_range R, std::bidirectional_iterator O>
+        requires std::indirectly_copyable<std::ranges::iterator_t<R>, O>
+    std::ranges::copy_backward_result<std::ranges::borrowed_iterator_t<R>, O>
+    operator()(P&& policy, R&& r, O out_last) const {
+        using T = std::ranges::range_value_t<R>;
+        if constexpr (detail::bitwise_range<R> &&
+                      detail::contiguous_iterator_of<O, T>) {
+            const std::size_t n = std::ranges::size(r);
+            O out_first = out_last - n;
+            detail::copy_bytes(policy, std::to_address(out_first),
+                               std::ranges::data(r), n * sizeof(T));
+            return {std::ranges::begin(r) + n, out_first};
+        } else {
+            return std::ranges::copy_backward(r, std::move(out_last));
+        }
+    }
+};
+inline constexpr copy_backward_fn copy_backward{};
+
+// para elementos trivialmente copiáveis, mover é copiar os bytes.
+struct move_fn {
+    template <std::ranges::input_range R, std::weakly_incrementable O>
+        requires std::indirectly_movable<std::ranges::iterator_t<R>, O>
+    std::ranges::move_result<std::ranges::borrowed_iterator_t<R>, O>
+    operator()(R&& r, O out) const {
+        return (*this)(std::execution::seq, std::forward<R>(r), std::move(out));
+    }
+
+    template <parallel::execution_policy P, std::ranges::input_range R,
+              std::weakly_incrementable O>
+        requires std::indirectly_movable<std::ranges::iterator_t<R>, O>
+    std::ranges::move_result<std::ranges::borrowed_iterator_t<R>, O>
+    operator()(P&& policy, R&& r, O out) const {
+        using T = std::ranges::range_value_t<R>;
+        if constexpr (detail::bitwise_range<R> &&
+                      detail::contiguous_output<O, T>) {
+            return copy(policy, std::forward<R>(r), std::move(out));
+        } else if constexpr (!parallel::is_sequenced<P>() &&
+                             std::ranges::random_access_range<R> &&
+                             std::ranges::sized_range<R> &&
+                             std::forward_iterator<O>) {
+            auto first = std::ranges::begin(r);
+            auto last = first + std::ranges::size(r);
+            return {last, std::move(policy, first, last, std::move(out))};
+        } else {
+            return std::ranges::move(r, std::move(out));
+        }
+    }
+};
+inline constexpr move_fn move{};
+
+struct move_backward_fn {
+    template <std::ranges::bidirectional_range R, std::bidirectional_iterator O>
+        requires std::indirectly_movable<std::ranges::iterator_t<R>, O>
+    std::ranges::move_backward_result<std::ranges::borrowed_iterator_t<R>, O>
+    operator()(R&& r, O out_last) const {
+        return (*this)(std::execution::seq, std::forward<R>(r),
+                       std::move(out_last));
+    }
+
+    template <parallel::execution_policy P,
+              std::ranges::bidirectional_range R, std::bidirectional_iterator O>
+        requires std::indirectly_movable<std::ranges::iterator_t<R>, O>
+    std::ranges::move_backward_result<std::ranges::borrowed_iterator_t<R>, O>
+    operator()(P&& policy, R&& r, O out_last) const {
+        using T = std::ranges::range_value_t<R>;
+        if constexpr (detail::bitwise_range<R> &&
+                      detail::contiguous_iterator_of<O, T>) {
+            return copy_backward(policy, std::forward<R>(r),
+                                 std::move(out_last));
+        } else {
+            return std::ranges::move_backward(r, std::move(out_last));
+        }
+    }
+};
+inline constexpr move_backward_fn move_backward{};
+
+struct fill_fn {
+    template <typename T, std::ranges::output_range<const T&> R>
+    std::ranges::borrowed_iterator_t<R> operator()(R&& r,
+                                                   const T& value) const {
+        return (*this)(std::execution::seq, std::forward<R>(r), value);
+    }
+
+    template <parallel::execution_policy P, typename T,
+              std::ranges::output_range<const T&> R>
+    std::ranges::borrowed_iterator_t<R> operator()(P&& policy, R&& r,
+                                                   const T& value) const {
+        using E = std::ranges::range_value_t<R>;
+        if constexpr (std::ranges::contiguous_range<R> &&
+                      std::ranges::sized_range<R> &&
+                      std::is_trivially_copyable_v<E> &&
+                      std::convertible_to<const T&, E>) {
+            const std::size_t n = std::ranges::size(r);
+            detail::fill_values(policy, std::ranges::data(r), n,
+                                static_cast<E>(value));
+            return std::ranges::begin(r) + n;
+        } else if constexpr (!parallel::is_sequenced<P>() &&
+                             std::ranges::random_access_range<R> &&
+                             std::ranges::sized_range<R>) {
+            auto first = std::ranges::begin(r);
+            auto last = first + std::ranges::size(r);
+            std::fill(policy, first, last, value);
+            return last;
+        } else {
+            return std::ranges::fill(r, value);
+        }
+    }
+};
+inline constexpr fill_fn fill{};
+
+struct fill_n_fn {
+    template <typename T, std::output_iterator<const T&> O>
+    O operator()(O out, std::iter_difference_t<O> n, const T& value) const {
+        return (*this)(std::execution::seq, std::move(out), n, value);
+    }
+
+    template <parallel::execution_policy P, typename T,
+              std::output_iterator<const T&> O>
+    O operator()(P&& policy, O out, std::iter_difference_t<O> n,
+                 const T& value) const {
+        if (n <= 0) return out;
+        const auto count = static_cast<std::size_t>(n);
+        if constexpr (requires { typename detail::output_value<O>::type; }) {
+            using E = typename detail::output_value<O>::type;
+            if constexpr (std::is_trivially_copyable_v<E> &&
+                          std::convertible_to<const T&, E> &&
+                          detail::contiguous_output<O, E>) {
+                detail::fill_values(policy, detail::output_for<E>(out, count),
+                                    count, static_cast<E>(value));
+                return detail::advanced(out, count);
+            }
+        }
+        return std::ranges::fill_n(std::move(out), n, value);
+    }
+};
+inline constexpr fill_n_fn fill_n{};
+
+// move os elementos de 'r' para a memória não inicializada (e disjunta) que
+// começa em 'out' e destrói os originais; devolve o fim do destino. Os tipos
+// trivialmente realocáveis são copiados como bytes, em paralelo se pedido.
+struct relocate_fn {
+    template <std::ranges::contiguous_range R>
+        requires std::ranges::sized_range<R>
+    auto* operator()(R&& r, std::ranges::range_value_t<R>* out) const {
+        return (*this)(std::execution::seq, std::forward<R>(r), out);
+    }
+
+    template <parallel::execution_policy P, std::ranges::contiguous_range R>
+        requires std::ranges::sized_range<R> &&
+                 std::is_nothrow_move_constructible_v<
+                     std::ranges::range_value_t<R>>
+    auto* operator()(P&& policy, R&& r,
+                     std::ranges::range_value_t<R>* out) const {
+        using T = std::ranges::range_value_t<R>;
+        const std::size_t n = std::ranges::size(r);
+        T* in = std::ranges::data(r);
+        if constexpr (trivially_relocatable_v<T>) {
+            // os originais deixam de existir sem executar destrutores.
+            detail::copy_bytes(policy, static_cast<void*>(out),
+                               static_cast<const void*>(in), n * sizeof(T));
+        } else {
+            for (std::size_t i = 0; i < n; ++i) {
+                std::construct_at(out + i, std::move(in[i]));
+                std::destroy_at(in + i);
+            }
+        }
+        return out + n;
+    }
+};
+inline constexpr relocate_fn relocate{};
+
+}  // namespace simd
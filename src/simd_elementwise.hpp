@@ -0,0 +1,1106 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <execution>
+#include <iterator>
+#include <limits>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+#include "simd_copy.hpp"
+#include "simd_replace.hpp"
+#include "simd_search.hpp"
+
+// Kernels elemento a elemento para ranges contíguas de números, escritos com
+// intrínsecos (e portanto independentes da autovetorização, que '-Og' e '-O1'
+// não fazem) e despachados em tempo de execução:
+// - 'clamp(r, lo, hi)': limita cada elemento a [lo, hi] (NaN é preservado);
+// - 'abs(r)': valor absoluto (inteiros com sinal: 'abs(min) == min');
+// - 'add_sat(r, c)' e 'mul_sat(r, c)': soma e produto por uma constante com
+//   saturação nos limites do tipo (ponto flutuante: soma e produto comuns);
+// - 'affine(r, a, b)': 'a * x + b' com um único arredondamento ('fma'), para
+//   float e double;
+// - 'narrow_copy(r, out)': conversão para um tipo mais estreito com saturação
+//   (ponto flutuante para inteiro: arredondamento para o mais próximo e NaN
+//   vira 0).
+// Cada operação tem a forma no lugar e a forma '_copy', que escreve num
+// destino contíguo (ou num 'back_inserter', redimensionado uma única vez), e
+// aceita uma política de execução que divide a range em blocos. Todos os
+// caminhos (escalar, AVX2 e AVX-512) produzem exatamente o mesmo resultado.
+namespace simd {
+
+namespace detail {
+// limites de 'To' representados em 'From' (o maior valor de 'From' que não
+// ultrapassa o limite), usados para saturar antes de converter. Nem sempre
+// 'narrow_hi' é o máximo de 'To' (float não representa 2^31 - 1 nem 2^32 - 1):
+// valores de ponto flutuante acima dele dão o máximo de 'To' explicitamente.
+template <typename To, typename From>
+constexpr From narrow_lo() {
+    constexpr auto m = std::numeric_limits<To>::lowest();
+    if constexpr (std::floating_point<From>) {
+        return static_cast<From>(m);
+    } else {
+        return std::cmp_greater(m, std::numeric_limits<From>::lowest())
+                   ? static_cast<From>(m)
+                   : std::numeric_limits<From>::lowest();
+    }
+}
+
+template <typename To, typename From>
+constexpr From narrow_hi() {
+    constexpr auto m = std::numeric_limits<To>::max();
+    if constexpr (std::floating_point<From>) {
+        From h = static_cast<From>(m);
+        if (static_cast<long double>(h) > static_cast<long double>(m)) {
+            h *= 1 - std::numeric_limits<From>::epsilon() / 2;
+        }
+        return h;
+    } else {
+        return std::cmp_less(m, std::numeric_limits<From>::max())
+                   ? static_cast<From>(m)
+                   : std::numeric_limits<From>::max();
+    }
+}
+}  // namespace detail
+
+// conversões aceitas por 'narrow_copy'.
+template <typename From, typename To>
+concept narrowable =
+    lane_arithmetic<From> && lane_arithmetic<To> && !std::same_as<From, To> &&
+    ((lane_integral<From> && lane_integral<To> &&
+      sizeof(To) <= sizeof(From)) ||
+     (std::floating_point<From> && lane_integral<To> && sizeof(To) <= 4) ||
+     (std::same_as<From, double> && std::same_as<To, float>));
+
+namespace scalar {
+template <lane_arithmetic T>
+constexpr T clamp(T x, T lo, T hi) {
+    return x < lo ? lo : hi < x ? hi : x;
+}
+
+template <lane_arithmetic T>
+constexpr T abs(T x) {
+    if constexpr (std::floating_point<T>) {
+        using U = uint_of_size_t<sizeof(T)>;
+        return std::bit_cast<T>(std::bit_cast<U>(x) & (~U{0} >> 1));
+    } else if constexpr (std::is_signed_v<T>) {
+        using U = std::make_unsigned_t<T>;
+        return x < 0 ? static_cast<T>(U{0} - static_cast<U>(x)) : x;
+    } else {
+        return x;
+    }
+}
+
+template <lane_arithmetic T>
+constexpr T add_sat(T x, T c) {
+    if constexpr (std::floating_point<T>) {
+        return x + c;
+    } else {
+        T r;
+        if (!__builtin_add_overflow(x, c, &r)) return r;
+        return std::is_signed_v<T> && c < 0 ? std::numeric_limits<T>::min()
+                                            : std::numeric_limits<T>::max();
+    }
+}
+
+template <lane_arithmetic T>
+constexpr T mul_sat(T x, T c) {
+    if constexpr (std::floating_point<T>) {
+        return x * c;
+    } else {
+        T r;
+        if (!__builtin_mul_overflow(x, c, &r)) return r;
+        return std::is_signed_v<T> && (x < 0) != (c < 0)
+                   ? std::numeric_limits<T>::min()
+                   : std::numeric_limits<T>::max();
+    }
+}
+
+template <std::floating_point T>
+T affine(T x, T a, T b) {
+    return std::fma(a, x, b);
+}
+
+template <lane_arithmetic To, lane_arithmetic From>
+    requires narrowable<From, To>
+To narrow(From x) {
+    if constexpr (std::floating_point<To>) {
+        return static_cast<To>(x);
+    } else {
+        constexpr From lo = detail::narrow_lo<To, From>();
+        constexpr From hi = detail::narrow_hi<To, From>();
+        if constexpr (std::floating_point<From>) {
+            if (x != x) return 0;
+            if (x > hi) return std::numeric_limits<To>::max();
+            return static_cast<To>(std::nearbyint(clamp(x, lo, hi)));
+        } else {
+            return static_cast<To>(clamp(x, lo, hi));
+        }
+    }
+}
+}  // namespace scalar
+
+#if SIMD_X86
+#pragma GCC push_options
+#pragma GCC target("avx2,fma,bmi,popcnt")
+namespace avx2 {
+template <lane_arithmetic T>
+inline __m256i splat(T v) {
+    return broadcast<uint_of_size_t<sizeof(T)>>(
+        std::bit_cast<uint_of_size_t<sizeof(T)>>(v));
+}
+
+// 'a > b ? a : b' e 'a < b ? a : b' por elemento; com NaN, o resultado é
+// 'b' (como 'maxps'/'minps').
+template <lane_arithmetic T>
+inline __m256i vmax(__m256i a, __m256i b) {
+    constexpr bool s = std::is_signed_v<T>;
+    if constexpr (std::same_as<T, float>) {
+        return _mm256_castps_si256(
+            _mm256_max_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)));
+    } else if constexpr (std::same_as<T, double>) {
+        return _mm256_castpd_si256(
+            _mm256_max_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b)));
+    } else if constexpr (sizeof(T) == 1) {
+        return s ? _mm256_max_epi8(a, b) : _mm256_max_epu8(a, b);
+    } else if constexpr (sizeof(T) == 2) {
+        return s ? _mm256_max_epi16(a, b) : _mm256_max_epu16(a, b);
+    } else if constexpr (sizeof(T) == 4) {
+        return s ? _mm256_max_epi32(a, b) : _mm256_max_epu32(a, b);
+    } else {
+        // sem 'max_epi64': comparação com sinal (sem sinal: bit alto trocado).
+        const __m256i f = _mm256_set1_epi64x(s ? 0 : INT64_MIN);
+        const __m256i gt = _mm256_cmpgt_epi64(_mm256_xor_si256(a, f),
+                                              _mm256_xor_si256(b, f));
+        return _mm256_blendv_epi8(b, a, gt);
+    }
+}
+
+template <lane_arithmetic T>
+inline __m256i vmin(__m256i a, __m256i b) {
+    constexpr bool s = std::is_signed_v<T>;
+    if constexpr (std::same_as<T, float>) {
+        return _mm256_castps_si256(
+            _mm256_min_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)));
+    } else if constexpr (std::same_as<T, double>) {
+        return _mm256_castpd_si256(
+            _mm256_min_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b)));
+    } else if constexpr (sizeof(T) == 1) {
+        return s ? _mm256_min_epi8(a, b) : _mm256_min_epu8(a, b);
+    } else if constexpr (sizeof(T) == 2) {
+        return s ? _mm256_min_epi16(a, b) : _mm256_min_epu16(a, b);
+    } else if constexpr (sizeof(T) == 4) {
+        return s ? _mm256_min_epi32(a, b) : _mm256_min_epu32(a, b);
+    } else {
+        const __m256i f = _mm256_set1_epi64x(s ? 0 : INT64_MIN);
+        const __m256i lt = _mm256_cmpgt_epi64(_mm256_xor_si256(b, f),
+                                              _mm256_xor_si256(a, f));
+        return _mm256_blendv_epi8(b, a, lt);
+    }
+}
+
+// 'vec' nos vetores completos e 'sc' na cauda.
+template <lane_arithmetic T, typename V, typename S>
+inline void map(const T* in, T* out, std::size_t n, V vec, S sc) {
+    constexpr std::size_t L = 32 / sizeof(T);
+    std::size_t i = 0;
+    for (; i + L <= n; i += L) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                            vec(load(in + i)));
+    }
+    for (; i < n; ++i) out[i] = sc(in[i]);
+}
+
+template <lane_arithmetic T>
+void clamp(const T* in, T* out, std::size_t n, T lo, T hi) {
+    const __m256i l = splat(lo), h = splat(hi);
+    map(
+        in, out, n, [&](__m256i v) { return vmin<T>(h, vmax<T>(l, v)); },
+        [&](T x) { return scalar::clamp(x, lo, hi); });
+}
+
+template <lane_arithmetic T>
+void abs(const T* in, T* out, std::size_t n) {
+    using U = uint_of_size_t<sizeof(T)>;
+    const __m256i magnitude = broadcast<U>(~U{0} >> 1);
+    map(
+        in, out, n,
+        [&](__m256i v) {
+            if constexpr (std::floating_point<T> || std::is_unsigned_v<T>) {
+                return std::floating_point<T> ? _mm256_and_si256(v, magnitude)
+                                              : v;
+            } else if constexpr (sizeof(T) == 1) {
+                return _mm256_abs_epi8(v);
+            } else if constexpr (sizeof(T) == 2) {
+                return _mm256_abs_epi16(v);
+            } else if constexpr (sizeof(T) == 4) {
+                return _mm256_abs_epi32(v);
+            } else {
+                const __m256i s =
+                    _mm256_cmpgt_epi64(_mm256_setzero_si256(), v);
+                return _mm256_sub_epi64(_mm256_xor_si256(v, s), s);
+            }
+        },
+        [](T x) { return scalar::abs(x); });
+}
+
+template <lane_arithmetic T>
+inline __m256i add_sat(__m256i x, __m256i c) {
+    constexpr bool s = std::is_signed_v<T>;
+    if constexpr (std::same_as<T, float>) {
+        return _mm256_castps_si256(
+            _mm256_add_ps(_mm256_castsi256_ps(x), _mm256_castsi256_ps(c)));
+    } else if constexpr (std::same_as<T, double>) {
+        return _mm256_castpd_si256(
+            _mm256_add_pd(_mm256_castsi256_pd(x), _mm256_castsi256_pd(c)));
+    } else if constexpr (sizeof(T) == 1) {
+        return s ? _mm256_adds_epi8(x, c) : _mm256_adds_epu8(x, c);
+    } else if constexpr (sizeof(T) == 2) {
+        return s ? _mm256_adds_epi16(x, c) : _mm256_adds_epu16(x, c);
+    } else {
+        // sem instrução própria: soma com transbordo e correção.
+        constexpr bool wide = sizeof(T) == 8;
+        const __m256i r =
+            wide ? _mm256_add_epi64(x, c) : _mm256_add_epi32(x, c);
+        if constexpr (s) {
+            // transbordou se 'x' e 'c' têm o mesmo sinal e 'r' o oposto; o
+            // limite tem o sinal de 'x'.
+            const __m256i ov = _mm256_and_si256(_mm256_xor_si256(x, r),
+                                                _mm256_xor_si256(c, r));
+            const __m256i neg =
+                wide ? _mm256_cmpgt_epi64(_mm256_setzero_si256(), x)
+                     : _mm256_srai_epi32(x, 31);
+            const __m256i sat = _mm256_xor_si256(
+                neg, wide ? _mm256_set1_epi64x(INT64_MAX)
+                          : _mm256_set1_epi32(INT32_MAX));
+            return wide ? _mm256_castpd_si256(_mm256_blendv_pd(
+                              _mm256_castsi256_pd(r), _mm256_castsi256_pd(sat),
+                              _mm256_castsi256_pd(ov)))
+                        : _mm256_castps_si256(_mm256_blendv_ps(
+                              _mm256_castsi256_ps(r), _mm256_castsi256_ps(sat),
+                              _mm256_castsi256_ps(ov)));
+        } else {
+            // transbordou se 'r < x'; satura com todos os bits em 1.
+            const __m256i ov =
+                wide ? _mm256_cmpgt_epi64(
+                           _mm256_xor_si256(x, _mm256_set1_epi64x(INT64_MIN)),
+                           _mm256_xor_si256(r, _mm256_set1_epi64x(INT64_MIN)))
+                     : _mm256_xor_si256(
+                           _mm256_cmpeq_epi32(_mm256_min_epu32(r, x), x),
+                           _mm256_set1_epi32(-1));
+            return _mm256_or_si256(r, ov);
+        }
+    }
+}
+
+template <lane_arithmetic T>
+void add_sat(const T* in, T* out, std::size_t n, T c) {
+    const __m256i k = splat(c);
+    map(
+        in, out, n, [&](__m256i v) { return add_sat<T>(v, k); },
+        [&](T x) { return scalar::add_sat(x, c); });
+}
+
+// bytes estendidos para 16 bits, com ou sem sinal.
+template <lane_integral T>
+inline __m256i widen(__m128i v) {
+    return std::is_signed_v<T> ? _mm256_cvtepi8_epi16(v)
+                               : _mm256_cvtepu8_epi16(v);
+}
+
+// produto saturado; inteiros de 32 e 64 bits ficam com o caminho escalar.
+template <lane_arithmetic T>
+inline constexpr bool has_mul_sat = std::floating_point<T> || sizeof(T) <= 2;
+
+template <lane_arithmetic T>
+inline __m256i mul_sat(__m256i x, __m256i c) {
+    constexpr bool s = std::is_signed_v<T>;
+    if constexpr (std::same_as<T, float>) {
+        return _mm256_castps_si256(
+            _mm256_mul_ps(_mm256_castsi256_ps(x), _mm256_castsi256_ps(c)));
+    } else if constexpr (std::same_as<T, double>) {
+        return _mm256_castpd_si256(
+            _mm256_mul_pd(_mm256_castsi256_pd(x), _mm256_castsi256_pd(c)));
+    } else if constexpr (sizeof(T) == 1) {
+        // produto exato em 16 bits, reempacotado com saturação.
+        const __m256i c16 = widen<T>(_mm256_castsi256_si128(c));
+        __m256i lo =
+            _mm256_mullo_epi16(widen<T>(_mm256_castsi256_si128(x)), c16);
+        __m256i hi =
+            _mm256_mullo_epi16(widen<T>(_mm256_extracti128_si256(x, 1)), c16);
+        if constexpr (!s) {
+            lo = _mm256_min_epu16(lo, _mm256_set1_epi16(0xff));
+            hi = _mm256_min_epu16(hi, _mm256_set1_epi16(0xff));
+        }
+        const __m256i p =
+            s ? _mm256_packs_epi16(lo, hi) : _mm256_packus_epi16(lo, hi);
+        return _mm256_permute4x64_epi64(p, 0xd8);
+    } else {
+        const __m256i lo = _mm256_mullo_epi16(x, c);
+        if constexpr (s) {
+            // cabe em 16 bits se a parte alta é a extensão de sinal da baixa.
+            const __m256i hi = _mm256_mulhi_epi16(x, c);
+            const __m256i fits =
+                _mm256_cmpeq_epi16(hi, _mm256_srai_epi16(lo, 15));
+            const __m256i sat =
+                _mm256_xor_si256(_mm256_srai_epi16(_mm256_xor_si256(x, c), 15),
+                                 _mm256_set1_epi16(INT16_MAX));
+            return _mm256_blendv_epi8(sat, lo, fits);
+        } else {
+            const __m256i hi = _mm256_mulhi_epu16(x, c);
+            const __m256i ov = _mm256_xor_si256(
+                _mm256_cmpeq_epi16(hi, _mm256_setzero_si256()),
+                _mm256_set1_epi16(-1));
+            return _mm256_or_si256(lo, ov);
+        }
+    }
+}
+
+template <lane_arithmetic T>
+void mul_sat(const T* in, T* out, std::size_t n, T c) {
+    if constexpr (has_mul_sat<T>) {
+        const __m256i k = splat(c);
+        map(
+            in, out, n, [&](__m256i v) { return mul_sat<T>(v, k); },
+            [&](T x) { return scalar::mul_sat(x, c); });
+    } else {
+        for (std::size_t i = 0; i < n; ++i) out[i] = scalar::mul_sat(in[i], c);
+    }
+}
+
+template <std::floating_point T>
+void affine(const T* in, T* out, std::size_t n, T a, T b) {
+    const __m256i va = splat(a), vb = splat(b);
+    map(
+        in, out, n,
+        [&](__m256i v) {
+            if constexpr (std::same_as<T, float>) {
+                return _mm256_castps_si256(_mm256_fmadd_ps(
+                    _mm256_castsi256_ps(va), _mm256_castsi256_ps(v),
+                    _mm256_castsi256_ps(vb)));
+            } else {
+                return _mm256_castpd_si256(_mm256_fmadd_pd(
+                    _mm256_castsi256_pd(va), _mm256_castsi256_pd(v),
+                    _mm256_castsi256_pd(vb)));
+            }
+        },
+        [&](T x) { return scalar::affine(x, a, b); });
+}
+
+// conversões com empacotamento: inteiros de até 32 bits e float (exceto para
+// uint32, que 'cvtps_epi32' não alcança); as demais ficam com o escalar.
+template <typename From, typename To>
+inline constexpr bool has_narrow =
+    (lane_integral<From> && sizeof(From) <= 4) ||
+    (std::same_as<From, float> &&
+     !(std::is_unsigned_v<To> && sizeof(To) == 4)) ||
+    (std::same_as<From, double> && std::same_as<To, float>);
+
+template <lane_arithmetic From, lane_arithmetic To>
+    requires narrowable<From, To>
+void narrow(const From* in, To* out, std::size_t n) {
+    std::size_t i = 0;
+    if constexpr (std::same_as<To, float>) {
+        for (; i + 4 <= n; i += 4) {
+            _mm_storeu_ps(out + i, _mm256_cvtpd_ps(_mm256_loadu_pd(in + i)));
+        }
+    } else if constexpr (has_narrow<From, To>) {
+        constexpr std::size_t L = 32 / sizeof(From);
+        const __m256i lo = splat(detail::narrow_lo<To, From>());
+        const __m256i hi = splat(detail::narrow_hi<To, From>());
+        const __m256i top =
+            splat(static_cast<std::int32_t>(std::numeric_limits<To>::max()));
+        // vetor saturado (e, para float, já convertido para int32).
+        auto prep = [&](const From* p) {
+            __m256i v = load(p);
+            if constexpr (std::same_as<From, float>) {
+                const __m256 f = _mm256_castsi256_ps(v);
+                const __m256 above =
+                    _mm256_cmp_ps(f, _mm256_castsi256_ps(hi), _CMP_GT_OQ);
+                v = _mm256_and_si256(
+                    v, _mm256_castps_si256(_mm256_cmp_ps(f, f, _CMP_ORD_Q)));
+                v = vmin<From>(hi, vmax<From>(lo, v));
+                return _mm256_blendv_epi8(
+                    _mm256_cvtps_epi32(_mm256_castsi256_ps(v)), top,
+                    _mm256_castps_si256(above));
+            } else {
+                return vmin<From>(hi, vmax<From>(lo, v));
+            }
+        };
+        auto store = [&](std::size_t at, __m256i v) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + at), v);
+        };
+        constexpr bool s = std::is_signed_v<To>;
+        if constexpr (sizeof(To) == sizeof(From)) {
+            for (; i + L <= n; i += L) store(i, prep(in + i));
+        } else if constexpr (sizeof(From) == 2 || sizeof(To) == 2) {
+            // 16 para 8 ou 32 para 16 bits: 'pack' intercala as metades.
+            for (; i + 2 * L <= n; i += 2 * L) {
+                const __m256i a = prep(in + i), b = prep(in + i + L);
+                __m256i p;
+                if constexpr (sizeof(From) == 2) {
+                    p = s ? _mm256_packs_epi16(a, b)
+                          : _mm256_packus_epi16(a, b);
+                } else {
+                    p = s ? _mm256_packs_epi32(a, b)
+                          : _mm256_packus_epi32(a, b);
+                }
+                store(i, _mm256_permute4x64_epi64(p, 0xd8));
+            }
+        } else {
+            // 32 para 8 bits: dois níveis de 'pack' e uma permutação.
+            const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+            for (; i + 4 * L <= n; i += 4 * L) {
+                const __m256i a = _mm256_packs_epi32(prep(in + i),
+                                                     prep(in + i + L));
+                const __m256i b = _mm256_packs_epi32(prep(in + i + 2 * L),
+                                                     prep(in + i + 3 * L));
+                const __m256i p =
+                    s ? _mm256_packs_epi16(a, b) : _mm256_packus_epi16(a, b);
+                store(i, _mm256_permutevar8x32_epi32(p, order));
+            }
+        }
+    }
+    for (; i < n; ++i) out[i] = scalar::narrow<To>(in[i]);
+}
+}  // namespace avx2
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512bw,avx512vl,bmi,bmi2,popcnt")
+// os intrínsecos sem máscara do GCC 12 partem de '_mm512_undefined_*', o que
+// gera falsos '-Wuninitialized'/'-Wmaybe-uninitialized'.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+namespace avx512 {
+template <lane_arithmetic T>
+inline __m512i splat(T v) {
+    return broadcast<uint_of_size_t<sizeof(T)>>(
+        std::bit_cast<uint_of_size_t<sizeof(T)>>(v));
+}
+
+template <lane_arithmetic T>
+inline __m512i vmax(__m512i a, __m512i b) {
+    constexpr bool s = std::is_signed_v<T>;
+    if constexpr (std::same_as<T, float>) {
+        return _mm512_castps_si512(
+            _mm512_max_ps(_mm512_castsi512_ps(a), _mm512_castsi512_ps(b)));
+    } else if constexpr (std::same_as<T, double>) {
+        return _mm512_castpd_si512(
+            _mm512_max_pd(_mm512_castsi512_pd(a), _mm512_castsi512_pd(b)));
+    } else if constexpr (sizeof(T) == 1) {
+        return s ? _mm512_max_epi8(a, b) : _mm512_max_epu8(a, b);
+    } else if constexpr (sizeof(T) == 2) {
+        return s ? _mm512_max_epi16(a, b) : _mm512_max_epu16(a, b);
+    } else if constexpr (sizeof(T) == 4) {
+        return s ? _mm512_max_epi32(a, b) : _mm512_max_epu32(a, b);
+    } else {
+        return s ? _mm512_max_epi64(a, b) : _mm512_max_epu64(a, b);
+    }
+}
+
+template <lane_arithmetic T>
+inline __m512i vmin(__m512i a, __m512i b) {
+    constexpr bool s = std::is_signed_v<T>;
+    if constexpr (std::same_as<T, float>) {
+        return _mm512_castps_si512(
+            _mm512_min_ps(_mm512_castsi512_ps(a), _mm512_castsi512_ps(b)));
+    } else if constexpr (std::same_as<T, double>) {
+        return _mm512_castpd_si512(
+            _mm512_min_pd(_mm512_castsi512_pd(a), _mm512_castsi512_pd(b)));
+    } else if constexpr (sizeof(T) == 1) {
+        return s ? _mm512_min_epi8(a, b) : _mm512_min_epu8(a, b);
+    } else if constexpr (sizeof(T) == 2) {
+        return s ? _mm512_min_epi16(a, b) : _mm512_min_epu16(a, b);
+    } else if constexpr (sizeof(T) == 4) {
+        return s ? _mm512_min_epi32(a, b) : _mm512_min_epu32(a, b);
+    } else {
+        return s ? _mm512_min_epi64(a, b) : _mm512_min_epu64(a, b);
+    }
+}
+
+// 'vec' em todos os vetores; a cauda usa leitura e escrita mascaradas.
+template <lane_arithmetic T, typename V>
+inline void map(const T* in, T* out, std::size_t n, V vec) {
+    using U = uint_of_size_t<sizeof(T)>;
+    constexpr std::size_t L = 64 / sizeof(T);
+    auto* src = reinterpret_cast<const U*>(in);
+    auto* dst = reinterpret_cast<U*>(out);
+    std::size_t i = 0;
+    for (; i + L <= n; i += L) {
+        _mm512_storeu_si512(dst + i, vec(_mm512_loadu_si512(src + i)));
+    }
+    if (i < n) {
+        mask_store(dst + i, tail_mask(n - i), vec(load_n(src + i, n - i)));
+    }
+}
+
+template <lane_arithmetic T>
+void clamp(const T* in, T* out, std::size_t n, T lo, T hi) {
+    const __m512i l = splat(lo), h = splat(hi);
+    map(in, out, n, [&](__m512i v) { return vmin<T>(h, vmax<T>(l, v)); });
+}
+
+template <lane_arithmetic T>
+void abs(const T* in, T* out, std::size_t n) {
+    using U = uint_of_size_t<sizeof(T)>;
+    const __m512i magnitude = broadcast<U>(~U{0} >> 1);
+    map(in, out, n, [&](__m512i v) {
+        if constexpr (std::floating_point<T>) {
+            return _mm512_and_si512(v, magnitude);
+        } else if constexpr (std::is_unsigned_v<T>) {
+            return v;
+        } else if constexpr (sizeof(T) == 1) {
+            return _mm512_abs_epi8(v);
+        } else if constexpr (sizeof(T) == 2) {
+            return _mm512_abs_epi16(v);
+        } else if constexpr (sizeof(T) == 4) {
+            return _mm512_abs_epi32(v);
+        } else {
+            return _mm512_abs_epi64(v);
+        }
+    });
+}
+
+template <lane_arithmetic T>
+inline __m512i add_sat(__m512i x, __m512i c) {
+    constexpr bool s = std::is_signed_v<T>;
+    if constexpr (std::same_as<T, float>) {
+        return _mm512_castps_si512(
+            _mm512_add_ps(_mm512_castsi512_ps(x), _mm512_castsi512_ps(c)));
+    } else if constexpr (std::same_as<T, double>) {
+        return _mm512_castpd_si512(
+            _mm512_add_pd(_mm512_castsi512_pd(x), _mm512_castsi512_pd(c)));
+    } else if constexpr (sizeof(T) == 1) {
+        return s ? _mm512_adds_epi8(x, c) : _mm512_adds_epu8(x, c);
+    } else if constexpr (sizeof(T) == 2) {
+        return s ? _mm512_adds_epi16(x, c) : _mm512_adds_epu16(x, c);
+    } else if constexpr (sizeof(T) == 4) {
+        const __m512i r = _mm512_add_epi32(x, c);
+        if constexpr (s) {
+            const __mmask16 ov = _mm512_cmplt_epi32_mask(
+                _mm512_and_si512(_mm512_xor_si512(x, r),
+                                 _mm512_xor_si512(c, r)),
+                _mm512_setzero_si512());
+            const __m512i sat = _mm512_xor_si512(
+                _mm512_srai_epi32(x, 31), _mm512_set1_epi32(INT32_MAX));
+            return _mm512_mask_mov_epi32(r, ov, sat);
+        } else {
+            return _mm512_mask_mov_epi32(r, _mm512_cmplt_epu32_mask(r, x),
+                                         _mm512_set1_epi32(-1));
+        }
+    } else {
+        const __m512i r = _mm512_add_epi64(x, c);
+        if constexpr (s) {
+            const __mmask8 ov = _mm512_cmplt_epi64_mask(
+                _mm512_and_si512(_mm512_xor_si512(x, r),
+                                 _mm512_xor_si512(c, r)),
+                _mm512_setzero_si512());
+            const __m512i sat = _mm512_xor_si512(
+                _mm512_srai_epi64(x, 63), _mm512_set1_epi64(INT64_MAX));
+            return _mm512_mask_mov_epi64(r, ov, sat);
+        } else {
+            return _mm512_mask_mov_epi64(r, _mm512_cmplt_epu64_mask(r, x),
+                                         _mm512_set1_epi64(-1));
+        }
+    }
+}
+
+template <lane_arithmetic T>
+void add_sat(const T* in, T* out, std::size_t n, T c) {
+    const __m512i k = splat(c);
+    map(in, out, n, [&](__m512i v) { return add_sat<T>(v, k); });
+}
+
+// inteiros estendidos para o dobro da largura, com ou sem sinal.
+template <lane_integral T>
+inline __m512i widen(__m256i v) {
+    constexpr bool s = std::is_signed_v<T>;
+    if constexpr (sizeof(T) == 1) {
+        return s ? _mm512_cvtepi8_epi16(v) : _mm512_cvtepu8_epi16(v);
+    } else if constexpr (sizeof(T) == 2) {
+        return s ? _mm512_cvtepi16_epi32(v) : _mm512_cvtepu16_epi32(v);
+    } else {
+        return s ? _mm512_cvtepi32_epi64(v) : _mm512_cvtepu32_epi64(v);
+    }
+}
+
+// inteiros: cada metade é estendida para o dobro da largura, onde o produto
+// é exato, e volta com saturação; os de 64 bits ficam com o escalar.
+template <lane_arithmetic T>
+inline constexpr bool has_mul_sat = std::floating_point<T> || sizeof(T) <= 4;
+
+template <lane_arithmetic T>
+inline __m512i mul_sat(__m512i x, __m512i c) {
+    constexpr bool s = std::is_signed_v<T>;
+    if constexpr (std::same_as<T, float>) {
+        return _mm512_castps_si512(
+            _mm512_mul_ps(_mm512_castsi512_ps(x), _mm512_castsi512_ps(c)));
+    } else if constexpr (std::same_as<T, double>) {
+        return _mm512_castpd_si512(
+            _mm512_mul_pd(_mm512_castsi512_pd(x), _mm512_castsi512_pd(c)));
+    } else {
+        auto product = [&](int half) {
+            const __m512i a = widen<T>(_mm512_extracti64x4_epi64(x, half));
+            const __m512i b = widen<T>(_mm512_extracti64x4_epi64(c, half));
+            if constexpr (sizeof(T) == 1) {
+                const __m512i p = _mm512_mullo_epi16(a, b);
+                return s ? _mm512_cvtsepi16_epi8(p) : _mm512_cvtusepi16_epi8(p);
+            } else if constexpr (sizeof(T) == 2) {
+                const __m512i p = _mm512_mullo_epi32(a, b);
+                return s ? _mm512_cvtsepi32_epi16(p)
+                         : _mm512_cvtusepi32_epi16(p);
+            } else {
+                const __m512i p =
+                    s ? _mm512_mul_epi32(a, b) : _mm512_mul_epu32(a, b);
+                return s ? _mm512_cvtsepi64_epi32(p)
+                         : _mm512_cvtusepi64_epi32(p);
+            }
+        };
+        return _mm512_inserti64x4(_mm512_castsi256_si512(product(0)),
+                                  product(1), 1);
+    }
+}
+
+template <lane_arithmetic T>
+void mul_sat(const T* in, T* out, std::size_t n, T c) {
+    if constexpr (has_mul_sat<T>) {
+        const __m512i k = splat(c);
+        map(in, out, n, [&](__m512i v) { return mul_sat<T>(v, k); });
+    } else {
+        for (std::size_t i = 0; i < n; ++i) out[i] = scalar::mul_sat(in[i], c);
+    }
+}
+
+template <std::floating_point T>
+void affine(const T* in, T* out, std::size_t n, T a, T b) {
+    const __m512i va = splat(a), vb = splat(b);
+    map(in, out, n, [&](__m512i v) {
+        if constexpr (std::same_as<T, float>) {
+            return _mm512_castps_si512(
+                _mm512_fmadd_ps(_mm512_castsi512_ps(va), _mm512_castsi512_ps(v),
+                                _mm512_castsi512_ps(vb)));
+        } else {
+            return _mm512_castpd_si512(
+                _mm512_fmadd_pd(_mm512_castsi512_pd(va), _mm512_castsi512_pd(v),
+                                _mm512_castsi512_pd(vb)));
+        }
+    });
+}
+
+// grava os inteiros de 'v' (de 'S' bytes cada) em 'p', truncados para
+// 'sizeof(To)' bytes, apenas nas posições de 'm'.
+template <std::size_t S, typename To>
+inline void store_narrowed(To* p, std::uint64_t m, __m512i v) {
+    if constexpr (S == sizeof(To)) {
+        mask_store(reinterpret_cast<uint_of_size_t<S>*>(p), m, v);
+    } else if constexpr (S == 2) {
+        _mm512_mask_cvtepi16_storeu_epi8(p, m, v);
+    } else if constexpr (S == 4 && sizeof(To) == 1) {
+        _mm512_mask_cvtepi32_storeu_epi8(p, m, v);
+    } else if constexpr (S == 4) {
+        _mm512_mask_cvtepi32_storeu_epi16(p, m, v);
+    } else if constexpr (sizeof(To) == 1) {
+        _mm512_mask_cvtepi64_storeu_epi8(p, m, v);
+    } else if constexpr (sizeof(To) == 2) {
+        _mm512_mask_cvtepi64_storeu_epi16(p, m, v);
+    } else {
+        _mm512_mask_cvtepi64_storeu_epi32(p, m, v);
+    }
+}
+
+template <lane_arithmetic From, lane_arithmetic To>
+    requires narrowable<From, To>
+void narrow(const From* in, To* out, std::size_t n) {
+    using U = uint_of_size_t<sizeof(From)>;
+    constexpr std::size_t L = 64 / sizeof(From);
+    auto* src = reinterpret_cast<const U*>(in);
+    [[maybe_unused]] const __m512i lo = splat(detail::narrow_lo<To, From>());
+    [[maybe_unused]] const __m512i hi = splat(detail::narrow_hi<To, From>());
+    [[maybe_unused]] const __m512i top =
+        splat(static_cast<std::uint32_t>(std::numeric_limits<To>::max()));
+    for (std::size_t i = 0; i < n; i += L) {
+        const std::size_t k = std::min(L, n - i);
+        const std::uint64_t m = tail_mask(k);
+        __m512i v = load_n(src + i, k);
+        if constexpr (std::same_as<To, float>) {
+            _mm256_mask_storeu_ps(out + i, m,
+                                  _mm512_cvtpd_ps(_mm512_castsi512_pd(v)));
+        } else if constexpr (std::same_as<From, float>) {
+            const __m512 f = _mm512_castsi512_ps(v);
+            const __mmask16 above =
+                _mm512_cmp_ps_mask(f, _mm512_castsi512_ps(hi), _CMP_GT_OQ);
+            v = _mm512_maskz_mov_epi32(_mm512_cmp_ps_mask(f, f, _CMP_ORD_Q), v);
+            v = vmin<From>(hi, vmax<From>(lo, v));
+            const __m512 g = _mm512_castsi512_ps(v);
+            const __m512i r = std::is_unsigned_v<To> && sizeof(To) == 4
+                                  ? _mm512_cvtps_epu32(g)
+                                  : _mm512_cvtps_epi32(g);
+            store_narrowed<4>(out + i, m, _mm512_mask_mov_epi32(r, above, top));
+        } else if constexpr (std::same_as<From, double>) {
+            const __m512d f = _mm512_castsi512_pd(v);
+            v = _mm512_maskz_mov_epi64(_mm512_cmp_pd_mask(f, f, _CMP_ORD_Q), v);
+            v = vmin<From>(hi, vmax<From>(lo, v));
+            const __m512d g = _mm512_castsi512_pd(v);
+            // 8 inteiros de 32 bits na metade baixa.
+            const __m512i w = _mm512_castsi256_si512(
+                std::is_unsigned_v<To> && sizeof(To) == 4
+                    ? _mm512_cvtpd_epu32(g)
+                    : _mm512_cvtpd_epi32(g));
+            store_narrowed<4>(out + i, m, w);
+        } else {
+            store_narrowed<sizeof(From)>(out + i, m,
+                                         vmin<From>(hi, vmax<From>(lo, v)));
+        }
+    }
+}
+}  // namespace avx512
+#pragma GCC diagnostic pop
+#pragma GCC pop_options
+#endif
+
+namespace detail {
+// 'affine' no AVX2 usa 'fma', que o ISA detectado não garante.
+inline bool has_fma() {
+#if SIMD_X86
+    static const bool fma = __builtin_cpu_supports("fma");
+    return fma;
+#else
+    return false;
+#endif
+}
+}  // namespace detail
+
+// acesso de baixo nível: lê [in, in + n) e escreve em 'out', que pode ser
+// igual a 'in' (no lugar).
+template <lane_arithmetic T>
+void clamp_values(const T* in, T* out, std::size_t n, T lo, T hi) {
+#if SIMD_X86
+    switch (active_isa()) {
+        case isa::avx512:
+            return avx512::clamp(in, out, n, lo, hi);
+        case isa::avx2:
+            return avx2::clamp(in, out, n, lo, hi);
+        case isa::scalar:
+            break;
+    }
+#endif
+    for (std::size_t i = 0; i < n; ++i) out[i] = scalar::clamp(in[i], lo, hi);
+}
+
+template <lane_arithmetic T>
+void abs_values(const T* in, T* out, std::size_t n) {
+#if SIMD_X86
+    switch (active_isa()) {
+        case isa::avx512:
+            return avx512::abs(in, out, n);
+        case isa::avx2:
+            return avx2::abs(in, out, n);
+        case isa::scalar:
+            break;
+    }
+#endif
+    for (std::size_t i = 0; i < n; ++i) out[i] = scalar::abs(in[i]);
+}
+
+template <lane_arithmetic T>
+void add_sat_values(const T* in, T* out, std::size_t n, T c) {
+#if SIMD_X86
+    switch (active_isa()) {
+        case isa::avx512:
+            return avx512::add_sat(in, out, n, c);
+        case isa::avx2:
+            return avx2::add_sat(in, out, n, c);
+        case isa::scalar:
+            break;
+    }
+#endif
+    for (std::size_t i = 0; i < n; ++i) out[i] = scalar::add_sat(in[i], c);
+}
+
+template <lane_arithmetic T>
+void mul_sat_values(const T* in, T* out, std::size_t n, T c) {
+#if SIMD_X86
+    switch (active_isa()) {
+        case isa::avx512:
+            return avx512::mul_sat(in, out, n, c);
+        case isa::avx2:
+            return avx2::mul_sat(in, out, n, c);
+        case isa::scalar:
+            break;
+    }
+#endif
+    for (std::size_t i = 0; i < n; ++i) out[i] = scalar::mul_sat(in[i], c);
+}
+
+template <std::floating_point T>
+void affine_values(const T* in, T* out, std::size_t n, T a, T b) {
+#if SIMD_X86
+    switch (active_isa()) {
+        case isa::avx512:
+            return avx512::affine(in, out, n, a, b);
+        case isa::avx2:
+            if (detail::has_fma()) return avx2::affine(in, out, n, a, b);
+            break;
+        case isa::scalar:
+            break;
+    }
+#endif
+    for (std::size_t i = 0; i < n; ++i) out[i] = scalar::affine(in[i], a, b);
+}
+
+template <lane_arithmetic From, lane_arithmetic To>
+    requires narrowable<From, To>
+void narrow_values(const From* in, To* out, std::size_t n) {
+#if SIMD_X86
+    switch (active_isa()) {
+        case isa::avx512:
+            return avx512::narrow(in, out, n);
+        case isa::avx2:
+            return avx2::narrow(in, out, n);
+        case isa::scalar:
+            break;
+    }
+#endif
+    for (std::size_t i = 0; i < n; ++i) out[i] = scalar::narrow<To>(in[i]);
+}
+
+namespace detail {
+// cada operação dá o kernel ('apply'), a versão escalar ('value'), o número
+// de parâmetros e os tipos de elemento aceitos.
+struct clamp_op {
+    static constexpr std::size_t arity = 2;
+    template <typename T>
+    static constexpr bool accepts = true;
+
+    template <typename T>
+    static void apply(const T* in, T* out, std::size_t n, T lo, T hi) {
+        clamp_values(in, out, n, lo, hi);
+    }
+    template <typename T>
+    static T value(T x, T lo, T hi) {
+        return scalar::clamp(x, lo, hi);
+    }
+};
+
+struct abs_op {
+    static constexpr std::size_t arity = 0;
+    template <typename T>
+    static constexpr bool accepts = true;
+
+    template <typename T>
+    static void apply(const T* in, T* out, std::size_t n) {
+        abs_values(in, out, n);
+    }
+    template <typename T>
+    static T value(T x) {
+        return scalar::abs(x);
+    }
+};
+
+struct add_sat_op {
+    static constexpr std::size_t arity = 1;
+    template <typename T>
+    static constexpr bool accepts = true;
+
+    template <typename T>
+    static void apply(const T* in, T* out, std::size_t n, T c) {
+        add_sat_values(in, out, n, c);
+    }
+    template <typename T>
+    static T value(T x, T c) {
+        return scalar::add_sat(x, c);
+    }
+};
+
+struct mul_sat_op {
+    static constexpr std::size_t arity = 1;
+    template <typename T>
+    static constexpr bool accepts = true;
+
+    template <typename T>
+    static void apply(const T* in, T* out, std::size_t n, T c) {
+        mul_sat_values(in, out, n, c);
+    }
+    template <typename T>
+    static T value(T x, T c) {
+        return scalar::mul_sat(x, c);
+    }
+};
+
+struct affine_op {
+    static constexpr std::size_t arity = 2;
+    template <typename T>
+    static constexpr bool accepts = std::floating_point<T>;
+
+    template <typename T>
+    static void apply(const T* in, T* out, std::size_t n, T a, T b) {
+        affine_values(in, out, n, a, b);
+    }
+    template <typename T>
+    static T value(T x, T a, T b) {
+        return scalar::affine(x, a, b);
+    }
+};
+
+template <typename R, typename Op, typename... A>
+concept elementwise_args =
+    lane_arithmetic<std::ranges::range_value_t<R>> &&
+    Op::template accepts<std::ranges::range_value_t<R>> &&
+    sizeof...(A) == Op::arity &&
+    (std::convertible_to<const A&, std::ranges::range_value_t<R>> && ...);
+
+// forma no lugar: 'op(r, args...)' e 'op(policy, r, args...)'.
+template <typename Op>
+struct elementwise_fn {
+    template <std::ranges::input_range R, typename... A>
+        requires elementwise_args<R, Op, A...> &&
+                 std::indirectly_writable<std::ranges::iterator_t<R>,
+                                          std::ranges::range_value_t<R>>
+    std::ranges::borrowed_iterator_t<R> operator()(R&& r,
+                                                   const A&... args) const {
+        using E = std::ranges::range_value_t<R>;
+        if constexpr (std::ranges::random_access_range<R> &&
+                      std::ranges::sized_range<R>) {
+            return (*this)(std::execution::seq, std::forward<R>(r), args...);
+        } else {
+            auto first = std::ranges::begin(r);
+            for (; first != std::ranges::end(r); ++first) {
+                *first = Op::value(static_cast<E>(*first),
+                                   static_cast<E>(args)...);
+            }
+            return first;
+        }
+    }
+
+    template <parallel::execution_policy P,
+              std::ranges::random_access_range R, typename... A>
+        requires std::ranges::sized_range<R> &&
+                 elementwise_args<R, Op, A...> &&
+                 std::indirectly_writable<std::ranges::iterator_t<R>,
+                                          std::ranges::range_value_t<R>>
+    std::ranges::borrowed_iterator_t<R> operator()(P&& policy, R&& r,
+                                                   const A&... args) const {
+        using E = std::ranges::range_value_t<R>;
+        auto first = std::ranges::begin(r);
+        const std::size_t n = std::ranges::size(r);
+        if constexpr (replaceable_range<R>) {
+            E* p = std::ranges::data(r);
+            for_each_block(policy, n, [&](std::size_t b, std::size_t e) {
+                Op::apply(p + b, p + b, e - b, static_cast<E>(args)...);
+            });
+        } else {
+            for_each_block(policy, n, [&](std::size_t b, std::size_t e) {
+                for (std::size_t i = b; i < e; ++i) {
+                    first[i] = Op::value(static_cast<E>(first[i]),
+                                         static_cast<E>(args)...);
+                }
+            });
+        }
+        return first + n;
+    }
+};
+
+// forma '_copy': 'op(r, out, args...)' e 'op(policy, r, out, args...)'.
+template <typename Op>
+struct elementwise_copy_fn {
+    template <std::ranges::input_range R, std::weakly_incrementable O,
+              typename... A>
+        requires elementwise_args<R, Op, A...> &&
+                 std::indirectly_writable<O, std::ranges::range_value_t<R>>
+    std::ranges::in_out_result<std::ranges::borrowed_iterator_t<R>, O>
+    operator()(R&& r, O out, const A&... args) const {
+        return (*this)(std::execution::seq, std::forward<R>(r), std::move(out),
+                       args...);
+    }
+
+    template <parallel::execution_policy P, std::ranges::input_range R,
+              std::weakly_incrementable O, typename... A>
+        requires elementwise_args<R, Op, A...> &&
+                 std::indirectly_writable<O, std::ranges::range_value_t<R>>
+    std::ranges::in_out_result<std::ranges::borrowed_iterator_t<R>, O>
+    operator()(P&& policy, R&& r, O out, const A&... args) const {
+        using E = std::ranges::range_value_t<R>;
+        if constexpr (std::ranges::contiguous_range<R> &&
+                      std::ranges::sized_range<R> &&
+                      contiguous_output<O, E>) {
+            const std::size_t n = std::ranges::size(r);
+            const E* in = std::ranges::data(r);
+            E* dst = output_for<E>(out, n);
+            for_each_block(policy, n, [&](std::size_t b, std::size_t e) {
+                Op::apply(in + b, dst + b, e - b, static_cast<E>(args)...);
+            });
+            return {std::ranges::begin(r) + n, advanced(out, n)};
+        } else {
+            auto [last, o] = std::ranges::transform(
+                r, std::move(out), [&](const E& x) {
+                    return Op::value(x, static_cast<E>(args)...);
+                });
+            return {std::move(last), std::move(o)};
+        }
+    }
+};
+}  // namespace detail
+
+inline constexpr detail::elementwise_fn<detail::clamp_op> clamp{};
+inline constexpr detail::elementwise_copy_fn<detail::clamp_op> clamp_copy{};
+inline constexpr detail::elementwise_fn<detail::abs_op> abs{};
+inline constexpr detail::elementwise_copy_fn<detail::abs_op> abs_copy{};
+inline constexpr detail::elementwise_fn<detail::add_sat_op> add_sat{};
+inline constexpr detail::elementwise_copy_fn<detail::add_sat_op>
+    add_sat_copy{};
+inline constexpr detail::elementwise_fn<detail::mul_sat_op> mul_sat{};
+inline constexpr detail::elementwise_copy_fn<detail::mul_sat_op>
+    mul_sat_copy{};
+inline constexpr detail::elementwise_fn<detail::affine_op> affine{};
+inline constexpr detail::elementwise_copy_fn<detail::affine_op> affine_copy{};
+
+// converte para o tipo dos elementos do destino ('narrowable').
+struct narrow_copy_fn {
+    template <std::ranges::input_range R, std::weakly_incrementable O>
+        requires narrowable<std::ranges::range_value_t<R>,
+                            typename detail::output_value<O>::type>
+    std::ranges::in_out_result<std::ranges::borrowed_iterator_t<R>, O>
+    operator()(R&& r, O out) const {
+        return (*this)(std::execution::seq, std::forward<R>(r), std::move(out));
+    }
+
+    template <parallel::execution_policy P, std::ranges::input_range R,
+              std::weakly_incrementable O>
+        requires narrowable<std::ranges::range_value_t<R>,
+                            typename detail::output_value<O>::type>
+    std::ranges::in_out_result<std::ranges::borrowed_iterator_t<R>, O>
+    operator()(P&& policy, R&& r, O out) const {
+        using E = std::ranges::range_value_t<R>;
+        using To = typename detail::output_value<O>::type;
+        if constexpr (std::ranges::contiguous_range<R> &&
+                      std::ranges::sized_range<R> &&
+                      detail::contiguous_output<O, To>) {
+            const std::size_t n = std::ranges::size(r);
+            const E* in = std::ranges::data(r);
+            To* dst = detail::output_for<To>(out, n);
+            detail::for_each_block(
+                policy, n, [&](std::size_t b, std::size_t e) {
+                    narrow_values(in + b, dst + b, e - b);
+                });
+            return {std::ranges::begin(r) + n, detail::advanced(out, n)};
+        } else {
+            auto [last, o] =
+                std::ranges::transform(r, std::move(out), [](const E& x) {
+                    return scalar::narrow<To>(x);
+                });
+            return {std::move(last), std::move(o)};
+        }
+    }
+};
+inline constexpr narrow_copy_fn narrow_copy{};
+
+}  // namespace simd
@@ -0,0 +1,412 @@
+#pragma once
+
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <execution>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+#include "simd_search.hpp"
+
+// Versões de 'replace', 'replace_if', 'replace_copy' e 'replace_copy_if' para
+// ranges contíguas de elementos aritméticos; as com valor são vetorizadas.
+// 'replace' compara cada vetor com o valor antigo e mistura ('blend') o valor
+// novo nas posições iguais; na versão no lugar, só os vetores com alguma
+// ocorrência são escritos (AVX-512 escreve apenas as posições alteradas, com
+// um store mascarado), o que evita tráfego de memória para sentinelas raras.
+// As versões com predicado são escalares: um predicado qualquer não vira uma
+// máscara de lanes. 'replace_if' é o da stl (que só escreve as posições
+// trocadas), dividido em blocos pela política; 'replace_copy_if' grava cada
+// elemento com uma seleção sem desvios ('pred(x) ? novo : x'), que o
+// compilador só vetoriza com otimização ('-O2' ou mais) e para predicados
+// simples.
+// As variantes '_copy' escrevem diretamente num destino contíguo; um
+// 'std::back_inserter' de um vector é redimensionado uma única vez, em vez de
+// crescer elemento a elemento. Todas aceitam uma política de execução, que
+// divide a range em blocos processados em paralelo.
+namespace simd {
+
+#if SIMD_X86
+#pragma GCC push_options
+#pragma GCC target("avx2,bmi,popcnt")
+namespace avx2 {
+// igualdade por elemento como máscara de lanes (float/double: '==' ordenado).
+template <lane_arithmetic T>
+inline __m256i eq_lanes(__m256i v, __m256i needle) {
+    if constexpr (std::same_as<T, float>) {
+        return _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(v),
+                                                 _mm256_castsi256_ps(needle),
+                                                 _CMP_EQ_OQ));
+    } else if constexpr (std::same_as<T, double>) {
+        return _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(v),
+                                                 _mm256_castsi256_pd(needle),
+                                                 _CMP_EQ_OQ));
+    } else {
+        return cmpeq<T>(v, needle);
+    }
+}
+
+// 'out' pode ser igual a 'in' (no lugar): então só vetores alterados são
+// escritos.
+template <lane_arithmetic T>
+void replace(const T* in, T* out, std::size_t n, T old_value, T new_value) {
+    using U = uint_of_size_t<sizeof(T)>;
+    constexpr std::size_t L = 32 / sizeof(T);
+    const __m256i o = broadcast<U>(std::bit_cast<U>(old_value));
+    const __m256i w = broadcast<U>(std::bit_cast<U>(new_value));
+    std::size_t i = 0;
+    for (; i + L <= n; i += L) {
+        const __m256i v = load(in + i);
+        const __m256i m = eq_lanes<T>(v, o);
+        if (in != out || !_mm256_testz_si256(m, m)) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                                _mm256_blendv_epi8(v, w, m));
+        }
+    }
+    for (; i < n; ++i) out[i] = in[i] == old_value ? new_value : in[i];
+}
+}  // namespace avx2
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512bw,avx512vl,bmi,bmi2,popcnt")
+namespace avx512 {
+template <lane_arithmetic T>
+inline std::uint64_t eq_lanes(__m512i v, __m512i needle) {
+    if constexpr (std::same_as<T, float>) {
+        return _mm512_cmp_ps_mask(_mm512_castsi512_ps(v),
+                                  _mm512_castsi512_ps(needle), _CMP_EQ_OQ);
+    } else if constexpr (std::same_as<T, double>) {
+        return _mm512_cmp_pd_mask(_mm512_castsi512_pd(v),
+                                  _mm512_castsi512_pd(needle), _CMP_EQ_OQ);
+    } else {
+        return cmpeq<T>(v, needle);
+    }
+}
+
+// escreve apenas os elementos de 'v' com o bit correspondente em 'm'.
+template <lane_integral U>
+inline void mask_store(U* p, std::uint64_t m, __m512i v) {
+    if constexpr (sizeof(U) == 1) _mm512_mask_storeu_epi8(p, m, v);
+    if constexpr (sizeof(U) == 2) _mm512_mask_storeu_epi16(p, m, v);
+    if constexpr (sizeof(U) == 4) _mm512_mask_storeu_epi32(p, m, v);
+    if constexpr (sizeof(U) == 8) _mm512_mask_storeu_epi64(p, m, v);
+}
+
+// 'v' com os elementos de 'w' nas posições de 'm'.
+template <lane_integral U>
+inline __m512i blend(std::uint64_t m, __m512i v, __m512i w) {
+    if constexpr (sizeof(U) == 1) return _mm512_mask_mov_epi8(v, m, w);
+    if constexpr (sizeof(U) == 2) return _mm512_mask_mov_epi16(v, m, w);
+    if constexpr (sizeof(U) == 4) return _mm512_mask_mov_epi32(v, m, w);
+    if constexpr (sizeof(U) == 8) return _mm512_mask_mov_epi64(v, m, w);
+}
+
+template <lane_arithmetic T>
+void replace(const T* in, T* out, std::size_t n, T old_value, T new_value) {
+    using U = uint_of_size_t<sizeof(T)>;
+    constexpr std::size_t L = 64 / sizeof(T);
+    const __m512i o = broadcast<U>(std::bit_cast<U>(old_value));
+    const __m512i w = broadcast<U>(std::bit_cast<U>(new_value));
+    auto* src = reinterpret_cast<const U*>(in);
+    auto* dst = reinterpret_cast<U*>(out);
+    for (std::size_t i = 0; i < n; i += L) {
+        const std::size_t k = std::min(L, n - i);
+        const std::uint64_t t = tail_mask(k);
+        const __m512i v = load_n(src + i, k);
+        const std::uint64_t m = eq_lanes<T>(v, o) & t;
+        if (in == out) {
+            if (m) mask_store(dst + i, m, w);
+        } else {
+            mask_store(dst + i, t, blend<U>(m, v, w));
+        }
+    }
+}
+}  // namespace avx512
+#pragma GCC pop_options
+#endif
+
+// acesso de baixo nível: copia [in, in + n) para 'out' trocando 'old_value'
+// por 'new_value'; 'out == in' substitui no lugar.
+template <lane_arithmetic T>
+void replace_values(const T* in, T* out, std::size_t n, T old_value,
+                    T new_value) {
+#if SIMD_X86
+    switch (active_isa()) {
+        case isa::avx512:
+            return avx512::replace(in, out, n, old_value, new_value);
+        case isa::avx2:
+            return avx2::replace(in, out, n, old_value, new_value);
+        case isa::scalar:
+            break;
+    }
+#endif
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = in[i] == old_value ? new_value : in[i];
+    }
+}
+
+namespace detail {
+template <typename T, typename Pred, typename Proj>
+void replace_if_values(const T* in, T* out, std::size_t n, Pred& pred,
+                       Proj& proj, const T& new_value) {
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = std::invoke(pred, std::invoke(proj, in[i])) ? new_value
+                                                              : in[i];
+    }
+}
+
+// aplica 'f(begin, end)' a cada bloco de [0, n), segundo a política.
+template <parallel::execution_policy P, typename F>
+void for_each_block(P&& policy, std::size_t n, F f) {
+    parallel::for_each_chunk(
+        policy, n, parallel::chunk_count(policy, n),
+        [&](std::size_t, std::size_t b, std::size_t e) { f(b, e); });
+}
+
+template <typename R>
+concept replaceable_range =
+    std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+    lane_arithmetic<std::ranges::range_value_t<R>> &&
+    std::is_lvalue_reference_v<std::ranges::range_reference_t<R>> &&
+    !std::is_const_v<
+        std::remove_reference_t<std::ranges::range_reference_t<R>>>;
+
+// elementos inteiros só aceitam um 'old_value' inteiro, como 'simd::find':
+// comparados num tipo de ponto flutuante, inteiros distintos podem ser iguais.
+template <typename R, typename T1, typename T2, typename Proj>
+concept replace_value_path =
+    std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+    lane_arithmetic<std::ranges::range_value_t<R>> &&
+    std::same_as<Proj, std::identity> && std::is_arithmetic_v<T1> &&
+    !std::same_as<T1, bool> &&
+    (std::floating_point<std::ranges::range_value_t<R>> ||
+     std::integral<T1>) &&
+    std::convertible_to<const T2&, std::ranges::range_value_t<R>>;
+
+template <typename Pred, typename Proj>
+auto composed_pred(Pred& pred, Proj& proj) {
+    return [&](auto&& x) -> bool {
+        return std::invoke(pred, std::invoke(proj, x));
+    };
+}
+}  // namespace detail
+
+struct replace_fn {
+    template <std::ranges::input_range R, typename T1, typename T2,
+              typename Proj = std::identity>
+        requires std::indirectly_writable<std::ranges::iterator_t<R>,
+                                          const T2&> &&
+                 std::indirect_binary_predicate<
+                     std::ranges::equal_to,
+                     std::projected<std::ranges::iterator_t<R>, Proj>,
+                     const T1*>
+    std::ranges::borrowed_iterator_t<R> operator()(R&& r, const T1& old_value,
+                                                   const T2& new_value,
+                                                   Proj proj = {}) const {
+        if constexpr (detail::replace_value_path<R, T1, T2, Proj>) {
+            using E = std::ranges::range_value_t<R>;
+            const std::size_t n = std::ranges::size(r);
+            if (auto lane = detail::as_lane<E>(old_value)) {
+                auto* p = std::ranges::data(r);
+                replace_values<E>(p, p, n, *lane, static_cast<E>(new_value));
+            }
+            return std::ranges::begin(r) + n;
+        } else {
+            return std::ranges::replace(r, old_value, new_value,
+                                        std::move(proj));
+        }
+    }
+
+    template <parallel::execution_policy P,
+              std::ranges::random_access_range R, typename T1, typename T2,
+              typename Proj = std::identity>
+        requires std::ranges::sized_range<R> &&
+                 std::indirectly_writable<std::ranges::iterator_t<R>,
+                                          const T2&> &&
+                 std::indirect_binary_predicate<
+                     std::ranges::equal_to,
+                     std::projected<std::ranges::iterator_t<R>, Proj>,
+                     const T1*>
+    std::ranges::borrowed_iterator_t<R> operator()(P&& policy, R&& r,
+                                                   const T1& old_value,
+                                                   const T2& new_value,
+                                                   Proj proj = {}) const {
+        auto first = std::ranges::begin(r);
+        const std::size_t n = std::ranges::size(r);
+        detail::for_each_block(policy, n, [&](std::size_t b, std::size_t e) {
+            (*this)(std::ranges::subrange(first + b, first + e), old_value,
+                    new_value, proj);
+        });
+        return first + n;
+    }
+};
+inline constexpr replace_fn replace{};
+
+struct replace_if_fn {
+    template <std::ranges::input_range R, typename T,
+              typename Proj = std::identity,
+              std::indirect_unary_predicate<
+                  std::projected<std::ranges::iterator_t<R>, Proj>>
+                  Pred>
+        requires std::indirectly_writable<std::ranges::iterator_t<R>,
+                                          const T&>
+    std::ranges::borrowed_iterator_t<R> operator()(R&& r, Pred pred,
+                                                   const T& new_value,
+                                                   Proj proj = {}) const {
+        return std::ranges::replace_if(r, std::move(pred), new_value,
+                                       std::move(proj));
+    }
+
+    template <parallel::execution_policy P,
+              std::ranges::random_access_range R, typename T,
+              typename Proj = std::identity,
+              std::indirect_unary_predicate<
+                  std::projected<std::ranges::iterator_t<R>, Proj>>
+                  Pred>
+        requires std::ranges::sized_range<R> &&
+                 std::indirectly_writable<std::ranges::iterator_t<R>,
+                                          const T&>
+    std::ranges::borrowed_iterator_t<R> operator()(P&& policy, R&& r,
+                                                   Pred pred,
+                                                   const T& new_value,
+                                                   Proj proj = {}) const {
+        auto first = std::ranges::begin(r);
+        const std::size_t n = std::ranges::size(r);
+        detail::for_each_block(policy, n, [&](std::size_t b, std::size_t e) {
+            (*this)(std::ranges::subrange(first + b, first + e), pred,
+                    new_value, proj);
+        });
+        return first + n;
+    }
+};
+inline constexpr replace_if_fn replace_if{};
+
+struct replace_copy_fn {
+    template <std::ranges::input_range R, typename T1, typename T2,
+              std::output_iterator<const T2&> O,
+              typename Proj = std::identity>
+        requires std::indirectly_copyable<std::ranges::iterator_t<R>, O> &&
+                 std::indirect_binary_predicate<
+                     std::ranges::equal_to,
+                     std::projected<std::ranges::iterator_t<R>, Proj>,
+                     const T1*>
+    std::ranges::replace_copy_result<std::ranges::borrowed_iterator_t<R>, O>
+    operator()(R&& r, O out, const T1& old_value, const T2& new_value,
+               Proj proj = {}) const {
+        return (*this)(std::execution::seq, std::forward<R>(r), std::move(out),
+                       old_value, new_value, std::move(proj));
+    }
+
+    template <parallel::execution_policy P, std::ranges::input_range R,
+              typename T1, typename T2, std::output_iterator<const T2&> O,
+              typename Proj = std::identity>
+        requires std::indirectly_copyable<std::ranges::iterator_t<R>, O> &&
+                 std::indirect_binary_predicate<
+                     std::ranges::equal_to,
+                     std::projected<std::ranges::iterator_t<R>, Proj>,
+                     const T1*>
+    std::ranges::replace_copy_result<std::ranges::borrowed_iterator_t<R>, O>
+    operator()(P&& policy, R&& r, O out, const T1& old_value,
+               const T2& new_value, Proj proj = {}) const {
+        using E = std::ranges::range_value_t<R>;
+        if constexpr (detail::replace_value_path<R, T1, T2, Proj> &&
+                      detail::contiguous_output<O, E>) {
+            const std::size_t n = std::ranges::size(r);
+            const E* in = std::ranges::data(r);
+            E* dst = detail::output_for<E>(out, n);
+            const auto lane = detail::as_lane<E>(old_value);
+            const E w = static_cast<E>(new_value);
+            auto block = [&](std::size_t b, std::size_t e) {
+                if (lane) {
+                    replace_values<E>(in + b, dst + b, e - b, *lane, w);
+                } else {
+                    std::copy(in + b, in + e, dst + b);
+                }
+            };
+            detail::for_each_block(policy, n, block);
+            return {std::ranges::begin(r) + n, detail::advanced(out, n)};
+        } else if constexpr (!parallel::is_sequenced<P>() &&
+                             std::ranges::random_access_range<R> &&
+                             std::ranges::sized_range<R> &&
+                             std::forward_iterator<O>) {
+            auto first = std::ranges::begin(r);
+            auto last = first + std::ranges::size(r);
+            auto pred = [&](auto&& x) -> bool {
+                return std::invoke(proj, x) == old_value;
+            };
+            return {last, std::replace_copy_if(policy, first, last,
+                                               std::move(out), pred,
+                                               new_value)};
+        } else {
+            return std::ranges::replace_copy(r, std::move(out), old_value,
+                                             new_value, std::move(proj));
+        }
+    }
+};
+inline constexpr replace_copy_fn replace_copy{};
+
+struct replace_copy_if_fn {
+    template <std::ranges::input_range R, typename T,
+              std::output_iterator<const T&> O, typename Proj = std::identity,
+              std::indirect_unary_predicate<
+                  std::projected<std::ranges::iterator_t<R>, Proj>>
+                  Pred>
+        requires std::indirectly_copyable<std::ranges::iterator_t<R>, O>
+    std::ranges::replace_copy_if_result<std::ranges::borrowed_iterator_t<R>, O>
+    operator()(R&& r, O out, Pred pred, const T& new_value,
+               Proj proj = {}) const {
+        return (*this)(std::execution::seq, std::forward<R>(r), std::move(out),
+                       std::move(pred), new_value, std::move(proj));
+    }
+
+    template <parallel::execution_policy P, std::ranges::input_range R,
+              typename T, std::output_iterator<const T&> O,
+              typename Proj = std::identity,
+              std::indirect_unary_predicate<
+                  std::projected<std::ranges::iterator_t<R>, Proj>>
+                  Pred>
+        requires std::indirectly_copyable<std::ranges::iterator_t<R>, O>
+    std::ranges::replace_copy_if_result<std::ranges::borrowed_iterator_t<R>, O>
+    operator()(P&& policy, R&& r, O out, Pred pred, const T& new_value,
+               Proj proj = {}) const {
+        using E = std::ranges::range_value_t<R>;
+        if constexpr (std::ranges::contiguous_range<R> &&
+                      std::ranges::sized_range<R> && lane_arithmetic<E> &&
+                      std::convertible_to<const T&, E> &&
+                      detail::contiguous_output<O, E>) {
+            const std::size_t n = std::ranges::size(r);
+            const E* in = std::ranges::data(r);
+            E* dst = detail::output_for<E>(out, n);
+            const E w = static_cast<E>(new_value);
+            auto block = [&](std::size_t b, std::size_t e) {
+                detail::replace_if_values(in + b, dst + b, e - b, pred, proj,
+                                          w);
+            };
+            detail::for_each_block(policy, n, block);
+            return {std::ranges::begin(r) + n, detail::advanced(out, n)};
+        } else if constexpr (!parallel::is_sequenced<P>() &&
+                             std::ranges::random_access_range<R> &&
+                             std::ranges::sized_range<R> &&
+                             std::forward_iterator<O>) {
+            auto first = std::ranges::begin(r);
+            auto last = first + std::ranges::size(r);
+            return {last, std::replace_copy_if(
+                              policy, first, last, std::move(out),
+                              detail::composed_pred(pred, proj), new_value)};
+        } else {
+            return std::ranges::replace_copy_if(r, std::move(out),
+                                                std::move(pred), new_value,
+                                                std::move(proj));
+        }
+    }
+};
+inline constexpr replace_copy_if_fn replace_copy_if{};
+
+}  // namespace simd
@@ -0,0 +1,452 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <execution>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+#include "simd_copy.hpp"
+
+// 'reverse', 'reverse_copy', 'rotate', 'rotate_copy', 'shift_left' e
+// 'shift_right' para ranges contíguas grandes de elementos trivialmente
+// copiáveis de 1, 2, 4 ou 8 bytes.
+// - 'reverse' troca vetores inteiros das duas pontas, invertendo a ordem dos
+//   elementos dentro de cada vetor com um único 'shuffle'/'permute';
+// - 'rotate' evita os ciclos com passo 'gcd' da libstdc++, cujos acessos
+//   espalhados não aproveitam a cache: se a parte menor cabe num buffer ela é
+//   guardada, a maior é deslocada com 'memmove' e a menor é copiada de volta;
+//   caso contrário usa a tripla inversão (inverte as duas partes e depois o
+//   todo), três varreduras sequenciais vetorizadas e sem memória extra;
+// - 'shift_left'/'shift_right' e os deslocamentos de 'rotate' são cópias com
+//   sobreposição do motor de 'simd_copy.hpp'.
+// Com uma política de execução paralela, as inversões são divididas entre as
+// threads por pares de blocos espelhados, e os deslocamentos são feitos em
+// ondas de 'k' elementos, cada uma copiada em paralelo.
+namespace simd {
+
+#if SIMD_X86
+#pragma GCC push_options
+#pragma GCC target("avx2,bmi,popcnt")
+namespace avx2 {
+// inverte a ordem dos elementos de 'S' bytes do vetor.
+template <std::size_t S>
+inline __m256i reverse_lanes(__m256i v) {
+    if constexpr (S == 1 || S == 2) {
+        const __m256i idx =
+            S == 1 ? _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4,
+                                      3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                      7, 6, 5, 4, 3, 2, 1, 0)
+                   : _mm256_setr_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5,
+                                      2, 3, 0, 1, 14, 15, 12, 13, 10, 11, 8, 9,
+                                      6, 7, 4, 5, 2, 3, 0, 1);
+        v = _mm256_shuffle_epi8(v, idx);
+        return _mm256_permute2x128_si256(v, v, 1);
+    } else if constexpr (S == 4) {
+        return _mm256_permutevar8x32_epi32(
+            v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+    } else {
+        return _mm256_permute4x64_epi64(v, 0x1b);
+    }
+}
+
+// troca 'x[j]' com 'y[len - 1 - j]' para 'j' em [0, len); devolve quantos
+// pares foram tratados (o restante, menor que um vetor, fica para o chamador).
+template <std::size_t S>
+std::size_t swap_reversed(std::byte* x, std::byte* y, std::size_t len) {
+    constexpr std::size_t L = 32 / S;
+    std::size_t j = 0;
+    for (; j + L <= len; j += L) {
+        auto* px = reinterpret_cast<__m256i*>(x + j * S);
+        auto* py = reinterpret_cast<__m256i*>(y + (len - j - L) * S);
+        const __m256i a = _mm256_loadu_si256(px);
+        const __m256i b = _mm256_loadu_si256(py);
+        _mm256_storeu_si256(px, reverse_lanes<S>(b));
+        _mm256_storeu_si256(py, reverse_lanes<S>(a));
+    }
+    return j;
+}
+
+// 'out[j] = in[n - 1 - j]'; devolve quantos elementos foram escritos.
+template <std::size_t S>
+std::size_t reverse_copy(const std::byte* in, std::byte* out, std::size_t n) {
+    constexpr std::size_t L = 32 / S;
+    std::size_t j = 0;
+    for (; j + L <= n; j += L) {
+        const __m256i a = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(in + (n - j - L) * S));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + j * S),
+                            reverse_lanes<S>(a));
+    }
+    return j;
+}
+}  // namespace avx2
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512bw,avx512vl,bmi,bmi2,popcnt")
+namespace avx512 {
+// as formas 'maskz' com máscara cheia evitam o falso '-Wmaybe-uninitialized'
+// do GCC 12 nas versões sem máscara, que partem de '_mm512_undefined_*'.
+template <std::size_t S>
+inline __m512i reverse_lanes(__m512i v) {
+    constexpr __mmask8 all = 0xff;
+    if constexpr (S == 1) {
+        // inverte os bytes de cada bloco de 128 bits e depois os blocos.
+        const __m512i idx = _mm512_set_epi64(
+            0x0001020304050607, 0x08090a0b0c0d0e0f, 0x0001020304050607,
+            0x08090a0b0c0d0e0f, 0x0001020304050607, 0x08090a0b0c0d0e0f,
+            0x0001020304050607, 0x08090a0b0c0d0e0f);
+        v = _mm512_maskz_shuffle_epi8(~__mmask64{0}, v, idx);
+        return _mm512_maskz_shuffle_i64x2(all, v, v, 0x1b);
+    } else if constexpr (S == 2) {
+        return _mm512_maskz_permutexvar_epi16(
+            ~__mmask32{0},
+            _mm512_set_epi16(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+                             15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26,
+                             27, 28, 29, 30, 31),
+            v);
+    } else if constexpr (S == 4) {
+        return _mm512_maskz_permutexvar_epi32(
+            __mmask16{0xffff},
+            _mm512_set_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+                             15),
+            v);
+    } else {
+        return _mm512_maskz_permutexvar_epi64(
+            all, _mm512_set_epi64(0, 1, 2, 3, 4, 5, 6, 7), v);
+    }
+}
+
+template <std::size_t S>
+std::size_t swap_reversed(std::byte* x, std::byte* y, std::size_t len) {
+    constexpr std::size_t L = 64 / S;
+    std::size_t j = 0;
+    for (; j + L <= len; j += L) {
+        std::byte* px = x + j * S;
+        std::byte* py = y + (len - j - L) * S;
+        const __m512i a = _mm512_loadu_si512(px);
+        const __m512i b = _mm512_loadu_si512(py);
+        _mm512_storeu_si512(px, reverse_lanes<S>(b));
+        _mm512_storeu_si512(py, reverse_lanes<S>(a));
+    }
+    return j;
+}
+
+template <std::size_t S>
+std::size_t reverse_copy(const std::byte* in, std::byte* out, std::size_t n) {
+    constexpr std::size_t L = 64 / S;
+    std::size_t j = 0;
+    for (; j + L <= n; j += L) {
+        _mm512_storeu_si512(
+            out + j * S,
+            reverse_lanes<S>(_mm512_loadu_si512(in + (n - j - L) * S)));
+    }
+    return j;
+}
+}  // namespace avx512
+#pragma GCC pop_options
+#endif
+
+namespace detail {
+// 'x[j] <-> y[len - 1 - j]' para 'j' em [0, len); 'x' e 'y' não se sobrepõem
+// (ou 'y' começa exatamente onde terminam os pares de 'x').
+template <lane_movable T>
+void swap_reversed(T* x, T* y, std::size_t len) {
+    auto* bx = reinterpret_cast<std::byte*>(x);
+    auto* by = reinterpret_cast<std::byte*>(y);
+    std::size_t j = 0;
+#if SIMD_X86
+    switch (active_isa()) {
+        case isa::avx512:
+            j = avx512::swap_reversed<sizeof(T)>(bx, by, len);
+            break;
+        case isa::avx2:
+            j = avx2::swap_reversed<sizeof(T)>(bx, by, len);
+            break;
+        case isa::scalar:
+            break;
+    }
+#endif
+    // os pares restantes formam o miolo: x[j, len) com y[0, len - j).
+    std::reverse(x + j, x + len);
+    std::reverse(y, y + (len - j));
+    std::swap_ranges(x + j, x + len, y);
+}
+
+template <lane_movable T>
+void reverse_copy(const T* in, T* out, std::size_t n) {
+    std::size_t j = 0;
+#if SIMD_X86
+    auto* bi = reinterpret_cast<const std::byte*>(in);
+    auto* bo = reinterpret_cast<std::byte*>(out);
+    switch (active_isa()) {
+        case isa::avx512:
+            j = avx512::reverse_copy<sizeof(T)>(bi, bo, n);
+            break;
+        case isa::avx2:
+            j = avx2::reverse_copy<sizeof(T)>(bi, bo, n);
+            break;
+        case isa::scalar:
+            break;
+    }
+#endif
+    std::reverse_copy(in, in + (n - j), out + j);
+}
+
+// inverte [p, p + n) com a política dada: cada bloco de pares [b, e) da
+// primeira metade é trocado com o bloco espelhado da segunda metade.
+template <parallel::execution_policy P, lane_movable T>
+void reverse(P&& policy, T* p, std::size_t n) {
+    const std::size_t half = n / 2;
+    parallel::for_each_chunk(
+        policy, half, parallel::chunk_count(policy, half),
+        [&](std::size_t, std::size_t b, std::size_t e) {
+            swap_reversed(p + b, p + (n - e), e - b);
+        });
+}
+
+// move [p + k, p + n) para [p, p + n - k).
+template <parallel::execution_policy P, lane_movable T>
+void move_down(P&& policy, T* p, std::size_t n, std::size_t k) {
+    copy_bytes(policy, p, p + k, (n - k) * sizeof(T));
+}
+
+// move [p, p + n - k) para [p + k, p + n).
+template <parallel::execution_policy P, lane_movable T>
+void move_up(P&& policy, T* p, std::size_t n, std::size_t k) {
+    copy_bytes(policy, p + k, p, (n - k) * sizeof(T));
+}
+
+// parte menor de uma rotação que ainda é rotacionada com buffer auxiliar.
+inline constexpr std::size_t rotate_buffer_bytes = 1 << 20;
+
+template <parallel::execution_policy P, lane_movable T>
+void rotate(P&& policy, T* p, std::size_t n, std::size_t k) {
+    const std::size_t m = n - k;
+    if (std::min(k, m) * sizeof(T) <= rotate_buffer_bytes) {
+        if (k <= m) {
+            std::unique_ptr<T[]> tmp(new T[k]);
+            std::memcpy(tmp.get(), p, k * sizeof(T));
+            move_down(policy, p, n, k);
+            std::memcpy(p + m, tmp.get(), k * sizeof(T));
+        } else {
+            std::unique_ptr<T[]> tmp(new T[m]);
+            std::memcpy(tmp.get(), p + k, m * sizeof(T));
+            move_up(policy, p, n, m);
+            std::memcpy(p, tmp.get(), m * sizeof(T));
+        }
+    } else {
+        reverse(policy, p, k);
+        reverse(policy, p + k, m);
+        reverse(policy, p, n);
+    }
+}
+
+template <typename R>
+concept movable_lane_range =
+    std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+    lane_movable<std::ranges::range_value_t<R>> &&
+    std::is_lvalue_reference_v<std::ranges::range_reference_t<R>> &&
+    !std::is_const_v<
+        std::remove_reference_t<std::ranges::range_reference_t<R>>>;
+}  // namespace detail
+
+struct reverse_fn {
+    template <std::ranges::bidirectional_range R>
+        requires std::permutable<std::ranges::iterator_t<R>>
+    std::ranges::borrowed_iterator_t<R> operator()(R&& r) const {
+        return (*this)(std::execution::seq, std::forward<R>(r));
+    }
+
+    template <parallel::execution_policy P, std::ranges::bidirectional_range R>
+        requires std::permutable<std::ranges::iterator_t<R>>
+    std::ranges::borrowed_iterator_t<R> operator()(P&& policy, R&& r) const {
+        if constexpr (detail::movable_lane_range<R>) {
+            const std::size_t n = std::ranges::size(r);
+            detail::reverse(policy, std::ranges::data(r), n);
+            return std::ranges::begin(r) + n;
+        } else if constexpr (!parallel::is_sequenced<P>() &&
+                             std::ranges::random_access_range<R> &&
+                             std::ranges::sized_range<R>) {
+            auto first = std::ranges::begin(r);
+            auto last = first + std::ranges::size(r);
+            std::reverse(policy, first, last);
+            return last;
+        } else {
+            return std::ranges::reverse(r);
+        }
+    }
+};
+inline constexpr reverse_fn reverse{};
+
+struct reverse_copy_fn {
+    template <std::ranges::bidirectional_range R, std::weakly_incrementable O>
+        requires std::indirectly_copyable<std::ranges::iterator_t<R>, O>
+    std::ranges::reverse_copy_result<std::ranges::borrowed_iterator_t<R>, O>
+    operator()(R&& r, O out) const {
+        return (*this)(std::execution::seq, std::forward<R>(r), std::move(out));
+    }
+
+    template <parallel::execution_policy P, std::ranges::bidirectional_range R,
+              std::weakly_incrementable O>
+        requires std::indirectly_copyable<std::ranges::iterator_t<R>, O>
+    std::ranges::reverse_copy_result<std::ranges::borrowed_iterator_t<R>, O>
+    operator()(P&& policy, R&& r, O out) const {
+        using T = std::ranges::range_value_t<R>;
+        if constexpr (std::ranges::contiguous_range<R> &&
+                      std::ranges::sized_range<R> && lane_movable<T> &&
+                      std::contiguous_iterator<O> &&
+                      std::same_as<std::iter_value_t<O>, T>) {
+            const std::size_t n = std::ranges::size(r);
+            const T* in = std::ranges::data(r);
+            T* dst = std::to_address(out);
+            parallel::for_each_chunk(
+                policy, n, parallel::chunk_count(policy, n),
+                [&](std::size_t, std::size_t b, std::size_t e) {
+                    detail::reverse_copy(in + (n - e), dst + b, e - b);
+                });
+            return {std::ranges::begin(r) + n, out + n};
+        } else {
+            return std::ranges::reverse_copy(r, std::move(out));
+        }
+    }
+};
+inline constexpr reverse_copy_fn reverse_copy{};
+
+struct rotate_fn {
+    template <std::ranges::forward_range R>
+        requires std::permutable<std::ranges::iterator_t<R>>
+    std::ranges::borrowed_subrange_t<R> operator()(
+        R&& r, std::ranges::iterator_t<R> middle) const {
+        return (*this)(std::execution::seq, std::forward<R>(r), middle);
+    }
+
+    template <parallel::execution_policy P, std::ranges::forward_range R>
+        requires std::permutable<std::ranges::iterator_t<R>>
+    std::ranges::borrowed_subrange_t<R> operator()(
+        P&& policy, R&& r, std::ranges::iterator_t<R> middle) const {
+        if constexpr (detail::movable_lane_range<R>) {
+            auto first = std::ranges::begin(r);
+            const std::size_t n = std::ranges::size(r);
+            const auto k = static_cast<std::size_t>(middle - first);
+            if (k == 0) return {first + n, first + n};
+            if (k == n) return {first, first + n};
+            detail::rotate(policy, std::ranges::data(r), n, k);
+            return {first + (n - k), first + n};
+        } else if constexpr (!parallel::is_sequenced<P>() &&
+                             std::ranges::random_access_range<R> &&
+                             std::ranges::sized_range<R>) {
+            auto first = std::ranges::begin(r);
+            auto last = first + std::ranges::size(r);
+            return {std::rotate(policy, first, middle, last), last};
+        } else {
+            return std::ranges::rotate(r, middle);
+        }
+    }
+};
+inline constexpr rotate_fn rotate{};
+
+struct rotate_copy_fn {
+    template <std::ranges::forward_range R, std::weakly_incrementable O>
+        requires std::indirectly_copyable<std::ranges::iterator_t<R>, O>
+    std::ranges::rotate_copy_result<std::ranges::borrowed_iterator_t<R>, O>
+    operator()(R&& r, std::ranges::iterator_t<R> middle, O out) const {
+        return (*this)(std::execution::seq, std::forward<R>(r), middle,
+                       std::move(out));
+    }
+
+    template <parallel::execution_policy P, std::ranges::forward_range R,
+              std::weakly_incrementable O>
+        requires std::indirectly_copyable<std::ranges::iterator_t<R>, O>
+    std::ranges::rotate_copy_result<std::ranges::borrowed_iterator_t<R>, O>
+    operator()(P&& policy, R&& r, std::ranges::iterator_t<R> middle,
+               O out) const {
+        using T = std::ranges::range_value_t<R>;
+        if constexpr (std::ranges::contiguous_range<R> &&
+                      std::ranges::sized_range<R> && lane_movable<T> &&
+                      std::contiguous_iterator<O> &&
+                      std::same_as<std::iter_value_t<O>, T>) {
+            auto first = std::ranges::begin(r);
+            const std::size_t n = std::ranges::size(r);
+            const auto k = static_cast<std::size_t>(middle - first);
+            const T* in = std::ranges::data(r);
+            T* dst = std::to_address(out);
+            detail::copy_bytes(policy, dst, in + k, (n - k) * sizeof(T));
+            detail::copy_bytes(policy, dst + (n - k), in, k * sizeof(T));
+            return {first + n, out + n};
+        } else {
+            return std::ranges::rotate_copy(r, middle, std::move(out));
+        }
+    }
+};
+inline constexpr rotate_copy_fn rotate_copy{};
+
+// como 'std::ranges::shift_left' (C++23): devolve [begin, begin + n - k). A
+// libstdc++ não tem versão paralela de 'std::shift_left', então elementos que
+// não são 'lane_movable' são deslocados sequencialmente.
+struct shift_left_fn {
+    template <std::ranges::forward_range R>
+        requires std::permutable<std::ranges::iterator_t<R>>
+    std::ranges::borrowed_subrange_t<R> operator()(
+        R&& r, std::ranges::range_difference_t<R> k) const {
+        return (*this)(std::execution::seq, std::forward<R>(r), k);
+    }
+
+    template <parallel::execution_policy P, std::ranges::forward_range R>
+        requires std::permutable<std::ranges::iterator_t<R>>
+    std::ranges::borrowed_subrange_t<R> operator()(
+        P&& policy, R&& r, std::ranges::range_difference_t<R> k) const {
+        auto first = std::ranges::begin(r);
+        if constexpr (detail::movable_lane_range<R>) {
+            const std::size_t n = std::ranges::size(r);
+            if (k <= 0) return {first, first + n};
+            if (static_cast<std::size_t>(k) >= n) return {first, first};
+            detail::move_down(policy, std::ranges::data(r), n,
+                              static_cast<std::size_t>(k));
+            return {first, first + (n - k)};
+        } else {
+            auto last = std::ranges::next(first, std::ranges::end(r));
+            return {first, std::shift_left(first, last, k)};
+        }
+    }
+};
+inline constexpr shift_left_fn shift_left{};
+
+// como 'std::ranges::shift_right' (C++23): devolve [begin + k, end).
+struct shift_right_fn {
+    template <std::ranges::forward_range R>
+        requires std::permutable<std::ranges::iterator_t<R>>
+    std::ranges::borrowed_subrange_t<R> operator()(
+        R&& r, std::ranges::range_difference_t<R> k) const {
+        return (*this)(std::execution::seq, std::forward<R>(r), k);
+    }
+
+    template <parallel::execution_policy P, std::ranges::forward_range R>
+        requires std::permutable<std::ranges::iterator_t<R>>
+    std::ranges::borrowed_subrange_t<R> operator()(
+        P&& policy, R&& r, std::ranges::range_difference_t<R> k) const {
+        auto first = std::ranges::begin(r);
+        if constexpr (detail::movable_lane_range<R>) {
+            const std::size_t n = std::ranges::size(r);
+            if (k <= 0) return {first, first + n};
+            if (static_cast<std::size_t>(k) >= n) return {first + n, first + n};
+            detail::move_up(policy, std::ranges::data(r), n,
+                            static_cast<std::size_t>(k));
+            return {first + k, first + n};
+        } else {
+            auto last = std::ranges::next(first, std::ranges::end(r));
+            return {std::shift_right(first, last, k), last};
+        }
+    }
+};
+inline constexpr shift_right_fn shift_right{};
+
+}  // namespace simd
@@ -0,0 +1,757 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <functional>
+#include <optional>
+#include <ranges>
+#include <utility>
+#include <vector>
+
+#include "simd.hpp"
+
+// Versões vetorizadas de 'find', 'find_first_of', 'count', 'adjacent_find',
+// 'search_n', 'mismatch' e 'equal', e um 'count_if' escalar sem desvios.
+// Para ranges contíguas de inteiros (char, uint8_t, int32_t, int64_t, ...), e
+// também de float/double no caso de 'adjacent_find', 'mismatch' e 'equal',
+// os objetos 'simd::find', 'simd::count', etc. despacham para kernels AVX2 ou
+// AVX-512 escolhidos em tempo de execução; nos demais casos delegam para o
+// respectivo algoritmo de 'std::ranges', de forma que podem ser utilizados
+// como substitutos diretos.
+namespace simd {
+
+namespace scalar {
+template <lane_integral T>
+std::size_t find(const T* p, std::size_t n, T v) {
+    if constexpr (sizeof(T) == 1) {
+        // 'memchr' já é vetorizado pela libc; não aceita ponteiro nulo, nem
+        // com 'n == 0' (o 'data()' de um vetor vazio).
+        if (n == 0) return 0;
+        auto r = std::memchr(p, static_cast<unsigned char>(v), n);
+        return r ? static_cast<const T*>(r) - p : n;
+    } else {
+        for (std::size_t i = 0; i < n; ++i) {
+            if (p[i] == v) return i;
+        }
+        return n;
+    }
+}
+
+template <lane_integral T>
+std::size_t count(const T* p, std::size_t n, T v) {
+    std::size_t c = 0;
+    for (std::size_t i = 0; i < n; ++i) c += p[i] == v;
+    return c;
+}
+
+template <lane_integral T>
+std::size_t find_first_of(const T* p, std::size_t n, const T* set,
+                          std::size_t m) {
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < m; ++j) {
+            if (p[i] == set[j]) return i;
+        }
+    }
+    return n;
+}
+template <lane_integral T>
+std::size_t find_not(const T* p, std::size_t n, T v) {
+    for (std::size_t i = 0; i < n; ++i) {
+        if (p[i] != v) return i;
+    }
+    return n;
+}
+
+template <lane_arithmetic T>
+std::size_t mismatch(const T* a, const T* b, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        if (!(a[i] == b[i])) return i;
+    }
+    return n;
+}
+}  // namespace scalar
+
+#if SIMD_X86
+#pragma GCC push_options
+#pragma GCC target("avx2,bmi,popcnt")
+namespace avx2 {
+template <lane_integral T>
+inline __m256i broadcast(T v) {
+    if constexpr (sizeof(T) == 1) return _mm256_set1_epi8(static_cast<char>(v));
+    if constexpr (sizeof(T) == 2)
+        return _mm256_set1_epi16(static_cast<short>(v));
+    if constexpr (sizeof(T) == 4) return _mm256_set1_epi32(static_cast<int>(v));
+    if constexpr (sizeof(T) == 8)
+        return _mm256_set1_epi64x(static_cast<long long>(v));
+}
+
+template <lane_integral T>
+inline __m256i cmpeq(__m256i a, __m256i b) {
+    if constexpr (sizeof(T) == 1) return _mm256_cmpeq_epi8(a, b);
+    if constexpr (sizeof(T) == 2) return _mm256_cmpeq_epi16(a, b);
+    if constexpr (sizeof(T) == 4) return _mm256_cmpeq_epi32(a, b);
+    if constexpr (sizeof(T) == 8) return _mm256_cmpeq_epi64(a, b);
+}
+
+inline __m256i load(const void* p) {
+    return _mm256_loadu_si256(static_cast<const __m256i*>(p));
+}
+
+// 'movemask_epi8' gera 'sizeof(T)' bits por elemento igual.
+inline std::uint32_t movemask(__m256i m) {
+    return static_cast<std::uint32_t>(_mm256_movemask_epi8(m));
+}
+
+template <lane_integral T>
+std::size_t find(const T* p, std::size_t n, T v) {
+    constexpr std::size_t L = 32 / sizeof(T);
+    const __m256i needle = broadcast(v);
+    std::size_t i = 0;
+    // desenrolado 2x: um único teste por 64 bytes, como no 'memchr'.
+    for (; i + 2 * L <= n; i += 2 * L) {
+        __m256i a = cmpeq<T>(load(p + i), needle);
+        __m256i b = cmpeq<T>(load(p + i + L), needle);
+        if (!_mm256_testz_si256(_mm256_or_si256(a, b),
+                                _mm256_or_si256(a, b))) {
+            if (std::uint32_t m = movemask(a)) {
+                return i + std::countr_zero(m) / sizeof(T);
+            }
+            return i + L + std::countr_zero(movemask(b)) / sizeof(T);
+        }
+    }
+    for (; i + L <= n; i += L) {
+        if (std::uint32_t m = movemask(cmpeq<T>(load(p + i), needle))) {
+            return i + std::countr_zero(m) / sizeof(T);
+        }
+    }
+    for (; i < n; ++i) {
+        if (p[i] == v) return i;
+    }
+    return n;
+}
+
+template <lane_integral T>
+std::size_t count(const T* p, std::size_t n, T v) {
+    constexpr std::size_t L = 32 / sizeof(T);
+    const __m256i needle = broadcast(v);
+    std::size_t bits = 0;
+    std::size_t i = 0;
+    for (; i + L <= n; i += L) {
+        bits += std::popcount(movemask(cmpeq<T>(load(p + i), needle)));
+    }
+    return bits / sizeof(T) + scalar::count(p + i, n - i, v);
+}
+
+template <lane_integral T>
+std::size_t find_first_of(const T* p, std::size_t n, const T* set,
+                          std::size_t m) {
+    constexpr std::size_t L = 32 / sizeof(T);
+    __m256i needles[16];
+    for (std::size_t j = 0; j < m; ++j) needles[j] = broadcast(set[j]);
+    std::size_t i = 0;
+    for (; i + L <= n; i += L) {
+        const __m256i x = load(p + i);
+        __m256i hit = _mm256_setzero_si256();
+        for (std::size_t j = 0; j < m; ++j) {
+            hit = _mm256_or_si256(hit, cmpeq<T>(x, needles[j]));
+        }
+        if (std::uint32_t mask = movemask(hit)) {
+            return i + std::countr_zero(mask) / sizeof(T);
+        }
+    }
+    return i + scalar::find_first_of(p + i, n - i, set, m);
+}
+// igualdade elemento a elemento entre 'a[0..L)' e 'b[0..L)'; para ponto
+// flutuante usa comparação ordenada (NaN != NaN, -0.0 == +0.0), como '=='.
+template <lane_arithmetic T>
+inline std::uint32_t eq_mask(const T* a, const T* b) {
+    if constexpr (std::same_as<T, float>) {
+        return movemask(_mm256_castps_si256(
+            _mm256_cmp_ps(_mm256_loadu_ps(a), _mm256_loadu_ps(b), _CMP_EQ_OQ)));
+    } else if constexpr (std::same_as<T, double>) {
+        return movemask(_mm256_castpd_si256(
+            _mm256_cmp_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b), _CMP_EQ_OQ)));
+    } else {
+        return movemask(cmpeq<T>(load(a), load(b)));
+    }
+}
+
+template <lane_integral T>
+std::size_t find_not(const T* p, std::size_t n, T v) {
+    constexpr std::size_t L = 32 / sizeof(T);
+    const __m256i needle = broadcast(v);
+    std::size_t i = 0;
+    for (; i + L <= n; i += L) {
+        if (std::uint32_t m = ~movemask(cmpeq<T>(load(p + i), needle))) {
+            return i + std::countr_zero(m) / sizeof(T);
+        }
+    }
+    return i + scalar::find_not(p + i, n - i, v);
+}
+
+// compara 64 bytes por iteração (dois vetores de 32 bytes).
+template <lane_arithmetic T>
+std::size_t mismatch(const T* a, const T* b, std::size_t n) {
+    constexpr std::size_t L = 32 / sizeof(T);
+    std::size_t i = 0;
+    for (; i + 2 * L <= n; i += 2 * L) {
+        std::uint32_t m0 = ~eq_mask(a + i, b + i);
+        std::uint32_t m1 = ~eq_mask(a + i + L, b + i + L);
+        if (m0 | m1) {
+            if (m0) return i + std::countr_zero(m0) / sizeof(T);
+            return i + L + std::countr_zero(m1) / sizeof(T);
+        }
+    }
+    for (; i + L <= n; i += L) {
+        if (std::uint32_t m = ~eq_mask(a + i, b + i)) {
+            return i + std::countr_zero(m) / sizeof(T);
+        }
+    }
+    return i + scalar::mismatch(a + i, b + i, n - i);
+}
+
+// 'adjacent_find' é o 'mismatch' negado entre 'p' e 'p + 1'.
+template <lane_arithmetic T>
+std::size_t adjacent_find(const T* p, std::size_t n) {
+    constexpr std::size_t L = 32 / sizeof(T);
+    std::size_t i = 0;
+    for (; i + L + 1 <= n; i += L) {
+        if (std::uint32_t m = eq_mask(p + i, p + i + 1)) {
+            return i + std::countr_zero(m) / sizeof(T);
+        }
+    }
+    for (; i + 1 < n; ++i) {
+        if (p[i] == p[i + 1]) return i;
+    }
+    return n;
+}
+}  // namespace avx2
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512bw,avx512vl,bmi,bmi2,popcnt")
+namespace avx512 {
+template <lane_integral T>
+inline __m512i broadcast(T v) {
+    if constexpr (sizeof(T) == 1) return _mm512_set1_epi8(static_cast<char>(v));
+    if constexpr (sizeof(T) == 2)
+        return _mm512_set1_epi16(static_cast<short>(v));
+    if constexpr (sizeof(T) == 4) return _mm512_set1_epi32(static_cast<int>(v));
+    if constexpr (sizeof(T) == 8)
+        return _mm512_set1_epi64(static_cast<long long>(v));
+}
+
+// máscara com um bit por elemento.
+template <lane_integral T>
+inline std::uint64_t cmpeq(__m512i a, __m512i b) {
+    if constexpr (sizeof(T) == 1) return _mm512_cmpeq_epi8_mask(a, b);
+    if constexpr (sizeof(T) == 2) return _mm512_cmpeq_epi16_mask(a, b);
+    if constexpr (sizeof(T) == 4) return _mm512_cmpeq_epi32_mask(a, b);
+    if constexpr (sizeof(T) == 8) return _mm512_cmpeq_epi64_mask(a, b);
+}
+
+// leitura parcial (cauda) sem ultrapassar o fim do buffer.
+template <lane_integral T>
+inline __m512i load_n(const T* p, std::size_t k) {
+    if constexpr (sizeof(T) == 1)
+        return _mm512_maskz_loadu_epi8(_bzhi_u64(~0ull, k), p);
+    if constexpr (sizeof(T) == 2)
+        return _mm512_maskz_loadu_epi16(_bzhi_u32(~0u, k), p);
+    if constexpr (sizeof(T) == 4)
+        return _mm512_maskz_loadu_epi32(_bzhi_u32(~0u, k), p);
+    if constexpr (sizeof(T) == 8)
+        return _mm512_maskz_loadu_epi64(_bzhi_u32(~0u, k), p);
+}
+
+inline std::uint64_t tail_mask(std::size_t k) { return _bzhi_u64(~0ull, k); }
+
+template <lane_integral T>
+std::size_t find(const T* p, std::size_t n, T v) {
+    constexpr std::size_t L = 64 / sizeof(T);
+    const __m512i needle = broadcast(v);
+    std::size_t i = 0;
+    for (; i + L <= n; i += L) {
+        if (std::uint64_t m = cmpeq<T>(_mm512_loadu_si512(p + i), needle)) {
+            return i + std::countr_zero(m);
+        }
+    }
+    if (i < n) {
+        std::uint64_t m = cmpeq<T>(load_n(p + i, n - i), needle) &
+                          tail_mask(n - i);
+        if (m) return i + std::countr_zero(m);
+    }
+    return n;
+}
+
+template <lane_integral T>
+std::size_t count(const T* p, std::size_t n, T v) {
+    constexpr std::size_t L = 64 / sizeof(T);
+    const __m512i needle = broadcast(v);
+    std::size_t c = 0;
+    std::size_t i = 0;
+    for (; i + L <= n; i += L) {
+        c += std::popcount(cmpeq<T>(_mm512_loadu_si512(p + i), needle));
+    }
+    if (i < n) {
+        c += std::popcount(cmpeq<T>(load_n(p + i, n - i), needle) &
+                           tail_mask(n - i));
+    }
+    return c;
+}
+
+template <lane_integral T>
+std::size_t find_first_of(const T* p, std::size_t n, const T* set,
+                          std::size_t m) {
+    constexpr std::size_t L = 64 / sizeof(T);
+    __m512i needles[16];
+    for (std::size_t j = 0; j < m; ++j) needles[j] = broadcast(set[j]);
+    for (std::size_t i = 0; i < n; i += L) {
+        const std::size_t k = std::min(L, n - i);
+        const __m512i x = load_n(p + i, k);
+        std::uint64_t hit = 0;
+        for (std::size_t j = 0; j < m; ++j) hit |= cmpeq<T>(x, needles[j]);
+        if (hit &= tail_mask(k)) return i + std::countr_zero(hit);
+    }
+    return n;
+}
+template <lane_arithmetic T>
+inline std::uint64_t eq_mask_n(const T* a, const T* b, std::size_t k) {
+    if constexpr (std::same_as<T, float>) {
+        const __mmask16 t = _bzhi_u32(~0u, k);
+        return _mm512_mask_cmp_ps_mask(t, _mm512_maskz_loadu_ps(t, a),
+                                       _mm512_maskz_loadu_ps(t, b),
+                                       _CMP_EQ_OQ);
+    } else if constexpr (std::same_as<T, double>) {
+        const __mmask8 t = _bzhi_u32(~0u, k);
+        return _mm512_mask_cmp_pd_mask(t, _mm512_maskz_loadu_pd(t, a),
+                                       _mm512_maskz_loadu_pd(t, b),
+                                       _CMP_EQ_OQ);
+    } else {
+        return cmpeq<T>(load_n(a, k), load_n(b, k)) & tail_mask(k);
+    }
+}
+
+template <lane_integral T>
+std::size_t find_not(const T* p, std::size_t n, T v) {
+    constexpr std::size_t L = 64 / sizeof(T);
+    const __m512i needle = broadcast(v);
+    for (std::size_t i = 0; i < n; i += L) {
+        const std::size_t k = std::min(L, n - i);
+        std::uint64_t m = ~cmpeq<T>(load_n(p + i, k), needle) & tail_mask(k);
+        if (m) return i + std::countr_zero(m);
+    }
+    return n;
+}
+
+template <lane_arithmetic T>
+std::size_t mismatch(const T* a, const T* b, std::size_t n) {
+    constexpr std::size_t L = 64 / sizeof(T);
+    for (std::size_t i = 0; i < n; i += L) {
+        const std::size_t k = std::min(L, n - i);
+        if (std::uint64_t m = ~eq_mask_n(a + i, b + i, k) & tail_mask(k)) {
+            return i + std::countr_zero(m);
+        }
+    }
+    return n;
+}
+
+template <lane_arithmetic T>
+std::size_t adjacent_find(const T* p, std::size_t n) {
+    if (n < 2) return n;
+    constexpr std::size_t L = 64 / sizeof(T);
+    for (std::size_t i = 0; i + 1 < n; i += L) {
+        const std::size_t k = std::min(L, n - 1 - i);
+        if (std::uint64_t m = eq_mask_n(p + i, p + i + 1, k)) {
+            return i + std::countr_zero(m);
+        }
+    }
+    return n;
+}
+}  // namespace avx512
+#pragma GCC pop_options
+#endif
+
+// acesso de baixo nível: índice do primeiro 'v' em [p, p+n), ou 'n'.
+template <lane_integral T>
+std::size_t find_index(const T* p, std::size_t n, T v) {
+#if SIMD_X86
+    switch (active_isa()) {
+        case isa::avx512: return avx512::find(p, n, v);
+        case isa::avx2: return avx2::find(p, n, v);
+        case isa::scalar: break;
+    }
+#endif
+    return scalar::find(p, n, v);
+}
+
+template <lane_integral T>
+std::size_t count_value(const T* p, std::size_t n, T v) {
+#if SIMD_X86
+    switch (active_isa()) {
+        case isa::avx512: return avx512::count(p, n, v);
+        case isa::avx2: return avx2::count(p, n, v);
+        case isa::scalar: break;
+    }
+#endif
+    return scalar::count(p, n, v);
+}
+
+// índice do primeiro elemento diferente de 'v', ou 'n'.
+template <lane_integral T>
+std::size_t find_not_index(const T* p, std::size_t n, T v) {
+#if SIMD_X86
+    switch (active_isa()) {
+        case isa::avx512: return avx512::find_not(p, n, v);
+        case isa::avx2: return avx2::find_not(p, n, v);
+        case isa::scalar: break;
+    }
+#endif
+    return scalar::find_not(p, n, v);
+}
+
+template <lane_arithmetic T>
+std::size_t mismatch_index(const T* a, const T* b, std::size_t n) {
+#if SIMD_X86
+    switch (active_isa()) {
+        case isa::avx512: return avx512::mismatch(a, b, n);
+        case isa::avx2: return avx2::mismatch(a, b, n);
+        case isa::scalar: break;
+    }
+#endif
+    return scalar::mismatch(a, b, n);
+}
+
+template <lane_arithmetic T>
+std::size_t adjacent_find_index(const T* p, std::size_t n) {
+#if SIMD_X86
+    switch (active_isa()) {
+        case isa::avx512: return avx512::adjacent_find(p, n);
+        case isa::avx2: return avx2::adjacent_find(p, n);
+        case isa::scalar: break;
+    }
+#endif
+    for (std::size_t i = 0; i + 1 < n; ++i) {
+        if (p[i] == p[i + 1]) return i;
+    }
+    return n;
+}
+
+// 'search_n' com salto: se 'p[s + count - 1] != v', nenhuma sequência que
+// comece em [s, s + count) é válida e a busca avança 'count' posições de uma
+// vez. Caso contrário, a extensão da sequência é medida para trás
+// (escalar, no máximo 'count' passos) e para frente (vetorizado).
+template <lane_integral T>
+std::size_t search_n_index(const T* p, std::size_t n, std::size_t count, T v) {
+    if (count == 0) return 0;
+    std::size_t s = 0;
+    while (s + count <= n) {
+        const std::size_t j = s + count - 1;
+        if (p[j] != v) {
+            s = j + 1;
+            continue;
+        }
+        std::size_t b = j;
+        while (b > s && p[b - 1] == v) --b;
+        const std::size_t need = b + count;
+        if (need > n) break;
+        const std::size_t e =
+            j + 1 + find_not_index(p + j + 1, need - j - 1, v);
+        if (e == need) return b;
+        s = e + 1;
+    }
+    return n;
+}
+
+// conjunto pequeno de agulhas (até 16) é testado por comparação de cada
+// agulha em paralelo; para bytes, conjuntos maiores usam um bitmap de 256
+// bits (um teste de bit por elemento, sem desvios).
+inline constexpr std::size_t max_simd_needles = 16;
+
+template <lane_integral T>
+std::size_t find_first_of_index(const T* p, std::size_t n, const T* set,
+                                std::size_t m) {
+    if (m == 0) return n;
+    if (m <= max_simd_needles) {
+#if SIMD_X86
+        switch (active_isa()) {
+            case isa::avx512: return avx512::find_first_of(p, n, set, m);
+            case isa::avx2: return avx2::find_first_of(p, n, set, m);
+            case isa::scalar: break;
+        }
+#endif
+        return scalar::find_first_of(p, n, set, m);
+    }
+    if constexpr (sizeof(T) == 1) {
+        std::array<std::uint64_t, 4> bitmap{};
+        for (std::size_t j = 0; j < m; ++j) {
+            auto b = static_cast<std::uint8_t>(set[j]);
+            bitmap[b >> 6] |= std::uint64_t{1} << (b & 63);
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            auto b = static_cast<std::uint8_t>(p[i]);
+            if (bitmap[b >> 6] >> (b & 63) & 1) return i;
+        }
+        return n;
+    } else {
+        std::vector<T> sorted(set, set + m);
+        std::ranges::sort(sorted);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (std::ranges::binary_search(sorted, p[i])) return i;
+        }
+        return n;
+    }
+}
+
+namespace detail {
+// 'elem == value' é avaliado no tipo comum 'C'; como a conversão de 'Elem'
+// para 'C' é injetiva, no máximo um valor de 'Elem' compara igual a 'value'.
+// Retorna esse valor, se existir.
+template <typename Elem, typename T>
+constexpr std::optional<Elem> as_lane(const T& value) {
+    using C = std::common_type_t<Elem, T>;
+    const auto c = static_cast<C>(value);
+    const auto e = static_cast<Elem>(c);
+    if (static_cast<C>(e) != c) return std::nullopt;
+    return e;
+}
+
+template <typename R, typename T, typename Proj>
+concept fast_eq_path = integral_contiguous_range<R> &&
+                       std::same_as<Proj, std::identity> && std::integral<T> &&
+                       !std::same_as<T, bool>;
+}  // namespace detail
+
+struct find_fn {
+    template <std::ranges::input_range R, typename T,
+              typename Proj = std::identity>
+        requires std::indirect_binary_predicate<
+            std::ranges::equal_to,
+            std::projected<std::ranges::iterator_t<R>, Proj>, const T*>
+    constexpr std::ranges::borrowed_iterator_t<R> operator()(
+        R&& r, const T& value, Proj proj = {}) const {
+        if constexpr (detail::fast_eq_path<R, T, Proj>) {
+            if (!std::is_constant_evaluated()) {
+                using E = std::remove_cv_t<std::ranges::range_value_t<R>>;
+                const auto n = std::ranges::size(r);
+                auto lane = detail::as_lane<E>(value);
+                if (!lane) return std::ranges::begin(r) + n;
+                return std::ranges::begin(r) +
+                       find_index<E>(std::ranges::data(r), n, *lane);
+            }
+        }
+        return std::ranges::find(r, value, std::move(proj));
+    }
+};
+inline constexpr find_fn find{};
+
+struct count_fn {
+    template <std::ranges::input_range R, typename T,
+              typename Proj = std::identity>
+        requires std::indirect_binary_predicate<
+            std::ranges::equal_to,
+            std::projected<std::ranges::iterator_t<R>, Proj>, const T*>
+    constexpr std::ranges::range_difference_t<R> operator()(
+        R&& r, const T& value, Proj proj = {}) const {
+        if constexpr (detail::fast_eq_path<R, T, Proj>) {
+            if (!std::is_constant_evaluated()) {
+                using E = std::remove_cv_t<std::ranges::range_value_t<R>>;
+                auto lane = detail::as_lane<E>(value);
+                if (!lane) return 0;
+                return count_value<E>(std::ranges::data(r),
+                                      std::ranges::size(r), *lane);
+            }
+        }
+        return std::ranges::count(r, value, std::move(proj));
+    }
+};
+inline constexpr count_fn count{};
+
+struct find_first_of_fn {
+    template <std::ranges::input_range R1, std::ranges::forward_range R2,
+              typename Pred = std::ranges::equal_to,
+              typename Proj1 = std::identity, typename Proj2 = std::identity>
+        requires std::indirectly_comparable<std::ranges::iterator_t<R1>,
+                                            std::ranges::iterator_t<R2>, Pred,
+                                            Proj1, Proj2>
+    constexpr std::ranges::borrowed_iterator_t<R1> operator()(
+        R1&& haystack, R2&& needles, Pred pred = {}, Proj1 proj1 = {},
+        Proj2 proj2 = {}) const {
+        using E1 = std::remove_cv_t<std::ranges::range_value_t<R1>>;
+        using E2 = std::remove_cv_t<std::ranges::range_value_t<R2>>;
+        if constexpr (integral_contiguous_range<R1> &&
+                      std::same_as<E1, E2> &&
+                      std::ranges::sized_range<R2> &&
+                      std::same_as<Pred, std::ranges::equal_to> &&
+                      std::same_as<Proj1, std::identity> &&
+                      std::same_as<Proj2, std::identity>) {
+            if (!std::is_constant_evaluated()) {
+                std::vector<E1> set(std::ranges::begin(needles),
+                                    std::ranges::end(needles));
+                return std::ranges::begin(haystack) +
+                       find_first_of_index<E1>(std::ranges::data(haystack),
+                                               std::ranges::size(haystack),
+                                               set.data(), set.size());
+            }
+        }
+        return std::ranges::find_first_of(haystack, needles, std::move(pred),
+                                          std::move(proj1), std::move(proj2));
+    }
+};
+inline constexpr find_first_of_fn find_first_of{};
+
+// 'count_if' sem desvios: o predicado é avaliado em blocos de 64 elementos,
+// cada resultado vira um bit de uma máscara e a contagem é feita por
+// 'popcount', o que evita os erros de previsão de um contador condicional
+// quando o predicado é imprevisível. É escalar: um predicado qualquer não tem
+// kernel próprio, e o bloco interno só é vetorizado pelo compilador com
+// otimização ('-O2' ou mais), e apenas para predicados simples.
+struct count_if_fn {
+    template <std::ranges::input_range R, typename Proj = std::identity,
+              std::indirect_unary_predicate<
+                  std::projected<std::ranges::iterator_t<R>, Proj>>
+                  Pred>
+    constexpr std::ranges::range_difference_t<R> operator()(
+        R&& r, Pred pred, Proj proj = {}) const {
+        if constexpr (std::ranges::contiguous_range<R> &&
+                      std::ranges::sized_range<R>) {
+            const auto* p = std::ranges::data(r);
+            const std::size_t n = std::ranges::size(r);
+            std::ranges::range_difference_t<R> c = 0;
+            std::size_t i = 0;
+            for (; i + 64 <= n; i += 64) {
+                std::uint64_t mask = 0;
+                for (std::size_t j = 0; j < 64; ++j) {
+                    mask |= std::uint64_t{static_cast<bool>(
+                                std::invoke(pred, std::invoke(proj, p[i + j])))}
+                            << j;
+                }
+                c += std::popcount(mask);
+            }
+            for (; i < n; ++i) {
+                c += static_cast<bool>(
+                    std::invoke(pred, std::invoke(proj, p[i])));
+            }
+            return c;
+        } else {
+            return std::ranges::count_if(r, std::move(pred), std::move(proj));
+        }
+    }
+};
+inline constexpr count_if_fn count_if{};
+
+struct adjacent_find_fn {
+    template <std::ranges::forward_range R, typename Proj = std::identity,
+              std::indirect_binary_predicate<
+                  std::projected<std::ranges::iterator_t<R>, Proj>,
+                  std::projected<std::ranges::iterator_t<R>, Proj>>
+                  Pred = std::ranges::equal_to>
+    constexpr std::ranges::borrowed_iterator_t<R> operator()(
+        R&& r, Pred pred = {}, Proj proj = {}) const {
+        if constexpr (arithmetic_contiguous_range<R> &&
+                      std::same_as<Pred, std::ranges::equal_to> &&
+                      std::same_as<Proj, std::identity>) {
+            if (!std::is_constant_evaluated()) {
+                return std::ranges::begin(r) +
+                       adjacent_find_index(std::ranges::data(r),
+                                           std::ranges::size(r));
+            }
+        }
+        return std::ranges::adjacent_find(r, std::move(pred), std::move(proj));
+    }
+};
+inline constexpr adjacent_find_fn adjacent_find{};
+
+struct search_n_fn {
+    template <std::ranges::forward_range R, typename T,
+              typename Pred = std::ranges::equal_to,
+              typename Proj = std::identity>
+        requires std::indirectly_comparable<std::ranges::iterator_t<R>,
+                                            const T*, Pred, Proj>
+    constexpr std::ranges::borrowed_subrange_t<R> operator()(
+        R&& r, std::ranges::range_difference_t<R> count, const T& value,
+        Pred pred = {}, Proj proj = {}) const {
+        if constexpr (detail::fast_eq_path<R, T, Proj> &&
+                      std::same_as<Pred, std::ranges::equal_to>) {
+            if (!std::is_constant_evaluated()) {
+                using E = std::remove_cv_t<std::ranges::range_value_t<R>>;
+                auto first = std::ranges::begin(r);
+                const auto n = std::ranges::size(r);
+                if (count <= 0) return {first, first};
+                auto lane = detail::as_lane<E>(value);
+                const std::size_t i =
+                    lane ? search_n_index<E>(std::ranges::data(r), n,
+                                             static_cast<std::size_t>(count),
+                                             *lane)
+                         : n;
+                if (i == n) return {first + n, first + n};
+                return {first + i, first + i + count};
+            }
+        }
+        return std::ranges::search_n(r, count, value, std::move(pred),
+                                     std::move(proj));
+    }
+};
+inline constexpr search_n_fn search_n{};
+
+struct mismatch_fn {
+    template <std::ranges::input_range R1, std::ranges::input_range R2,
+              typename Pred = std::ranges::equal_to,
+              typename Proj1 = std::identity, typename Proj2 = std::identity>
+        requires std::indirectly_comparable<std::ranges::iterator_t<R1>,
+                                            std::ranges::iterator_t<R2>, Pred,
+                                            Proj1, Proj2>
+    constexpr std::ranges::mismatch_result<
+        std::ranges::borrowed_iterator_t<R1>,
+        std::ranges::borrowed_iterator_t<R2>>
+    operator()(R1&& r1, R2&& r2, Pred pred = {}, Proj1 proj1 = {},
+               Proj2 proj2 = {}) const {
+        if constexpr (arithmetic_contiguous_range<R1> &&
+                      std::ranges::contiguous_range<R2> &&
+                      std::ranges::sized_range<R2> &&
+                      std::same_as<std::remove_cv_t<
+                                       std::ranges::range_value_t<R1>>,
+                                   std::remove_cv_t<
+                                       std::ranges::range_value_t<R2>>> &&
+                      std::same_as<Pred, std::ranges::equal_to> &&
+                      std::same_as<Proj1, std::identity> &&
+                      std::same_as<Proj2, std::identity>) {
+            if (!std::is_constant_evaluated()) {
+                const std::size_t n = std::min<std::size_t>(
+                    std::ranges::size(r1), std::ranges::size(r2));
+                const std::size_t i = mismatch_index(
+                    std::ranges::data(r1), std::ranges::data(r2), n);
+                return {std::ranges::begin(r1) + i, std::ranges::begin(r2) + i};
+            }
+        }
+        return std::ranges::mismatch(r1, r2, std::move(pred), std::move(proj1),
+                                     std::move(proj2));
+    }
+};
+inline constexpr mismatch_fn mismatch{};
+
+struct equal_fn {
+    template <std::ranges::input_range R1, std::ranges::input_range R2,
+              typename Pred = std::ranges::equal_to,
+              typename Proj1 = std::identity, typename Proj2 = std::identity>
+        requires std::indirectly_comparable<std::ranges::iterator_t<R1>,
+                                            std::ranges::iterator_t<R2>, Pred,
+                                            Proj1, Proj2>
+    constexpr bool operator()(R1&& r1, R2&& r2, Pred pred = {},
+                              Proj1 proj1 = {}, Proj2 proj2 = {}) const {
+        if constexpr (std::ranges::sized_range<R1> &&
+                      std::ranges::sized_range<R2>) {
+            if (std::ranges::size(r1) != std::ranges::size(r2)) return false;
+            auto [i1, i2] = mismatch(r1, r2, std::move(pred), std::move(proj1),
+                                     std::move(proj2));
+            return i1 == std::ranges::end(r1);
+        } else {
+            return std::ranges::equal(r1, r2, std::move(pred), std::move(proj1),
+                                      std::move(proj2));
+        }
+    }
+};
+inline constexpr equal_fn equal{};
+
+}  // namespace simd
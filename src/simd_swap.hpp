@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <execution>
+#include <iterator>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+// 'swap_ranges' para ranges contíguas de elementos trivialmente copiáveis:
+// trocar os elementos é trocar os bytes das duas ranges, um vetor inteiro de
+// cada lado por vez (com o resto num único par de load/store mascarado no
+// AVX-512), independentemente do tamanho do elemento.
+// Tipos com um 'swap' próprio encontrado por ADL (como 'Library::swap' em
+// 'swaps.cpp') nunca passam pelo caminho de bytes, mesmo que sejam
+// trivialmente copiáveis: nesse caso, e para as demais ranges, a troca é
+// feita por 'std::ranges::swap_ranges' (ou 'std::swap_ranges' com a política
+// de execução), que chamam esse 'swap'.
+namespace simd {
+
+#if SIMD_X86
+#pragma GCC push_options
+#pragma GCC target("avx2,bmi,popcnt")
+namespace avx2 {
+// troca os primeiros bytes de 'x' e 'y' em vetores de 32 bytes; devolve
+// quantos bytes foram trocados.
+inline std::size_t swap_bytes(std::byte* x, std::byte* y, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        auto* px = reinterpret_cast<__m256i*>(x + i);
+        auto* py = reinterpret_cast<__m256i*>(y + i);
+        const __m256i a0 = _mm256_loadu_si256(px);
+        const __m256i a1 = _mm256_loadu_si256(px + 1);
+        const __m256i b0 = _mm256_loadu_si256(py);
+        const __m256i b1 = _mm256_loadu_si256(py + 1);
+        _mm256_storeu_si256(px, b0);
+        _mm256_storeu_si256(px + 1, b1);
+        _mm256_storeu_si256(py, a0);
+        _mm256_storeu_si256(py + 1, a1);
+    }
+    for (; i + 32 <= n; i += 32) {
+        auto* px = reinterpret_cast<__m256i*>(x + i);
+        auto* py = reinterpret_cast<__m256i*>(y + i);
+        const __m256i a = _mm256_loadu_si256(px);
+        const __m256i b = _mm256_loadu_si256(py);
+        _mm256_storeu_si256(px, b);
+        _mm256_storeu_si256(py, a);
+    }
+    return i;
+}
+}  // namespace avx2
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512bw,avx512vl,bmi,bmi2,popcnt")
+namespace avx512 {
+inline std::size_t swap_bytes(std::byte* x, std::byte* y, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        const __m512i a = _mm512_loadu_si512(x + i);
+        const __m512i b = _mm512_loadu_si512(y + i);
+        _mm512_storeu_si512(x + i, b);
+        _mm512_storeu_si512(y + i, a);
+    }
+    if (i < n) {
+        const __mmask64 m = _bzhi_u64(~0ull, static_cast<unsigned>(n - i));
+        const __m512i a = _mm512_maskz_loadu_epi8(m, x + i);
+        const __m512i b = _mm512_maskz_loadu_epi8(m, y + i);
+        _mm512_mask_storeu_epi8(x + i, m, b);
+        _mm512_mask_storeu_epi8(y + i, m, a);
+    }
+    return n;
+}
+}  // namespace avx512
+#pragma GCC pop_options
+#endif
+
+namespace detail {
+
+namespace swap_lookup {
+// como em 'std::ranges::swap': com esta sobrecarga removida visível, a
+// chamada sem qualificação só é válida se a ADL achar um 'swap' do usuário.
+template <typename T>
+void swap(T&, T&) = delete;
+
+template <typename T>
+concept adl_swappable = requires(T& a, T& b) { swap(a, b); };
+}  // namespace swap_lookup
+
+// elementos que podem ser trocados byte a byte.
+template <typename T>
+concept byte_swappable = std::is_trivially_copyable_v<T> &&
+                         !std::is_const_v<T> &&
+                         !swap_lookup::adl_swappable<T>;
+
+// bytes mínimos por bloco ao dividir uma troca entre threads.
+inline constexpr std::size_t swap_grain = 1 << 16;
+
+// troca 'n' bytes de 'x' e 'y', que não se sobrepõem.
+inline void swap_bytes(std::byte* x, std::byte* y, std::size_t n) {
+    std::size_t i = 0;
+#if SIMD_X86
+    switch (active_isa()) {
+        case isa::avx512:
+            i = avx512::swap_bytes(x, y, n);
+            break;
+        case isa::avx2:
+            i = avx2::swap_bytes(x, y, n);
+            break;
+        case isa::scalar:
+            break;
+    }
+#endif
+    for (; i + 8 <= n; i += 8) {
+        std::uint64_t a, b;
+        std::memcpy(&a, x + i, 8);
+        std::memcpy(&b, y + i, 8);
+        std::memcpy(x + i, &b, 8);
+        std::memcpy(y + i, &a, 8);
+    }
+    for (; i < n; ++i) std::swap(x[i], y[i]);
+}
+
+template <typename R1, typename R2>
+concept byte_swappable_ranges =
+    std::ranges::contiguous_range<R1> && std::ranges::sized_range<R1> &&
+    std::ranges::contiguous_range<R2> && std::ranges::sized_range<R2> &&
+    std::same_as<std::ranges::range_value_t<R1>,
+                 std::ranges::range_value_t<R2>> &&
+    byte_swappable<
+        std::remove_reference_t<std::ranges::range_reference_t<R1>>> &&
+    byte_swappable<
+        std::remove_reference_t<std::ranges::range_reference_t<R2>>>;
+
+}  // namespace detail
+
+struct swap_ranges_fn {
+    template <std::ranges::input_range R1, std::ranges::input_range R2>
+        requires std::indirectly_swappable<std::ranges::iterator_t<R1>,
+                                           std::ranges::iterator_t<R2>>
+    std::ranges::swap_ranges_result<std::ranges::borrowed_iterator_t<R1>,
+                                    std::ranges::borrowed_iterator_t<R2>>
+    operator()(R1&& r1, R2&& r2) const {
+        return (*this)(std::execution::seq, std::forward<R1>(r1),
+                       std::forward<R2>(r2));
+    }
+
+    template <parallel::execution_policy P, std::ranges::input_range R1,
+              std::ranges::input_range R2>
+        requires std::indirectly_swappable<std::ranges::iterator_t<R1>,
+                                           std::ranges::iterator_t<R2>>
+    std::ranges::swap_ranges_result<std::ranges::borrowed_iterator_t<R1>,
+                                    std::ranges::borrowed_iterator_t<R2>>
+    operator()(P&& policy, R1&& r1, R2&& r2) const {
+        if constexpr (detail::byte_swappable_ranges<R1, R2>) {
+            using T = std::ranges::range_value_t<R1>;
+            const auto n = std::min<std::size_t>(std::ranges::size(r1),
+                                                 std::ranges::size(r2));
+            auto* x = reinterpret_cast<std::byte*>(std::ranges::data(r1));
+            auto* y = reinterpret_cast<std::byte*>(std::ranges::data(r2));
+            const std::size_t bytes = n * sizeof(T);
+            parallel::for_each_chunk(
+                policy, bytes,
+                parallel::chunk_count(policy, bytes, detail::swap_grain),
+                [&](std::size_t, std::size_t b, std::size_t e) {
+                    detail::swap_bytes(x + b, y + b, e - b);
+                });
+            return {std::ranges::begin(r1) + n, std::ranges::begin(r2) + n};
+        } else if constexpr (!parallel::is_sequenced<P>() &&
+                             std::ranges::random_access_range<R1> &&
+                             std::ranges::sized_range<R1> &&
+                             std::ranges::random_access_range<R2> &&
+                             std::ranges::sized_range<R2>) {
+            const auto n = std::min<std::ptrdiff_t>(
+                std::ranges::ssize(r1), std::ranges::ssize(r2));
+            auto f1 = std::ranges::begin(r1);
+            auto f2 = std::ranges::begin(r2);
+            std::swap_ranges(policy, f1, f1 + n, f2);
+            return {f1 + n, f2 + n};
+        } else {
+            return std::ranges::swap_ranges(r1, r2);
+        }
+    }
+};
+inline constexpr swap_ranges_fn swap_ranges{};
+
+}  // namespace simd
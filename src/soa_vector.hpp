@@ -0,0 +1,427 @@
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <execution>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "parallel.hpp"
+#include "permutation.hpp"
+
+// Vetor "struct-of-arrays": 'soa_vector<int, double, std::string>' guarda cada
+// campo numa coluna contígua própria, em vez de um vetor de tuplas. Varrer um
+// campo ('elements<I>()', um 'std::span') lê apenas os bytes daquela coluna,
+// sem os saltos de 'sizeof(registro)' de 'std::views::elements<I>' sobre um
+// vetor de structs.
+// O vetor também é uma range de acesso aleatório das linhas: a referência é
+// um proxy ('soa::ref<T&...>') que aponta para os elementos de cada coluna,
+// se compara como a tupla correspondente, e atribuído escreve nas colunas.
+// Com isso 'std::ranges::sort', 'partition', 'unique' e afins funcionam
+// diretamente sobre o vetor, trocando as linhas em todas as colunas.
+// 'soa::sort' ordena de forma estável por uma ordenação de índices seguida de
+// 'permutation::apply' em cada coluna, o que move cada elemento uma única vez
+// (os algoritmos da stl movem proxies por cópia das linhas).
+// Colunas 'bool' não são aceitas, já que 'std::vector<bool>' não guarda
+// 'bool's contíguos; 'unsigned char' serve no lugar.
+namespace soa {
+
+// referência para uma linha: 'Refs' são 'T&' (ou 'const T&') para o elemento
+// de cada coluna.
+template <typename... Refs>
+class ref {
+    static constexpr bool writable =
+        (!std::is_const_v<std::remove_reference_t<Refs>> && ...);
+
+   public:
+    using value_type = std::tuple<std::remove_cvref_t<Refs>...>;
+
+    explicit ref(Refs... refs) : refs_(refs...) {}
+    ref(const ref&) = default;
+
+    // a atribuição escreve nos elementos referenciados; a versão 'const' é a
+    // exigida por 'std::indirectly_writable' para proxies.
+    ref& operator=(const ref& other)
+        requires writable
+    {
+        assign(other.refs_);
+        return *this;
+    }
+    const ref& operator=(const ref& other) const
+        requires writable
+    {
+        assign(other.refs_);
+        return *this;
+    }
+    template <typename... Us>
+        requires writable && (sizeof...(Us) == sizeof...(Refs))
+    const ref& operator=(const std::tuple<Us...>& values) const {
+        assign(values);
+        return *this;
+    }
+    template <typename... Us>
+        requires writable && (sizeof...(Us) == sizeof...(Refs))
+    const ref& operator=(std::tuple<Us...>&& values) const {
+        assign(std::move(values));
+        return *this;
+    }
+
+    operator value_type() const { return value_type(refs_); }
+
+    const std::tuple<Refs...>& as_tuple() const { return refs_; }
+
+    template <std::size_t I>
+    friend decltype(auto) get(const ref& r) {
+        return std::get<I>(r.refs_);
+    }
+
+    friend void swap(const ref& a, const ref& b)
+        requires writable
+    {
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            (std::ranges::swap(std::get<I>(a.refs_), std::get<I>(b.refs_)),
+             ...);
+        }(std::index_sequence_for<Refs...>{});
+    }
+
+   private:
+    template <typename Tuple>
+    void assign(Tuple&& values) const {
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            ((std::get<I>(refs_) = std::get<I>(std::forward<Tuple>(values))),
+             ...);
+        }(std::index_sequence_for<Refs...>{});
+    }
+
+    std::tuple<Refs...> refs_;
+};
+
+template <typename... As, typename... Bs>
+bool operator==(const ref<As...>& a, const ref<Bs...>& b) {
+    return a.as_tuple() == b.as_tuple();
+}
+template <typename... As, typename... Us>
+bool operator==(const ref<As...>& a, const std::tuple<Us...>& b) {
+    return a.as_tuple() == b;
+}
+template <typename... As, typename... Bs>
+auto operator<=>(const ref<As...>& a, const ref<Bs...>& b) {
+    return a.as_tuple() <=> b.as_tuple();
+}
+template <typename... As, typename... Us>
+auto operator<=>(const ref<As...>& a, const std::tuple<Us...>& b) {
+    return a.as_tuple() <=> b;
+}
+
+template <typename... Ts>
+    requires(sizeof...(Ts) > 0)
+class soa_vector {
+    static_assert(!(std::same_as<std::remove_cv_t<Ts>, bool> || ...),
+                  "soa_vector: colunas 'bool' não são suportadas "
+                  "('std::vector<bool>' não tem 'data()' nem referências "
+                  "'bool&'); use 'unsigned char'");
+
+    template <bool Const>
+    class basic_iterator;
+
+   public:
+    using value_type = std::tuple<Ts...>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = ref<Ts&...>;
+    using const_reference = ref<const Ts&...>;
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    soa_vector() = default;
+
+    soa_vector(std::initializer_list<value_type> init) {
+        reserve(init.size());
+        for (const auto& v : init) push_back(v);
+    }
+
+    template <std::input_iterator It, std::sentinel_for<It> S>
+    soa_vector(It first, S last) {
+        insert_range(std::ranges::subrange(std::move(first), std::move(last)));
+    }
+
+#if defined(__cpp_lib_containers_ranges)
+    template <std::ranges::input_range R>
+    soa_vector(std::from_range_t, R&& r) {
+        insert_range(std::forward<R>(r));
+    }
+#endif
+
+    iterator begin() { return {this, 0}; }
+    iterator end() { return {this, size()}; }
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const { return {this, size()}; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    // coluna 'I', contígua.
+    template <std::size_t I>
+    std::span<std::tuple_element_t<I, value_type>> elements() {
+        return std::get<I>(columns_);
+    }
+    template <std::size_t I>
+    std::span<const std::tuple_element_t<I, value_type>> elements() const {
+        return std::get<I>(columns_);
+    }
+
+    size_type size() const { return std::get<0>(columns_).size(); }
+    bool empty() const { return size() == 0; }
+    size_type capacity() const {
+        return std::apply(
+            [](const auto&... c) { return std::min({c.capacity()...}); },
+            columns_);
+    }
+
+    void reserve(size_type n) {
+        std::apply([n](auto&... c) { (c.reserve(n), ...); }, columns_);
+    }
+    void resize(size_type n) {
+        std::apply([n](auto&... c) { (c.resize(n), ...); }, columns_);
+    }
+    void clear() {
+        std::apply([](auto&... c) { (c.clear(), ...); }, columns_);
+    }
+
+    reference operator[](size_type i) { return row(*this, i); }
+    const_reference operator[](size_type i) const { return row(*this, i); }
+    reference front() { return (*this)[0]; }
+    const_reference front() const { return (*this)[0]; }
+    reference back() { return (*this)[size() - 1]; }
+    const_reference back() const { return (*this)[size() - 1]; }
+
+    // um argumento por coluna. Se a construção de um elemento lança exceção,
+    // as colunas já estendidas são desfeitas e o vetor fica como antes.
+    template <typename... Args>
+        requires(sizeof...(Args) == sizeof...(Ts)) &&
+                (std::constructible_from<Ts, Args&&> && ...)
+    reference emplace_back(Args&&... args) {
+        if (size() == capacity()) reserve(std::max<size_type>(8, 2 * size()));
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            std::size_t done = 0;
+            try {
+                ((std::get<I>(columns_).emplace_back(std::forward<Args>(args)),
+                  ++done),
+                 ...);
+            } catch (...) {
+                ((I < done ? std::get<I>(columns_).pop_back() : void()), ...);
+                throw;
+            }
+        }(std::index_sequence_for<Ts...>{});
+        return back();
+    }
+
+    void push_back(const value_type& v) {
+        std::apply([this](const auto&... x) { emplace_back(x...); }, v);
+    }
+    void push_back(value_type&& v) {
+        std::apply([this](auto&... x) { emplace_back(std::move(x)...); }, v);
+    }
+    void pop_back() {
+        std::apply([](auto&... c) { (c.pop_back(), ...); }, columns_);
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        const auto b = static_cast<difference_type>(first.i_);
+        const auto e = static_cast<difference_type>(last.i_);
+        std::apply(
+            [&](auto&... c) { (c.erase(c.begin() + b, c.begin() + e), ...); },
+            columns_);
+        return {this, first.i_};
+    }
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+    template <std::ranges::input_range R>
+    void insert_range(R&& r) {
+        if constexpr (std::ranges::sized_range<R>) {
+            reserve(size() + std::ranges::size(r));
+        }
+        for (auto&& row : r) push_back(value_type(row));
+    }
+
+   private:
+    template <typename Self>
+    static auto row(Self& self, size_type i) {
+        return std::apply(
+            [i](auto&... c) {
+                using R = std::conditional_t<std::is_const_v<Self>,
+                                             const_reference, reference>;
+                return R(c[i]...);
+            },
+            self.columns_);
+    }
+
+    std::tuple<std::vector<Ts>...> columns_;
+};
+
+template <typename... Ts>
+    requires(sizeof...(Ts) > 0)
+template <bool Const>
+class soa_vector<Ts...>::basic_iterator {
+    using owner = std::conditional_t<Const, const soa_vector, soa_vector>;
+
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using iterator_concept = std::random_access_iterator_tag;
+    using value_type = std::tuple<Ts...>;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::conditional_t<Const, const_reference, ref<Ts&...>>;
+
+    basic_iterator() = default;
+    basic_iterator(owner* v, std::size_t i) : vec_(v), i_(i) {}
+    operator basic_iterator<true>() const
+        requires(!Const)
+    {
+        return {vec_, i_};
+    }
+
+    reference operator*() const { return (*vec_)[i_]; }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    // move os elementos da linha para uma tupla (cópia, se 'Const').
+    friend value_type iter_move(const basic_iterator& it) {
+        return it.move_row();
+    }
+    friend void iter_swap(const basic_iterator& a, const basic_iterator& b)
+        requires(!Const)
+    {
+        swap(*a, *b);
+    }
+
+    basic_iterator& operator++() {
+        ++i_;
+        return *this;
+    }
+    basic_iterator operator++(int) {
+        auto tmp = *this;
+        ++i_;
+        return tmp;
+    }
+    basic_iterator& operator--() {
+        --i_;
+        return *this;
+    }
+    basic_iterator operator--(int) {
+        auto tmp = *this;
+        --i_;
+        return tmp;
+    }
+    basic_iterator& operator+=(difference_type n) {
+        i_ += n;
+        return *this;
+    }
+    basic_iterator& operator-=(difference_type n) {
+        i_ -= n;
+        return *this;
+    }
+    friend basic_iterator operator+(basic_iterator it, difference_type n) {
+        return it += n;
+    }
+    friend basic_iterator operator+(difference_type n, basic_iterator it) {
+        return it += n;
+    }
+    friend basic_iterator operator-(basic_iterator it, difference_type n) {
+        return it -= n;
+    }
+    friend difference_type operator-(const basic_iterator& a,
+                                     const basic_iterator& b) {
+        return static_cast<difference_type>(a.i_) -
+               static_cast<difference_type>(b.i_);
+    }
+    friend bool operator==(const basic_iterator& a, const basic_iterator& b) {
+        return a.i_ == b.i_;
+    }
+    friend auto operator<=>(const basic_iterator& a, const basic_iterator& b) {
+        return a.i_ <=> b.i_;
+    }
+
+   private:
+    friend class soa_vector;
+
+    value_type move_row() const {
+        return std::apply(
+            [&](auto&... c) { return value_type(std::move(c[i_])...); },
+            vec_->columns_);
+    }
+
+    owner* vec_ = nullptr;
+    std::size_t i_ = 0;
+};
+
+// ordenação estável das linhas: ordena índices pela linha (projetada) e
+// aplica a permutação resultante a cada coluna.
+struct sort_fn {
+    template <parallel::execution_policy P, typename... Ts,
+              typename Comp = std::ranges::less, typename Proj = std::identity>
+        requires std::indirect_strict_weak_order<
+            Comp, std::projected<typename soa_vector<Ts...>::iterator, Proj>>
+    void operator()(P&& policy, soa_vector<Ts...>& v, Comp comp = {},
+                    Proj proj = {}) const {
+        std::vector<std::size_t> order(v.size());
+        std::iota(order.begin(), order.end(), std::size_t{0});
+        std::stable_sort(policy, order.begin(), order.end(),
+                         [&](std::size_t a, std::size_t b) {
+                             return std::invoke(comp, std::invoke(proj, v[a]),
+                                                std::invoke(proj, v[b]));
+                         });
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            permutation::apply(policy, order, v.template elements<I>()...);
+        }(std::index_sequence_for<Ts...>{});
+    }
+
+    template <typename... Ts, typename Comp = std::ranges::less,
+              typename Proj = std::identity>
+        requires std::indirect_strict_weak_order<
+            Comp, std::projected<typename soa_vector<Ts...>::iterator, Proj>>
+    void operator()(soa_vector<Ts...>& v, Comp comp = {},
+                    Proj proj = {}) const {
+        (*this)(std::execution::seq, v, std::move(comp), std::move(proj));
+    }
+};
+
+inline constexpr sort_fn sort{};
+
+}  // namespace soa
+
+// 'soa::ref' é "tuple-like" (permite 'auto [a, b] = v[i]'), e a referência
+// comum entre ela e a tupla de valores é a própria tupla, como exigido de
+// iteradores com referências proxy.
+template <typename... Refs>
+struct std::tuple_size<soa::ref<Refs...>>
+    : std::integral_constant<std::size_t, sizeof...(Refs)> {};
+
+template <std::size_t I, typename... Refs>
+struct std::tuple_element<I, soa::ref<Refs...>>
+    : std::tuple_element<I, std::tuple<Refs...>> {};
+
+template <typename... Refs, typename... Ts, template <typename> class RQ,
+          template <typename> class TQ>
+    requires std::same_as<std::tuple<std::remove_cvref_t<Refs>...>,
+                          std::tuple<Ts...>>
+struct std::basic_common_reference<soa::ref<Refs...>, std::tuple<Ts...>, RQ,
+                                   TQ> {
+    using type = std::tuple<Ts...>;
+};
+
+template <typename... Ts, typename... Refs, template <typename> class TQ,
+          template <typename> class RQ>
+    requires std::same_as<std::tuple<std::remove_cvref_t<Refs>...>,
+                          std::tuple<Ts...>>
+struct std::basic_common_reference<std::tuple<Ts...>, soa::ref<Refs...>, TQ,
+                                   RQ> {
+    using type = std::tuple<Ts...>;
+};
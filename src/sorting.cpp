@@ -1,7 +1,9 @@
 #include <algorithm>
+#include <bit>
 #include <boost/type_index.hpp>
 #include <concepts>
 #include <execution>
+#include <functional>
 #include <iostream>
 #include <list>
 #include <print>
@@ -10,6 +12,8 @@
 #include <typeinfo>
 #include <vector>
 
+#include "lazy_sort.hpp"
+
 namespace sorting {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -44,6 +48,30 @@ struct Record {
     int rank;
 };
 
+// adversário de McIlroy ("A killer adversary for quicksort"): decide o
+// resultado das comparações durante a ordenação, fixando os valores de modo
+// que os pivôs escolhidos sejam sempre os piores.
+struct Adversary {
+    vector<int> val;
+    int gas;
+    int solid = 0;
+    int candidate = 0;
+    long comparisons = 0;
+    explicit Adversary(int n) : val(n, n), gas(n) {}
+    bool operator()(int x, int y) {
+        ++comparisons;
+        if (val[x] == gas && val[y] == gas) {
+            val[x == candidate ? x : y] = solid++;
+        }
+        if (val[x] == gas) {
+            candidate = x;
+        } else if (val[y] == gas) {
+            candidate = y;
+        }
+        return val[x] < val[y];
+    }
+};
+
 void main() {
     cout << endl;
     cout << "std::sort(v.begin(), v.end()):" << endl;
@@ -173,5 +201,57 @@ void main() {
                                       v12.end(), std::greater<>{});
     cout << "partially sorted copy on 'w': " << stringify(v12) << endl;
     cout << "value of the resulting iterator: " << *it2 << endl;
+
+    cout << endl;
+    cout << "lazy_sort::sorted(v) (page by page):" << endl;
+    vector<int> v13 = views::iota(1, 20) | std::ranges::to<vector<int>>();
+    std::ranges::shuffle(v13, std::random_device{});
+    cout << "unsorted 'v': " << stringify(v13) << endl;
+    auto pages = lazy_sort::sorted(v13);
+    cout << "page 0: " << stringify(pages.page(0, 4)) << endl;
+    cout << "page 1: " << stringify(pages.page(4, 4)) << endl;
+    cout << "'v' after two pages: " << stringify(v13) << endl;
+    cout << "next 3 via iterator:";
+    for (int i : pages | views::drop(8) | views::take(3)) cout << ' ' << i;
+    cout << endl;
+
+    // o recurso ao 'sort' limita as comparações a O(n log n) também para
+    // entradas ordenadas e para o adversário de McIlroy, seja a ordenação
+    // pedida de uma vez, elemento a elemento ou em páginas.
+    const int n = 1 << 16;
+    const long bound = 8L * n * std::bit_width(unsigned(n));
+    vector<int> v14 = views::iota(0, n) | std::ranges::to<vector<int>>();
+    long comparisons = 0;
+    lazy_sort::sorted(v14, [&](int a, int b) {
+        ++comparisons;
+        return a < b;
+    }).sort_until(n);
+    cout << "lazy_sort comparisons, sorted input of " << n << ": "
+         << comparisons << " (<= " << bound << ": " << (comparisons <= bound)
+         << ")" << endl;
+    Adversary adversary(n);
+    vector<int> v15 = views::iota(0, n) | std::ranges::to<vector<int>>();
+    lazy_sort::sorted(v15, std::ref(adversary)).sort_until(n);
+    cout << "lazy_sort comparisons, McIlroy's adversary: "
+         << adversary.comparisons << " (<= " << bound << ": "
+         << (adversary.comparisons <= bound) << ")" << endl;
+    Adversary adversary2(n);
+    vector<int> v16 = views::iota(0, n) | std::ranges::to<vector<int>>();
+    long consumed = 0;
+    for (int i : lazy_sort::sorted(v16, std::ref(adversary2))) {
+        consumed += i >= 0;
+    }
+    cout << "lazy_sort comparisons, McIlroy's adversary, " << consumed
+         << " elements one by one: " << adversary2.comparisons << " (<= "
+         << bound << ": " << (adversary2.comparisons <= bound) << ")" << endl;
+    Adversary adversary3(n);
+    vector<int> v17 = views::iota(0, n) | std::ranges::to<vector<int>>();
+    auto paged = lazy_sort::sorted(v17, std::ref(adversary3));
+    for (std::size_t offset = 0; offset < paged.size(); offset += 100) {
+        paged.page(offset, 100);
+    }
+    cout << "lazy_sort comparisons, McIlroy's adversary, pages of 100: "
+         << adversary3.comparisons << " (<= " << bound << ": "
+         << (adversary3.comparisons <= bound) << ")" << endl;
 };
 }  // namespace sorting
@@ -0,0 +1,550 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ranges>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Pipelines em estágios, cada um em suas próprias threads, ligados por filas
+// limitadas de lotes de elementos: a leitura da origem, cada estágio e a
+// escrita do resultado rodam ao mesmo tempo, e uma fila cheia bloqueia o
+// estágio anterior (contrapressão). Além disso, a leitura não passa de uma
+// janela de lotes à frente do último escrito ('capacity' por fila mais um
+// por thread de estágio), o que limita a memória a essa janela, incluindo os
+// lotes que esperam para ser reordenados. Serve para pipelines de ingestão
+// em que ler, interpretar e agregar são caros, cada um à sua maneira:
+//
+//     staged::pipeline p{staged::stage{std::views::filter(valid)},
+//                        staged::stage{std::views::transform(parse), 3}};
+//     std::vector out = std::views::istream<Row>(in) | p;
+//
+// - A origem (qualquer range de entrada, inclusive 'std::views::istream') é
+//   lida numa thread própria, em lotes de 'options::batch' elementos.
+// - Cada 'stage' aplica o seu adaptador (ou função que receba e devolva uma
+//   range) a cada lote, com 'workers' threads. Como em 'chunk_par', só
+//   adaptadores que tratam cada elemento independentemente ('transform',
+//   'filter', 'join'...) dão o resultado da pipeline sobre a origem inteira.
+// - O resultado é escrito na thread que chamou, na ordem da origem: os lotes
+//   são numerados e reordenados no fim, então estágios com várias threads
+//   também preservam a ordem.
+// Uma exceção em qualquer ponto interrompe a leitura da origem; os estágios
+// esvaziam as suas filas sem processar os lotes restantes, e a primeira
+// exceção é relançada na thread que chamou, depois de todas as threads
+// terminarem.
+//
+// As filas entre os estágios também podem ser usadas diretamente:
+// 'spsc_queue' (um produtor e um consumidor, um anel com dois índices) e
+// 'mpmc_queue' (vários de cada, com um número de sequência por posição). Ambas
+// são livres de locks em 'try_push'/'try_pop'; 'push'/'pop' bloqueiam com
+// 'std::atomic::wait' quando a fila está cheia/vazia, sem girar.
+namespace staged {
+
+namespace detail {
+
+inline constexpr std::size_t cache_line = 64;
+
+inline std::size_t ring_capacity(std::size_t n) {
+    return std::bit_ceil(std::max<std::size_t>(n, 2));
+}
+
+}  // namespace detail
+
+// fila limitada de um produtor e um consumidor; a capacidade é arredondada
+// para uma potência de 2.
+template <typename T>
+    requires std::default_initializable<T> && std::movable<T>
+class spsc_queue {
+   public:
+    explicit spsc_queue(std::size_t capacity)
+        : mask_(detail::ring_capacity(capacity) - 1),
+          slots_(std::make_unique<T[]>(mask_ + 1)) {}
+
+    std::size_t capacity() const noexcept { return mask_ + 1; }
+
+    // só o produtor chama; 'x' só é movido se couber.
+    bool try_push(T&& x) {
+        const std::size_t t = tail_.load(std::memory_order_relaxed);
+        if (t - head_cache_ == capacity()) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (t - head_cache_ == capacity()) return false;
+        }
+        slots_[t & mask_] = std::move(x);
+        tail_.store(t + 1, std::memory_order_release);
+        tail_.notify_one();
+        return true;
+    }
+    void push(T x) {
+        while (!try_push(std::move(x))) {
+            // espera o consumidor liberar uma posição.
+            const std::size_t h = head_.load(std::memory_order_acquire);
+            if (tail_.load(std::memory_order_relaxed) - h == capacity()) {
+                head_.wait(h, std::memory_order_acquire);
+            }
+        }
+    }
+
+    // só o consumidor chama.
+    bool try_pop(T& out) {
+        const std::size_t h = head_.load(std::memory_order_relaxed);
+        if (h == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (h == tail_cache_) return false;
+        }
+        out = std::move(slots_[h & mask_]);
+        head_.store(h + 1, std::memory_order_release);
+        head_.notify_one();
+        return true;
+    }
+    T pop() {
+        T out;
+        while (!try_pop(out)) {
+            const std::size_t t = tail_.load(std::memory_order_acquire);
+            if (head_.load(std::memory_order_relaxed) == t) {
+                tail_.wait(t, std::memory_order_acquire);
+            }
+        }
+        return out;
+    }
+
+   private:
+    // cada lado guarda uma cópia do índice do outro e só relê o índice
+    // compartilhado quando a cópia indica fila cheia (ou vazia).
+    alignas(detail::cache_line) std::atomic<std::size_t> head_ = 0;
+    std::size_t tail_cache_ = 0;
+    alignas(detail::cache_line) std::atomic<std::size_t> tail_ = 0;
+    std::size_t head_cache_ = 0;
+    alignas(detail::cache_line) const std::size_t mask_;
+    std::unique_ptr<T[]> slots_;
+};
+
+// fila limitada de vários produtores e consumidores (D. Vyukov): a posição
+// 'i' do anel está livre para a volta 'k' quando a sua sequência vale
+// 'i + k * capacidade', e ocupada quando vale um a mais.
+template <typename T>
+    requires std::default_initializable<T> && std::movable<T>
+class mpmc_queue {
+   public:
+    explicit mpmc_queue(std::size_t capacity)
+        : mask_(detail::ring_capacity(capacity) - 1),
+          cells_(std::make_unique<cell[]>(mask_ + 1)) {
+        for (std::size_t i = 0; i <= mask_; ++i) {
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    std::size_t capacity() const noexcept { return mask_ + 1; }
+
+    bool try_push(T&& x) {
+        std::size_t pos = enqueue_.load(std::memory_order_relaxed);
+        cell* c;
+        for (;;) {
+            c = &cells_[pos & mask_];
+            const std::size_t seq = c->seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) -
+                              static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_.compare_exchange_weak(pos, pos + 1,
+                                                   std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_.load(std::memory_order_relaxed);
+            }
+        }
+        c->value = std::move(x);
+        c->seq.store(pos + 1, std::memory_order_release);
+        c->seq.notify_all();
+        return true;
+    }
+    void push(T x) {
+        while (!try_push(std::move(x))) {
+            // espera a posição da frente ser liberada por um consumidor.
+            const std::size_t pos = enqueue_.load(std::memory_order_relaxed);
+            cell& c = cells_[pos & mask_];
+            const std::size_t seq = c.seq.load(std::memory_order_acquire);
+            if (static_cast<std::intptr_t>(seq - pos) < 0) {
+                c.seq.wait(seq, std::memory_order_acquire);
+            }
+        }
+    }
+
+    bool try_pop(T& out) {
+        std::size_t pos = dequeue_.load(std::memory_order_relaxed);
+        cell* c;
+        for (;;) {
+            c = &cells_[pos & mask_];
+            const std::size_t seq = c->seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) -
+                              static_cast<std::intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_.compare_exchange_weak(pos, pos + 1,
+                                                   std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeue_.load(std::memory_order_relaxed);
+            }
+        }
+        out = std::move(c->value);
+        c->seq.store(pos + mask_ + 1, std::memory_order_release);
+        c->seq.notify_all();
+        return true;
+    }
+    T pop() {
+        T out;
+        while (!try_pop(out)) {
+            // espera a posição da frente ser preenchida por um produtor.
+            const std::size_t pos = dequeue_.load(std::memory_order_relaxed);
+            cell& c = cells_[pos & mask_];
+            const std::size_t seq = c.seq.load(std::memory_order_acquire);
+            if (static_cast<std::intptr_t>(seq - (pos + 1)) < 0) {
+                c.seq.wait(seq, std::memory_order_acquire);
+            }
+        }
+        return out;
+    }
+
+   private:
+    struct cell {
+        std::atomic<std::size_t> seq;
+        T value;
+    };
+
+    alignas(detail::cache_line) std::atomic<std::size_t> enqueue_ = 0;
+    alignas(detail::cache_line) std::atomic<std::size_t> dequeue_ = 0;
+    alignas(detail::cache_line) const std::size_t mask_;
+    std::unique_ptr<cell[]> cells_;
+};
+
+struct options {
+    // elementos da origem por lote.
+    std::size_t batch = 1 << 10;
+    // lotes por fila entre dois estágios.
+    std::size_t capacity = 8;
+};
+
+// um estágio: o adaptador e quantas threads o executam.
+template <typename Pipe>
+struct stage {
+    Pipe pipe;
+    std::size_t workers = 1;
+};
+
+template <typename Pipe>
+stage(Pipe) -> stage<Pipe>;
+template <typename Pipe>
+stage(Pipe, std::size_t) -> stage<Pipe>;
+
+namespace detail {
+
+template <typename S>
+inline constexpr bool is_stage = false;
+template <typename Pipe>
+inline constexpr bool is_stage<stage<Pipe>> = true;
+
+// saída de 'pipe' aplicado a um lote de 'T'.
+template <typename Pipe, typename T>
+using stage_output = std::ranges::range_value_t<
+    std::invoke_result_t<const Pipe&, std::vector<T>&>>;
+
+template <typename T, typename... Stages>
+struct output;
+template <typename T>
+struct output<T> {
+    using type = T;
+};
+template <typename T, typename Pipe, typename... Stages>
+struct output<T, stage<Pipe>, Stages...>
+    : output<stage_output<Pipe, T>, Stages...> {};
+
+// lote numerado; o número 'end' marca o fim do fluxo.
+template <typename T>
+struct batch {
+    static constexpr std::size_t end = -1;
+    std::size_t seq = end;
+    std::vector<T> items;
+};
+
+// fila entre dois estágios: SPSC se houver um só produtor e um só
+// consumidor. O último produtor a terminar envia uma marca de fim para cada
+// consumidor.
+template <typename T>
+class channel {
+   public:
+    channel(std::size_t producers, std::size_t consumers,
+            std::size_t capacity)
+        : producers_(producers), consumers_(consumers) {
+        if (producers == 1 && consumers == 1) {
+            spsc_ = std::make_unique<spsc_queue<batch<T>>>(capacity);
+        } else {
+            mpmc_ = std::make_unique<mpmc_queue<batch<T>>>(capacity);
+        }
+    }
+
+    void push(batch<T> b) {
+        if (spsc_) {
+            spsc_->push(std::move(b));
+        } else {
+            mpmc_->push(std::move(b));
+        }
+    }
+    batch<T> pop() { return spsc_ ? spsc_->pop() : mpmc_->pop(); }
+
+    void done() {
+        if (producers_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            for (std::size_t i = 0; i < consumers_; ++i) push({});
+        }
+    }
+
+   private:
+    std::atomic<std::size_t> producers_;
+    const std::size_t consumers_;
+    std::unique_ptr<spsc_queue<batch<T>>> spsc_;
+    std::unique_ptr<mpmc_queue<batch<T>>> mpmc_;
+};
+
+// limite de lotes em trânsito (lidos e ainda não escritos): a leitura só
+// numera o lote 'seq' quando 'seq - written < size', e a escrita avança
+// 'written' a cada lote escrito. Com várias threads num estágio, os lotes
+// chegam fora de ordem à escrita, e só esse limite impede que os adiantados
+// se acumulem sem fim. 'open()' libera a leitura de vez.
+class window {
+   public:
+    explicit window(std::size_t size) : size_(size) {}
+
+    void acquire(std::size_t seq) {
+        for (std::size_t w = written_.load(std::memory_order_acquire);
+             w != opened && seq - w >= size_;
+             w = written_.load(std::memory_order_acquire)) {
+            written_.wait(w, std::memory_order_acquire);
+        }
+    }
+    void release(std::size_t written) {
+        written_.store(written, std::memory_order_release);
+        written_.notify_one();
+    }
+    void open() { release(opened); }
+
+   private:
+    static constexpr std::size_t opened = -1;
+    const std::size_t size_;
+    std::atomic<std::size_t> written_ = 0;
+};
+
+// primeira exceção de qualquer thread da pipeline. Uma falha abre a janela:
+// depois dela os lotes são descartados e não chegam à escrita.
+class failure {
+   public:
+    explicit failure(window& gate) : gate_(gate) {}
+
+    bool failed() const noexcept {
+        return failed_.load(std::memory_order_relaxed);
+    }
+    void fail(std::exception_ptr e) {
+        {
+            std::lock_guard lock(mutex_);
+            if (!error_) error_ = std::move(e);
+            failed_.store(true, std::memory_order_relaxed);
+        }
+        gate_.open();
+    }
+    void rethrow() {
+        if (error_) std::rethrow_exception(error_);
+    }
+
+   private:
+    window& gate_;
+    std::atomic<bool> failed_ = false;
+    std::mutex mutex_;
+    std::exception_ptr error_;
+};
+
+}  // namespace detail
+
+template <typename... Stages>
+    requires(detail::is_stage<Stages> && ...)
+class pipeline {
+   public:
+    explicit pipeline(Stages... stages) : stages_(std::move(stages)...) {}
+    pipeline(options opts, Stages... stages)
+        : options_(opts), stages_(std::move(stages)...) {}
+
+    // elementos que a pipeline produz a partir de elementos 'T'.
+    template <typename T>
+    using output_t = typename detail::output<T, Stages...>::type;
+
+    // lê 'source', passa os lotes pelos estágios e escreve os resultados em
+    // 'out', na ordem da origem; devolve o iterador depois do último.
+    template <std::ranges::input_range R, std::weakly_incrementable O>
+        requires std::indirectly_writable<
+            O, output_t<std::ranges::range_value_t<R>>&&>
+    O copy(R&& source, O out) const {
+        using T = std::ranges::range_value_t<R>;
+        detail::window gate(window_size());
+        detail::failure state(gate);
+        detail::channel<T> first(1, consumers<0>(), capacity());
+        std::jthread reader([&] { read(source, first, gate, state); });
+        run<0>(first, gate, state, out);
+        reader.join();
+        state.rethrow();
+        return out;
+    }
+
+    template <std::ranges::input_range R>
+    friend std::vector<output_t<std::ranges::range_value_t<R>>> operator|(
+        R&& source, const pipeline& self) {
+        std::vector<output_t<std::ranges::range_value_t<R>>> out;
+        self.copy(source, std::back_inserter(out));
+        return out;
+    }
+
+   private:
+    std::size_t capacity() const {
+        return std::max<std::size_t>(options_.capacity, 1);
+    }
+
+    // lotes em trânsito: as filas cheias e um lote em cada thread de estágio.
+    std::size_t window_size() const {
+        return [&]<std::size_t... I>(std::index_sequence<I...>) {
+            return capacity() * (sizeof...(Stages) + 1) +
+                   (consumers<I>() + ...);
+        }(std::index_sequence_for<Stages...>{});
+    }
+
+    // threads que consomem a saída do estágio 'I - 1' (a thread que chamou,
+    // depois do último).
+    template <std::size_t I>
+    std::size_t consumers() const {
+        if constexpr (I < sizeof...(Stages)) {
+            return std::max<std::size_t>(std::get<I>(stages_).workers, 1);
+        } else {
+            return 1;
+        }
+    }
+
+    template <typename R, typename T>
+    void read(R& source, detail::channel<T>& out, detail::window& gate,
+              detail::failure& state) const {
+        const std::size_t n = std::max<std::size_t>(options_.batch, 1);
+        try {
+            auto it = std::ranges::begin(source);
+            const auto last = std::ranges::end(source);
+            for (std::size_t seq = 0; it != last && !state.failed(); ++seq) {
+                gate.acquire(seq);
+                detail::batch<T> b{seq, {}};
+                b.items.reserve(n);
+                for (; it != last && b.items.size() < n; ++it) {
+                    b.items.emplace_back(*it);
+                }
+                out.push(std::move(b));
+            }
+        } catch (...) {
+            state.fail(std::current_exception());
+        }
+        out.done();
+    }
+
+    // inicia as threads do estágio 'I', que leem de 'in', e segue para os
+    // próximos; depois do último, escreve os resultados em 'out'. As threads
+    // de cada estágio terminam antes de a sua fila de saída ser destruída.
+    template <std::size_t I, typename T, typename O>
+    void run(detail::channel<T>& in, detail::window& gate,
+             detail::failure& state, O& out) const {
+        if constexpr (I == sizeof...(Stages)) {
+            write(in, gate, state, out);
+        } else {
+            const auto& s = std::get<I>(stages_);
+            using U = detail::stage_output<decltype(s.pipe), T>;
+            const std::size_t workers = consumers<I>();
+            detail::channel<U> next(workers, consumers<I + 1>(), capacity());
+            std::vector<std::jthread> threads;
+            threads.reserve(workers);
+            for (std::size_t i = 0; i < workers; ++i) {
+                threads.emplace_back([&] { work(s.pipe, in, next, state); });
+            }
+            run<I + 1>(next, gate, state, out);
+        }
+    }
+
+    template <typename Pipe, typename T, typename U>
+    static void work(const Pipe& pipe, detail::channel<T>& in,
+                     detail::channel<U>& out, detail::failure& state) {
+        for (;;) {
+            detail::batch<T> b = in.pop();
+            if (b.seq == b.end) break;
+            // depois de uma falha, só esvazia a fila.
+            if (state.failed()) continue;
+            try {
+                detail::batch<U> r{b.seq, {}};
+                auto&& view = std::invoke(pipe, b.items);
+                if constexpr (std::ranges::sized_range<decltype(view)>) {
+                    r.items.reserve(std::ranges::size(view));
+                }
+                for (auto&& x : view) {
+                    r.items.emplace_back(std::forward<decltype(x)>(x));
+                }
+                out.push(std::move(r));
+            } catch (...) {
+                state.fail(std::current_exception());
+            }
+        }
+        out.done();
+    }
+
+    // escreve os lotes na ordem de numeração; os que chegam adiantados
+    // esperam em 'pending', que a janela limita.
+    template <typename T, typename O>
+    static void write(detail::channel<T>& in, detail::window& gate,
+                      detail::failure& state, O& out) {
+        std::map<std::size_t, std::vector<T>> pending;
+        std::size_t next = 0;
+        for (;;) {
+            detail::batch<T> b = in.pop();
+            if (b.seq == b.end) break;
+            if (state.failed()) continue;
+            try {
+                pending.emplace(b.seq, std::move(b.items));
+                for (auto it = pending.begin();
+                     it != pending.end() && it->first == next;
+                     it = pending.erase(it), ++next) {
+                    for (T& x : it->second) {
+                        *out = std::move(x);
+                        ++out;
+                    }
+                    gate.release(next + 1);
+                }
+            } catch (...) {
+                state.fail(std::current_exception());
+            }
+        }
+    }
+
+    options options_;
+    std::tuple<Stages...> stages_;
+};
+
+template <typename... Stages>
+    requires(detail::is_stage<Stages> && ...)
+pipeline(Stages...) -> pipeline<Stages...>;
+template <typename... Stages>
+pipeline(options, Stages...) -> pipeline<Stages...>;
+
+}  // namespace staged
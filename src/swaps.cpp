@@ -4,8 +4,12 @@
 #include <print>
 #include <random>
 #include <ranges>
+#include <string>
 #include <vector>
 
+#include "permutation.hpp"
+#include "simd_swap.hpp"
+
 namespace swaps {
 using std::cout;
 using std::endl;
@@ -77,5 +81,40 @@ void main() {
         cout << e << " ";
     }
     cout << "}" << endl;
+
+    cout << endl;
+    // para elementos trivialmente copiáveis, 'simd::swap_ranges' troca os
+    // bytes das duas ranges em vetores; 'Library::Storage' tem um 'swap'
+    // próprio, encontrado por ADL, e por isso é trocado elemento a elemento.
+    vector<int> v4{1, 2, 3, 4, 5};
+    vector<int> v5{10, 20, 30};
+    simd::swap_ranges(v4, v5);
+    cout << "simd::swap_ranges(v4, v5):" << endl;
+    cout << "v4: { ";
+    for (auto& e : v4) {
+        cout << e << " ";
+    }
+    cout << "}" << endl;
+    vector<Library::Storage> s1{{1}, {2}};
+    vector<Library::Storage> s2{{3}, {4}};
+    simd::swap_ranges(std::execution::par, s1, s2);
+    cout << "simd::swap_ranges(std::execution::par, s1, s2):" << endl;
+    cout << "s1: { " << s1[0].value << " " << s1[1].value << " }" << endl;
+
+    cout << endl;
+    // a mesma permutação aplicada a colunas paralelas (struct-of-arrays):
+    // depois de 'apply', 'c[i]' é o antigo 'c[perm[i]]' em cada coluna.
+    vector<std::size_t> perm{2, 0, 3, 1};
+    vector<std::string> names{"ana", "bia", "caio", "davi"};
+    vector<int> ages{31, 25, 47, 19};
+    vector<Library::Storage> storage{{10}, {20}, {30}, {40}};
+    permutation::apply(perm, names, ages);
+    permutation::apply_in_place(perm, storage);
+    cout << "permutation::apply(perm, names, ages), "
+            "permutation::apply_in_place(perm, storage):"
+         << endl;
+    for (std::size_t i = 0; i < perm.size(); ++i) {
+        cout << names[i] << " " << ages[i] << " " << storage[i].value << endl;
+    }
 };
 }  // namespace swaps
@@ -1,8 +1,11 @@
 #include <algorithm>
 #include <boost/type_index.hpp>
+#include <cmath>
 #include <concepts>
+#include <cstdint>
 #include <execution>
 #include <iostream>
+#include <limits>
 #include <list>
 #include <print>
 #include <random>
@@ -10,6 +13,13 @@
 #include <typeinfo>
 #include <vector>
 
+#include "hash_algorithms.hpp"
+#include "prng.hpp"
+#include "simd_compact.hpp"
+#include "simd_elementwise.hpp"
+#include "simd_replace.hpp"
+#include "simd_rotate.hpp"
+
 namespace transformation {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -62,6 +72,36 @@ void main() {
                   [](int i) { return i * 3; });  // transform inplace
     cout << "transformed 'v': " << stringify(v1) << endl;
 
+    cout << endl;
+    cout << "simd::mul_sat(v, 3), simd::clamp(v, 0, 50) e "
+            "simd::narrow_copy(w, std::back_inserter(o)):"
+         << endl;
+    auto v1b = vw::iota(1, 9) | rg::to<vector<int>>();
+    v1b.push_back(1 << 30);
+    cout << "original 'v': " << stringify(v1b) << endl;
+    simd::mul_sat(std::execution::par, v1b, 3);
+    cout << "'v' * 3 (saturado): " << stringify(v1b) << endl;
+    simd::clamp(v1b, 0, 50);
+    cout << "'v' limitado a [0, 50]: " << stringify(v1b) << endl;
+    vector<float> w1{-1.5f, 0.25f, 2.5f, 3.7f, 300.f};
+    vector<std::uint8_t> o1;
+    simd::affine(w1, 2.f, 1.f);
+    simd::narrow_copy(w1, std::back_inserter(o1));
+    cout << "'w' * 2 + 1, convertido para uint8: "
+         << stringify(o1 | vw::transform([](auto b) { return int(b); }))
+         << endl;
+    // os limites de int32 e uint32 não são representáveis em float: valores
+    // acima deles saturam no máximo do inteiro.
+    const float inf = std::numeric_limits<float>::infinity();
+    vector<float> w1b{-inf, -2147483648.f, 2147483520.f, 2147483648.f,
+                      4294967040.f, 4294967296.f, inf, std::nanf("")};
+    vector<std::int32_t> o1b(w1b.size());
+    vector<std::uint32_t> o1c(w1b.size());
+    simd::narrow_copy(w1b, o1b.begin());
+    simd::narrow_copy(w1b, o1c.begin());
+    cout << "limites convertidos para int32: " << stringify(o1b) << endl;
+    cout << "limites convertidos para uint32: " << stringify(o1c) << endl;
+
     cout << endl;
     cout << "std::ranges::transform(v, w, v.begin(), [](int i, int j) { return "
             "i * j; }):"
@@ -96,6 +136,19 @@ void main() {
     v4.resize(std::distance(v4.begin(), f4));
     cout << "removed values 'v': " << stringify(v4) << endl;
 
+    cout << endl;
+    cout << "simd::erase_if(std::execution::par, v, [](int i){return i % 2 == "
+            "0;}):"
+         << endl;
+    // 'remove_if' + 'erase' numa só chamada; a compactação é vetorizada
+    // (AVX-512 'vpcompressd' ou emulação com 'vpermd' em AVX2).
+    auto v4b = vw::iota(1, 9) | rg::to<vector<int>>();
+    cout << "original 'v': " << stringify(v4b) << endl;
+    auto n4b = simd::erase_if(std::execution::par, v4b,
+                              [](int i) { return i % 2 == 0; });
+    cout << "removed values 'v': " << stringify(v4b) << " (" << n4b
+         << " removed)" << endl;
+
     cout << endl;
     cout << "std::ranges::replace(v, 2, 42):" << endl;
     auto v5 = vw::iota(1, 5) | rg::to<vector<int>>();
@@ -111,6 +164,17 @@ void main() {
     rg::replace_if(v6, [](int i) { return i % 4 == 0; }, 24);
     cout << "replaced values 'v': " << stringify(v6) << endl;
 
+    cout << endl;
+    cout << "simd::replace_if(std::execution::par, v, [](double d){return d != "
+            "d;}, 0.0):"
+         << endl;
+    // limpeza de NaN: o predicado sem desvios é vetorizado pelo compilador.
+    vector<double> v6b{1.5, std::nan(""), 2.5, std::nan(""), 4.0};
+    cout << "original 'v': " << stringify(v6b) << endl;
+    simd::replace_if(
+        std::execution::par, v6b, [](double d) { return d != d; }, 0.0);
+    cout << "replaced values 'v': " << stringify(v6b) << endl;
+
     cout << endl;
     cout << "std::ranges::reverse(v):" << endl;
     auto v7 = vw::iota(1, 9) | rg::to<vector<int>>();
@@ -139,6 +203,17 @@ void main() {
     rg::rotate(v9, v9.begin() + 3);
     cout << "rotated 'v': " << stringify(v9) << endl;
 
+    cout << endl;
+    cout << "simd::rotate(std::execution::par, v, v.begin() + 3):" << endl;
+    // a parte menor vai para um buffer e a maior é deslocada com 'memmove'; se
+    // nenhuma couber no buffer, a rotação vira três inversões vetorizadas.
+    auto v9b = vw::iota(1, 9) | rg::to<vector<int>>();
+    cout << "original 'v': " << stringify(v9b) << endl;
+    simd::rotate(std::execution::par, v9b, v9b.begin() + 3);
+    cout << "rotated 'v': " << stringify(v9b) << endl;
+    simd::reverse(std::execution::par, v9b);
+    cout << "reversed 'v': " << stringify(v9b) << endl;
+
     cout << endl;
     cout << "std::ranges::shift_right(v.begin(), v.end(), 3):" << endl;
     auto v10 = vw::iota(1, 9) | rg::to<vector<int>>();
@@ -153,6 +228,13 @@ void main() {
     std::shift_left(v11.begin(), v11.end(), 3);
     cout << "shifted left 'v': " << stringify(v11) << endl;
 
+    cout << endl;
+    cout << "simd::shift_left(std::execution::par, v, 3):" << endl;
+    auto v11b = vw::iota(1, 9) | rg::to<vector<int>>();
+    cout << "original 'v': " << stringify(v11b) << endl;
+    auto shifted = simd::shift_left(std::execution::par, v11b, 3);
+    cout << "shifted left 'v': " << stringify(shifted) << endl;
+
     cout << endl;
     cout << "std::ranges::shift_right(v.begin(), v.end(), 3):" << endl;
     vector<EmptyOnMove> v12 = {
@@ -175,6 +257,13 @@ void main() {
     rg::shuffle(v13, rng);
     cout << "shuffled 'v': " << stringify(v13) << endl;
 
+    cout << endl;
+    cout << "prng::shuffle(std::execution::par, v, 42):" << endl;
+    // MergeShuffle com um fluxo Philox por bloco: o resultado depende apenas
+    // da semente, e não do número de threads.
+    prng::shuffle(std::execution::par, v13, 42);
+    cout << "shuffled 'v': " << stringify(v13) << endl;
+
     cout << endl;
     cout << "do{cout << v << endl;} "
             "while(std::ranges::next_permutation(v).found):"
@@ -199,5 +288,24 @@ void main() {
     cout << "'u': " << stringify(u15) << endl;
     cout << "is 'u' a permutation of 'v'? " << std::boolalpha
          << rg::is_permutation(u15, v15) << endl;
+
+    cout << endl;
+    // 'std::ranges::is_permutation' é O(n²) no pior caso. A versão de
+    // 'hash_algorithms' conta as ocorrências (histograma, tabela hash ou
+    // ordenação, a depender do tipo) e aceita projeções e políticas de
+    // execução.
+    cout << "hash_algorithms::is_permutation(std::execution::par, w, v, {}, "
+            "&Foo::x, &Foo::x):"
+         << endl;
+    auto v16 = vw::iota(1, 9) | vw::transform([](int i) { return Foo{i}; }) |
+               rg::to<vector<Foo>>();
+    auto w16 = v16;
+    rg::shuffle(w16, std::random_device{});
+    cout << "'v': " << stringify(v16) << endl;
+    cout << "'w': " << stringify(w16) << endl;
+    cout << "is 'w' a permutation of 'v'? " << std::boolalpha
+         << hash_algorithms::is_permutation(std::execution::par, w16, v16, {},
+                                            &Foo::x, &Foo::x)
+         << endl;
 };
 }  // namespace transformation